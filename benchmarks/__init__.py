@@ -0,0 +1,7 @@
+"""
+Benchmarks Module
+Offline performance measurements for the simulator, search and reading pipeline
+
+Run individual benchmarks as modules from the repository root, e.g.:
+    python -m benchmarks.simulator
+"""
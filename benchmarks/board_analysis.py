@@ -0,0 +1,109 @@
+"""
+Board Analysis Benchmark
+Decision latency with one BoardAnalysis shared per state against analyses computed per use
+
+Usage:
+    python -m benchmarks.board_analysis [--repeats N]
+
+A decision is ActionOptimizer.get_best_action() (StrategyPlanner and the
+optimizer's evaluations), StateEncoder.encode() (a new encoder, so no line
+is reused) and EmergencyHandler.check() on a fresh copy of a state. The
+states are the decision states of benchmarks.scenarios and the
+early-wave, melee and late-wave boards read from a process image.
+
+    uncached      BoardAnalysis.of() analyzes the state on every call
+    per-consumer  the state's analysis is dropped between the optimizer and
+                  the encoder, so each analyzes the state once
+    shared        one analysis per state, as the consumers run it
+
+"analyses" is the number of board analyses computed per decision. The
+decisions and encoded texts of all three must be the same.
+"""
+
+import argparse
+import time
+from contextlib import contextmanager
+
+from engine.analyzer import BoardAnalysis
+from engine.optimizer import ActionOptimizer
+from game.state import GameState
+from llm.emergency import EmergencyHandler
+from llm.encoder import StateEncoder
+from benchmarks.scenarios import (
+    build_decision_states, build_early_wave_board, build_late_wave_board, build_melee_board,
+)
+from benchmarks.state_index import copy_state, read_board
+
+
+_analyze = BoardAnalysis.__dict__['_analyze']
+_of = BoardAnalysis.__dict__['of']
+_computed = [0]
+
+
+def _counted(cls, state):
+    _computed[0] += 1
+    return _analyze.__func__(cls, state)
+
+
+@contextmanager
+def analysis_mode(mode: str):
+    """Count computed analyses and, for 'uncached', bypass the per-state memo"""
+    BoardAnalysis._analyze = classmethod(_counted)
+    if mode == 'uncached':
+        BoardAnalysis.of = classmethod(lambda cls, state: cls._analyze(state))
+    try:
+        yield
+    finally:
+        BoardAnalysis._analyze = _analyze
+        BoardAnalysis.of = _of
+
+
+def decide(state: GameState, mode: str) -> tuple:
+    """One decision on a state; the action, encoded text and emergency"""
+    action = ActionOptimizer().get_best_action(state)
+    if mode == 'per-consumer':
+        state._analysis = None
+    text = StateEncoder().encode(state)
+    emergency = EmergencyHandler().check(state)
+    return ((action.action_type, action.plant_type, action.row, action.col), text,
+            emergency and (emergency.reason, emergency.urgency))
+
+
+def time_states(states: list, mode: str, repeats: int) -> tuple:
+    """(best microseconds per decision, analyses per decision, decisions)"""
+    best = float('inf')
+    decisions = None
+    with analysis_mode(mode):
+        for _ in range(repeats):
+            copies = [copy_state(state, GameState) for state in states]
+            _computed[0] = 0
+            start = time.perf_counter()
+            decisions = [decide(state, mode) for state in copies]
+            best = min(best, (time.perf_counter() - start) / len(states) * 1e6)
+    return best, _computed[0] / len(states), decisions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Shared board analysis benchmark')
+    parser.add_argument('--repeats', type=int, default=20, help='Timed runs per state set')
+    args = parser.parse_args()
+
+    state_sets = [('decision', [state for _, state in build_decision_states()]),
+                  ('early-wave', [read_board(build_early_wave_board)]),
+                  ('melee', [read_board(build_melee_board)]),
+                  ('late-wave', [read_board(build_late_wave_board)])]
+    modes = ['uncached', 'per-consumer', 'shared']
+    print(f"{'states':>10s} {'mode':>12s} {'analyses':>8s} {'us':>8s} {'speedup':>7s} "
+          f"{'decisions':>9s}")
+    for name, states in state_sets:
+        results = {mode: time_states(states, mode, args.repeats) for mode in modes}
+        uncached_us = results['uncached'][0]
+        for mode in modes:
+            us, analyses, decisions = results[mode]
+            check = 'identical' if decisions == results['shared'][2] else 'DIFFERENT'
+            print(f"{name:>10s} {mode:>12s} {analyses:8.1f} {us:8.1f} "
+                  f"{uncached_us / us:6.2f}x {check:>9s}")
+
+
+if __name__ == '__main__':
+    main()
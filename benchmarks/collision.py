@@ -0,0 +1,125 @@
+"""
+Collision Benchmark
+Measures how GameSimulator's hit tests and volley checks scale with the
+zombie and projectile populations
+
+Usage:
+    python -m benchmarks.collision [--frames N] [--repeats N]
+
+The per-row zombie index (ZombieRowIndex) is compared against the linear
+scans it replaced, kept here as ScanSimulator. Zombie and projectile counts
+are scaled independently; with the index, frame time grows with P + Z
+instead of P x Z.
+"""
+
+import argparse
+import time
+
+from engine.simulator import GameSimulator, Plant, Projectile, is_splash_projectile
+from data.plants import PlantType
+from data.projectiles import PROJECTILE_SPLASH_RADIUS
+from benchmarks.scenarios import build_collision_board
+from benchmarks.simulator import board_signature
+
+
+class ScanSimulator(GameSimulator):
+    """GameSimulator with the original every-zombie scans (reference)"""
+
+    def _check_projectile_collision(self, proj: Projectile) -> None:
+        if not proj.is_alive:
+            return
+
+        if is_splash_projectile(proj.type):
+            target_rows = [proj.row - 1, proj.row, proj.row + 1]
+        else:
+            target_rows = [proj.row]
+
+        hit_any = False
+        for zombie in self.zombies:
+            if not zombie.is_alive:
+                continue
+            if zombie.row not in target_rows:
+                continue
+
+            if is_splash_projectile(proj.type):
+                splash_radius = PROJECTILE_SPLASH_RADIUS.get(proj.type, 80)
+                if abs(proj.x - zombie.x) <= splash_radius:
+                    self._apply_projectile_damage(proj, zombie)
+                    hit_any = True
+            else:
+                if zombie.x - 20 <= proj.x <= zombie.x + 20:
+                    self._apply_projectile_damage(proj, zombie)
+                    proj.is_alive = False
+                    return
+
+        if is_splash_projectile(proj.type) and hit_any:
+            proj.is_alive = False
+
+    def _should_plant_fire(self, plant: Plant) -> bool:
+        if plant.type == PlantType.THREEPEATER:
+            target_rows = [plant.row - 1, plant.row, plant.row + 1]
+        else:
+            target_rows = [plant.row]
+
+        for zombie in self.zombies:
+            if not zombie.is_alive:
+                continue
+            if zombie.row not in target_rows:
+                continue
+            if zombie.x > plant.x:
+                return True
+        return False
+
+
+def as_scan(board: GameSimulator) -> ScanSimulator:
+    """Copy a board into a ScanSimulator"""
+    sim = ScanSimulator(sun=board.sun, scene=board.scene)
+    sim.restore(board.snapshot())
+    sim._row_count = board._row_count
+    sim._next_plant_id = board._next_plant_id
+    sim._next_zombie_id = board._next_zombie_id
+    sim._next_projectile_id = board._next_projectile_id
+    return sim
+
+
+def time_frames(board: GameSimulator, build, frames: int, repeats: int) -> float:
+    """Best time per frame in microseconds"""
+    best = float('inf')
+    for _ in range(repeats):
+        sim = build(board)
+        start = time.perf_counter()
+        sim.tick_n(frames)
+        best = min(best, time.perf_counter() - start)
+    return best / frames * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Zombie row index vs linear scan benchmark')
+    parser.add_argument('--frames', type=int, default=20, help='Frames per timed run')
+    parser.add_argument('--repeats', type=int, default=5, help='Timed runs per size')
+    args = parser.parse_args()
+
+    board = build_collision_board(60, 240)
+    reference, indexed = as_scan(board), board.clone()
+    same = True
+    for _ in range(300):
+        reference.tick()
+        indexed.tick()
+        same = same and board_signature(reference) == board_signature(indexed)
+    print(f"equivalence [60 zombies, 240 projectiles, 300 frames]: "
+          f"{'identical' if same else 'DIVERGED'}")
+
+    sizes = ([(z, 200) for z in (15, 30, 60, 120, 240)] +
+             [(60, p) for p in (50, 100, 200, 400, 800)])
+    print(f"{'zombies':>8s} {'projectiles':>12s} {'scan us/frame':>14s} "
+          f"{'index us/frame':>15s} {'speedup':>8s}")
+    for zombie_count, projectile_count in sizes:
+        board = build_collision_board(zombie_count, projectile_count)
+        scan = time_frames(board, as_scan, args.frames, args.repeats)
+        index = time_frames(board, GameSimulator.clone, args.frames, args.repeats)
+        print(f"{zombie_count:8d} {projectile_count:12d} {scan:14.0f} {index:15.0f} "
+              f"{scan / index:7.1f}x")
+
+
+if __name__ == '__main__':
+    main()
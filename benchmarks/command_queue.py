@@ -0,0 +1,427 @@
+"""
+Command Queue Benchmark
+Memory operations per action with one remote thread per action, batches and the command loop
+
+Usage:
+    python -m benchmarks.command_queue [--actions N] [--capacity 16] [--batch 3]
+
+The early-wave board is laid out as a process image (benchmarks.state_read)
+with a minimal executable header at 0x400000 whose import table has
+kernel32 Sleep. An injecting backend gives the image what Kernel32Backend
+has: alloc maps fresh memory, and run_thread runs the code it is given in
+a small x86 interpreter, on a Python thread when it is not waited for.
+The interpreter knows the instructions the injector generates; calls to
+the game's functions and to Sleep are logged (Sleep waits) instead of run.
+
+The same mix of plants, shovels and cob fires goes through AsmInjector
+per action (execute_shellcode), in batches of --batch (one thread running
+batch_code(), which writes back a result per call), and through its
+CommandQueue one at a time and in batches. Every mode must make the same
+game calls with the same arguments and return the same results, the ring
+must hold the encoded commands, and the loop must return with a balanced
+stack when stopped. The table counts the backend operations per action; against
+the game each is a syscall, and a thread is a CreateRemoteThread.
+"""
+
+import argparse
+import random
+import struct
+import threading
+import time
+
+from data.offsets import Offset
+from data.plants import PlantType
+from memory.backend import MemoryBackend, ImageBackend
+from memory.command_queue import (
+    COMMAND, GAME_MODULE_BASE, QUEUE_HEADER, encode_command, find_import_slot,
+    OP_FIRE_COB, OP_PLANT, OP_SHOVEL,
+)
+from memory.injector import AsmInjector
+from memory.reader import MemoryReader
+from benchmarks.scenarios import build_early_wave_board
+from benchmarks.state_read import build_image
+
+
+# Where the fake kernel32 functions are, and where alloc() and thread stacks go
+SLEEP = 0x7C802446
+GET_TICK_COUNT = 0x7C80934A
+ALLOC_START = 0x10000000
+STACK_START = 0x20000000
+STACK_SIZE = 0x1000
+RETURN_SENTINEL = 0xFFFFFFF0
+
+# Game functions: name, stack arguments the callee pops
+GAME_FUNCTIONS = {
+    Offset.FUNC_PLANT: ('plant', 4),
+    Offset.FUNC_REMOVE_PLANT: ('remove_plant', 1),
+    Offset.FUNC_COB_FIRE: ('fire_cob', 2),
+    Offset.FUNC_REFRESH_SEEDS: ('refresh_seeds', 1),
+}
+
+
+def build_module(image: ImageBackend) -> None:
+    """Map an executable header importing USER32 and KERNEL32 functions"""
+    module = bytearray(0x4000)
+    struct.pack_into('<2s', module, 0, b'MZ')
+    struct.pack_into('<I', module, 0x3C, 0x80)
+    struct.pack_into('<4s', module, 0x80, b'PE\0\0')
+    struct.pack_into('<II', module, 0x80 + 0x80, 0x2000, 40 * 3)  # Import directory
+
+    def names(rva: int, functions: list) -> list:
+        rvas = []
+        for function in functions:
+            struct.pack_into(f'<H{len(function) + 1}s', module, rva, 0, function.encode())
+            rvas.append(rva)
+            rva += 2 + len(function) + 2
+        return rvas
+
+    imports = [('USER32.dll', [('GetCursorPos', 0x77D4D5A0)]),
+               ('KERNEL32.dll', [('GetTickCount', GET_TICK_COUNT), ('Sleep', SLEEP)])]
+    for n, (dll, functions) in enumerate(imports):
+        lookup, slots, name = 0x2400 + n * 0x40, 0x2800 + n * 0x40, 0x2C00 + n * 0x20
+        struct.pack_into(f'<{len(dll) + 1}s', module, name, dll.encode())
+        for i, rva in enumerate(names(0x3000 + n * 0x100, [f for f, _ in functions])):
+            struct.pack_into('<I', module, lookup + i * 4, rva)
+            struct.pack_into('<I', module, slots + i * 4, functions[i][1])
+        struct.pack_into('<5I', module, 0x2000 + n * 20, lookup, 0, 0, name, slots)
+    image.map(GAME_MODULE_BASE, module)
+
+
+# ============================================================================
+# x86 Interpreter
+# ============================================================================
+
+class X86Thread:
+    """Runs injected code: the instructions the injector generates, nothing more"""
+
+    def __init__(self, memory: MemoryBackend, stack: int, calls: list):
+        self.memory = memory
+        self.calls = calls
+        self.regs = [0] * 8  # eax ecx edx ebx esp ebp esi edi
+        self.regs[4] = stack + STACK_SIZE
+        self.stack_top = stack + STACK_SIZE
+        self.zf = False
+        self.eip = 0
+        self.steps = 0
+
+    def u32(self, address: int) -> int:
+        return struct.unpack('<I', self.memory.read(address, 4))[0]
+
+    def put32(self, address: int, value: int) -> None:
+        self.memory.write(address, struct.pack('<I', value & 0xFFFFFFFF))
+
+    def push(self, value: int) -> None:
+        self.regs[4] -= 4
+        self.put32(self.regs[4], value)
+
+    def pop(self) -> int:
+        value = self.u32(self.regs[4])
+        self.regs[4] += 4
+        return value
+
+    def fetch(self, size: int) -> bytes:
+        data = self.memory.read(self.eip, size)
+        self.eip += size
+        return data
+
+    def imm32(self) -> int:
+        return struct.unpack('<I', self.fetch(4))[0]
+
+    def modrm(self):
+        """(reg field, register index or None, memory address or None)"""
+        byte = self.fetch(1)[0]
+        mod, reg, rm = byte >> 6, (byte >> 3) & 7, byte & 7
+        if mod == 3:
+            return reg, rm, None
+        if rm == 4:
+            sib = self.fetch(1)[0]
+            scale, index, base = sib >> 6, (sib >> 3) & 7, sib & 7
+            address = self.regs[base] + (0 if index == 4 else self.regs[index] << scale)
+        elif rm == 5 and mod == 0:
+            return reg, None, self.imm32()
+        else:
+            address = self.regs[rm]
+        if mod == 1:
+            address += struct.unpack('<b', self.fetch(1))[0]
+        elif mod == 2:
+            address += struct.unpack('<i', self.fetch(4))[0]
+        return reg, None, address & 0xFFFFFFFF
+
+    def get(self, register, address) -> int:
+        return self.regs[register] if address is None else self.u32(address)
+
+    def set(self, register, address, value: int) -> None:
+        if address is None:
+            self.regs[register] = value & 0xFFFFFFFF
+        else:
+            self.put32(address, value)
+
+    def call(self, target: int) -> None:
+        """Log a call to the game or kernel32; jump to anything else"""
+        args = lambda n: [struct.unpack('<i', self.memory.read(self.regs[4] + 4 * i, 4))[0]
+                          for i in range(n)]
+        if target in GAME_FUNCTIONS:
+            name, count = GAME_FUNCTIONS[target]
+            values = args(count)
+            if name == 'plant':  # Row in eax
+                values.insert(1, self.regs[0])
+            elif name == 'fire_cob':  # Cannon in eax
+                values.insert(0, self.regs[0])
+            self.calls.append((name, *values))
+            self.regs[4] += 4 * count
+        elif target == SLEEP:
+            time.sleep(args(1)[0] / 1000.0)
+            self.regs[4] += 4
+        else:
+            self.push(self.eip)
+            self.eip = target
+            return
+        self.regs[0] = self.regs[1] = self.regs[2] = 0  # Clobbered by the callee
+
+    def run(self, address: int, parameter: int = 0) -> None:
+        """Run a thread procedure to its return (by ret or ret 4)"""
+        self.push(parameter)
+        self.push(RETURN_SENTINEL)
+        self.eip = address
+        while self.eip != RETURN_SENTINEL:
+            self.step()
+        if self.regs[4] not in (self.stack_top - 4, self.stack_top):
+            raise RuntimeError(f"Thread returned with esp off by {self.stack_top - self.regs[4]}")
+
+    def step(self) -> None:
+        self.steps += 1
+        op = self.fetch(1)[0]
+        regs = self.regs
+        if 0x50 <= op <= 0x57:
+            self.push(regs[op - 0x50])
+        elif 0x58 <= op <= 0x5F:
+            regs[op - 0x58] = self.pop()
+        elif 0x48 <= op <= 0x4F:
+            regs[op - 0x48] = (regs[op - 0x48] - 1) & 0xFFFFFFFF
+            self.zf = regs[op - 0x48] == 0
+        elif op == 0x68:
+            self.push(self.imm32())
+        elif op == 0x6A:
+            self.push(struct.unpack('<b', self.fetch(1))[0] & 0xFFFFFFFF)
+        elif 0xB8 <= op <= 0xBF:
+            regs[op - 0xB8] = self.imm32()
+        elif op == 0x25:
+            regs[0] &= self.imm32()
+            self.zf = regs[0] == 0
+        elif op == 0x31:
+            reg, register, address = self.modrm()
+            value = self.get(register, address) ^ regs[reg]
+            self.set(register, address, value)
+            self.zf = value == 0
+        elif op == 0x3B:
+            reg, register, address = self.modrm()
+            self.zf = regs[reg] == self.get(register, address)
+        elif op == 0x83:
+            reg, register, address = self.modrm()
+            imm = struct.unpack('<b', self.fetch(1))[0] & 0xFFFFFFFF
+            if reg != 7:
+                raise NotImplementedError(f"83 /{reg} at 0x{self.eip:X}")
+            self.zf = self.get(register, address) == imm
+        elif op == 0x89:
+            reg, register, address = self.modrm()
+            self.set(register, address, regs[reg])
+        elif op == 0x8B:
+            reg, register, address = self.modrm()
+            regs[reg] = self.get(register, address)
+        elif op == 0x8D:
+            reg, _, address = self.modrm()
+            regs[reg] = address
+        elif op == 0xC1:
+            reg, register, address = self.modrm()
+            count = self.fetch(1)[0]
+            if reg != 4:
+                raise NotImplementedError(f"C1 /{reg} at 0x{self.eip:X}")
+            self.set(register, address, self.get(register, address) << count)
+        elif op in (0xC2, 0xC3):
+            pop = struct.unpack('<H', self.fetch(2))[0] if op == 0xC2 else 0
+            self.eip = self.pop()
+            regs[4] += pop
+        elif op == 0xC6:
+            _, register, address = self.modrm()
+            self.memory.write(address, self.fetch(1))
+        elif op == 0xC7:
+            _, register, address = self.modrm()
+            self.set(register, address, self.imm32())
+        elif op == 0xE9:
+            rel = struct.unpack('<i', self.fetch(4))[0]
+            self.eip += rel
+        elif op == 0x0F:
+            cc = self.fetch(1)[0]
+            rel = struct.unpack('<i', self.fetch(4))[0]
+            if (cc == 0x84 and self.zf) or (cc == 0x85 and not self.zf):
+                self.eip += rel
+        elif op == 0xF3 and self.fetch(1) == b'\x90':
+            pass  # pause
+        elif op == 0xFF:
+            reg, register, address = self.modrm()
+            if reg == 0:
+                value = self.get(register, address) + 1
+                self.set(register, address, value)
+                self.zf = value & 0xFFFFFFFF == 0
+            elif reg == 2:
+                self.call(self.get(register, address))
+            elif reg == 6:
+                self.push(self.get(register, address))
+            else:
+                raise NotImplementedError(f"FF /{reg} at 0x{self.eip:X}")
+        else:
+            raise NotImplementedError(f"Opcode {op:02X} at 0x{self.eip - 1:X}")
+
+
+# ============================================================================
+# Injecting Backend
+# ============================================================================
+
+class InjectingBackend(MemoryBackend):
+    """An image that can allocate memory and run code, counting operations"""
+
+    def __init__(self, image: ImageBackend):
+        self.image = image
+        self.calls = []  # Game functions called by injected code
+        self.counts = dict.fromkeys(('read', 'write', 'alloc', 'free', 'thread'), 0)
+        self.written = 0
+        self.live = set()  # Allocations not yet freed
+        self.threads = []  # (X86Thread, threading.Thread) of threads not waited for
+        self._next_alloc = ALLOC_START
+        self._next_stack = STACK_START
+
+    def read(self, address: int, size: int) -> bytes:
+        self.counts['read'] += 1
+        return self.image.read(address, size)
+
+    def write(self, address: int, data: bytes) -> bool:
+        self.counts['write'] += 1
+        self.written += len(data)
+        return self.image.write(address, data)
+
+    def alloc(self, size: int) -> int:
+        self.counts['alloc'] += 1
+        address = self._next_alloc
+        self._next_alloc += (size + 0xFFFF) & ~0xFFFF
+        self.image.map(address, bytes(size))
+        self.live.add(address)
+        return address
+
+    def free(self, address: int) -> None:
+        self.counts['free'] += 1
+        self.live.discard(address)
+
+    def run_thread(self, address: int, timeout: int = 1000) -> bool:
+        self.counts['thread'] += 1
+        self.image.map(self._next_stack, bytes(STACK_SIZE))
+        thread = X86Thread(self.image, self._next_stack, self.calls)
+        self._next_stack += STACK_SIZE
+        if timeout:
+            thread.run(address)
+        else:
+            runner = threading.Thread(target=thread.run, args=(address,), daemon=True)
+            runner.start()
+            self.threads.append((thread, runner))
+        return True
+
+
+# ============================================================================
+# Benchmark
+# ============================================================================
+
+def make_actions(count: int, seed: int = 0) -> list:
+    """A mix of plants, shovels and cob fires: (method, arguments)"""
+    rng = random.Random(seed)
+    kinds = [('plant', lambda: (rng.randrange(5), rng.randrange(9), int(PlantType.PEASHOOTER))),
+             ('shovel', lambda: (rng.randrange(5), rng.randrange(9))),
+             ('fire_cob', lambda: (rng.randrange(8), rng.uniform(0, 800), rng.uniform(80, 580)))]
+    return [(name, args()) for name, args in (rng.choice(kinds) for _ in range(count))]
+
+
+def run(actions: list, queue: bool, capacity: int, batch: int) -> tuple:
+    """(backend, injector, per-action results, operation counts) of one mode"""
+    image = build_image(build_early_wave_board(), 0.25)
+    build_module(image)
+    backend = InjectingBackend(image)
+    injector = AsmInjector(reader=MemoryReader(backend=backend), backend=backend)
+    if queue and not injector.start_command_loop(capacity):
+        raise RuntimeError("The command loop did not start")
+
+    # Count the actions alone, not the board lookups or installing the loop
+    injector.reader.get_board()
+    start_counts, start_written = dict(backend.counts), backend.written
+    results = []
+    if batch > 1:
+        for start in range(0, len(actions), batch):
+            commands = [getattr(injector, f'{name}_command')(*args)
+                        for name, args in actions[start:start + batch]]
+            results += injector.execute_batch(commands)
+    else:
+        for name, args in actions:
+            results.append(getattr(injector, name)(*args))
+    counts = {key: value - start_counts[key] for key, value in backend.counts.items()}
+    counts['bytes'] = backend.written - start_written
+    return backend, injector, results, counts
+
+
+def check_ring(backend: InjectingBackend, injector: AsmInjector) -> bool:
+    """Whether the ring holds the last commands, each done, head and tail equal"""
+    queue = injector.queue
+    header = lambda: QUEUE_HEADER.unpack(backend.image.read(queue.address, QUEUE_HEADER.size))
+    queue._wait(lambda: header()[1] == queue.head, 1000)  # tail follows the last done
+    head, tail, _, _ = header()
+    ok = head == tail == queue.head
+    for seq in range(max(1, head - queue.capacity + 1), head + 1):
+        entry = backend.image.read(queue._entry(seq), COMMAND.size)
+        op, done, entry_seq = struct.unpack_from('<III', entry)
+        expected = bytearray(encode_command(op, seq, struct.unpack_from('<5i', entry, 12)))
+        struct.pack_into('<I', expected, 4, seq)
+        ok &= entry == bytes(expected) and done == entry_seq == seq
+        ok &= op in (OP_PLANT, OP_SHOVEL, OP_FIRE_COB)
+    return ok
+
+
+def stop_loop(backend: InjectingBackend, injector: AsmInjector) -> tuple:
+    """Stop the command loop: (stopped with its memory freed, instructions it ran)"""
+    thread, runner = backend.threads[0]
+    injector.stop_command_loop()
+    runner.join(timeout=5)
+    return not runner.is_alive() and not backend.live, thread.steps
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Command queue benchmark')
+    parser.add_argument('--actions', type=int, default=300, help='Actions per mode')
+    parser.add_argument('--capacity', type=int, default=16, help='Commands in the ring')
+    parser.add_argument('--batch', type=int, default=3,
+                        help='Actions per execute_batch() in the batched modes')
+    args = parser.parse_args()
+
+    actions = make_actions(args.actions)
+    modes = [('per-action', False, 1), ('batch', False, args.batch),
+             ('queue', True, 1), ('queue batch', True, args.batch)]
+    runs = {name: run(actions, queue, args.capacity, batch) for name, queue, batch in modes}
+    reference_calls, reference_results = runs['per-action'][0].calls, runs['per-action'][2]
+
+    slot = find_import_slot(runs['queue'][0], 'KERNEL32.dll', 'Sleep')
+    print(f"{args.actions} actions ({sum(reference_results)} made a game call), "
+          f"batches of {args.batch}, Sleep import slot 0x{slot:X}")
+    columns = list(runs['per-action'][3])
+    print(f"{'mode':>11s} " + ' '.join(f"{key:>7s}" for key in columns)
+          + f" {'calls':>9s} {'results':>9s} {'ring':>5s} {'loop':>5s}")
+    for name, queue, _ in modes:
+        backend, injector, results, counts = runs[name]
+        ring = loop = '-'
+        if queue:
+            ring = 'ok' if check_ring(backend, injector) else 'WRONG'
+            loop = 'ok' if stop_loop(backend, injector)[0] else 'WRONG'
+        print(f"{name:>11s} " + ' '.join(f"{counts[key] / args.actions:7.2f}" for key in columns)
+              + f" {'same' if backend.calls == reference_calls else 'DIFFERENT':>9s}"
+              f" {'same' if results == reference_results else 'DIFFERENT':>9s}"
+              f" {ring:>5s} {loop:>5s}")
+    print("(operations per action; calls and results against per-action; loop: stopped with a "
+          "balanced stack and freed)")
+
+
+if __name__ == '__main__':
+    main()
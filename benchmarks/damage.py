@@ -0,0 +1,152 @@
+"""
+Damage Benchmark
+Cob/instant-kill judgments of a whole wave: per-call branching vs lookup tables vs one batch call
+
+Usage:
+    python -m benchmarks.damage [--repeats N]
+
+Each wave is a list of zombies (type, current HP) drawn from every zombie
+type, Gargantuars included. Judging a wave is what cob-target scoring
+does with it: the cob damage, kill and overkill of every zombie, the cob
+hits each needs, whether cherry, jalapeno and doom kill it, and the cob
+efficiency of the hit.
+
+    branching  the functions as they were before the tables: a Gargantuar
+               check per call, and a dict of damage functions built on
+               every can_kill_zombie() and calculate_overkill() call
+    tables     the same calls, now reading the import-time lookup tables
+    batch      one call per judgment on the wave's arrays
+
+All three must give the same judgments.
+"""
+
+import argparse
+import math
+import random
+import time
+
+from data.constants import CHERRY_DAMAGE, DOOM_DAMAGE, DOOM_DAMAGE_GARG, JALAPENO_DAMAGE
+from data.zombies import ZOMBIE_HP_DATA, get_zombie_total_hp, is_gargantuar
+from judge.damage import (
+    calculate_overkill, calculate_overkill_batch, can_kill_zombie, can_kill_zombie_batch,
+)
+from utils.damage import (
+    cobs_needed_to_kill, cobs_needed_to_kill_batch, evaluate_cob_efficiency,
+    evaluate_cob_efficiency_batch,
+)
+
+
+WAVE_SIZES = [10, 50, 200, 1000]
+SOURCES = ('cherry', 'jalapeno', 'doom')
+
+
+def _cherry(zombie_type):
+    return CHERRY_DAMAGE // 2 if is_gargantuar(zombie_type) else CHERRY_DAMAGE
+
+
+def _jalapeno(zombie_type):
+    return JALAPENO_DAMAGE // 2 if is_gargantuar(zombie_type) else JALAPENO_DAMAGE
+
+
+def _doom(zombie_type):
+    return DOOM_DAMAGE_GARG if is_gargantuar(zombie_type) else DOOM_DAMAGE
+
+
+def _cob(zombie_type):
+    return 900 if is_gargantuar(zombie_type) else 1800
+
+
+def _branching_damage(damage_source, zombie_type):
+    damage_funcs = {'cherry': _cherry, 'cob': _cob, 'jalapeno': _jalapeno, 'doom': _doom}
+    return damage_funcs[damage_source](zombie_type)
+
+
+def judge_branching(wave: list) -> tuple:
+    """A wave's judgments with the functions as they were before the tables"""
+    damage = [_cob(t) for _, t in wave]
+    kills = [_branching_damage('cob', t) >= hp for hp, t in wave]
+    overkill = [_branching_damage('cob', t) - hp for hp, t in wave]
+    cobs = [math.ceil(hp / _cob(t)) for hp, t in wave]
+    instant = [[_branching_damage(s, t) >= hp for hp, t in wave] for s in SOURCES]
+    total_damage = useful = killed = 0
+    for (hp, t), d in zip(wave, damage):
+        total_damage += d
+        useful += min(d, hp)
+        killed += d >= hp
+    efficiency = useful / total_damage if total_damage > 0 else 0.0
+    return kills, overkill, cobs, instant, (total_damage, useful, killed, efficiency)
+
+
+def judge_tables(wave: list) -> tuple:
+    """A wave's judgments, one table lookup per call"""
+    kills = [can_kill_zombie(hp, t, 'cob') for hp, t in wave]
+    overkill = [calculate_overkill(hp, t, 'cob') for hp, t in wave]
+    cobs = [cobs_needed_to_kill(t, hp) for hp, t in wave]
+    instant = [[can_kill_zombie(hp, t, s) for hp, t in wave] for s in SOURCES]
+    e = evaluate_cob_efficiency(wave)
+    return kills, overkill, cobs, instant, (e['total_damage'], e['useful_damage'], e['kills'],
+                                            e['efficiency'])
+
+
+def judge_batch(hps: list, types: list) -> tuple:
+    """A wave's judgments, one batch call each"""
+    kills = can_kill_zombie_batch(hps, types, 'cob')
+    overkill = calculate_overkill_batch(hps, types, 'cob')
+    cobs = cobs_needed_to_kill_batch(types, hps)
+    instant = [can_kill_zombie_batch(hps, types, s) for s in SOURCES]
+    e = evaluate_cob_efficiency_batch(types, hps)
+    return kills, overkill, cobs, instant, (e['total_damage'], e['useful_damage'], e['kills'],
+                                            e['efficiency'])
+
+
+def as_lists(judgments: tuple) -> tuple:
+    """Judgments with arrays as lists, comparable"""
+    kills, overkill, cobs, instant, efficiency = judgments
+    return (list(map(bool, kills)), list(map(int, overkill)), list(map(int, cobs)),
+            [list(map(bool, k)) for k in instant], efficiency)
+
+
+def build_wave(size: int, seed: int = 0) -> list:
+    """size zombies of random types with random current HP: (hp, type) tuples"""
+    rng = random.Random(seed)
+    types = sorted(ZOMBIE_HP_DATA)
+    wave = []
+    for _ in range(size):
+        zombie_type = rng.choice(types)
+        wave.append((rng.randint(1, get_zombie_total_hp(zombie_type)), int(zombie_type)))
+    return wave
+
+
+def time_call(func, repeats: int) -> float:
+    """Best microseconds of func() over repeats runs"""
+    best = float('inf')
+    for _ in range(repeats):
+        start = time.perf_counter()
+        func()
+        best = min(best, time.perf_counter() - start)
+    return best * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Damage lookup table benchmark')
+    parser.add_argument('--repeats', type=int, default=50, help='Timed runs per wave')
+    args = parser.parse_args()
+
+    print(f"{'zombies':>8s} {'branch us':>10s} {'tables us':>10s} {'batch us':>9s} "
+          f"{'tables':>7s} {'batch':>7s} {'judgments':>9s}")
+    for size in WAVE_SIZES:
+        wave = build_wave(size)
+        hps = [hp for hp, _ in wave]
+        types = [t for _, t in wave]
+        branch_us = time_call(lambda: judge_branching(wave), args.repeats)
+        tables_us = time_call(lambda: judge_tables(wave), args.repeats)
+        batch_us = time_call(lambda: judge_batch(hps, types), args.repeats)
+        same = (as_lists(judge_branching(wave)) == as_lists(judge_tables(wave))
+                == as_lists(judge_batch(hps, types)))
+        print(f"{size:8d} {branch_us:10.1f} {tables_us:10.1f} {batch_us:9.1f} "
+              f"{branch_us / tables_us:6.2f}x {branch_us / batch_us:6.2f}x "
+              f"{'identical' if same else 'DIFFERENT':>9s}")
+
+
+if __name__ == '__main__':
+    main()
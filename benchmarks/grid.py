@@ -0,0 +1,191 @@
+"""
+Grid Benchmark
+Grid queries and candidate-cell searches on the bitboard Grid against the dict Grid
+
+Usage:
+    python -m benchmarks.grid [--repeats N]
+
+"dict" is Grid as it was before the bitboards: plants in a dict keyed by
+(row, col), with counts and empty cells found by scanning keys or cells,
+and candidate cells found by testing them one by one as StrategyPlanner
+and ActionValidator._find_nearby_cell did. Each query set is timed on the
+grids of the decision states of benchmarks.scenarios and of the
+early-wave, melee and late-wave boards read from a process image:
+
+    build       a grid from the state's plants
+    counts      count_in_row() of every row, count_in_col() of every column
+    empty       get_empty_positions()
+    coverage    rows holding an attacker, columns walled in every row
+    candidates  StrategyPlanner's searches (sunflower cell, attacker and
+                wall cells of every row) and _find_nearby_cell() of every cell
+
+Both grids must give the same answers, and StrategyPlanner.plan() and
+ActionValidator.validate() must decide the same on states carrying either.
+"""
+
+import argparse
+import time
+from dataclasses import replace
+
+from data.offsets import SceneType
+from data.plants import ATTACKING_PLANTS, DEFENSIVE_PLANTS, PlantType
+from engine.action import Action
+from engine.strategy import StrategyPlanner
+from game.grid import Grid
+from llm.validator import ActionValidator
+from benchmarks.scenarios import (
+    build_decision_states, build_early_wave_board, build_late_wave_board, build_melee_board,
+)
+from benchmarks.state_index import read_board
+
+
+class DictGrid:
+    """Grid as a dict of (row, col) -> plant, searched cell by cell"""
+
+    def __init__(self, rows: int = 6, cols: int = 9):
+        self.rows = rows
+        self.cols = cols
+        self._grid = {}
+
+    def set(self, row, col, plant):
+        if 0 <= row < self.rows and 0 <= col < self.cols:
+            self._grid[(row, col)] = plant
+
+    def get(self, row, col):
+        return self._grid.get((row, col), None)
+
+    def is_empty(self, row, col):
+        return self.get(row, col) is None
+
+    def get_empty_positions(self):
+        return [(row, col) for row in range(self.rows) for col in range(self.cols)
+                if (row, col) not in self._grid]
+
+    def count_in_row(self, row):
+        return sum(1 for r, c in self._grid.keys() if r == row)
+
+    def count_in_col(self, col):
+        return sum(1 for r, c in self._grid.keys() if c == col)
+
+    def row_has(self, row, plant_types):
+        return any(self._grid[(row, col)].type in plant_types for col in range(self.cols)
+                   if (row, col) in self._grid)
+
+    def col_is_walled(self, col, plant_types, row_count):
+        return row_count > 0 and all(
+            (row, col) in self._grid and self._grid[(row, col)].type in plant_types
+            for row in range(min(row_count, self.rows)))
+
+    def first_empty_in_row(self, row, cols):
+        for col in cols:
+            if 0 <= col < self.cols and 0 <= row < self.rows and self.is_empty(row, col):
+                return col
+        return None
+
+    def first_empty_in_cols(self, cols, row_count):
+        for col in cols:
+            for row in range(min(row_count, self.rows)):
+                if 0 <= col < self.cols and self.is_empty(row, col):
+                    return (row, col)
+        return None
+
+
+def build(cls: type, plants: list):
+    """A grid of class cls holding the plants (the first plant of a cell wins)"""
+    grid = cls()
+    for plant in reversed(plants):
+        grid.set(plant.row, plant.col, plant)
+    return grid
+
+
+def counts(grid, row_count: int) -> tuple:
+    return (tuple(grid.count_in_row(row) for row in range(row_count)),
+            tuple(grid.count_in_col(col) for col in range(grid.cols)))
+
+
+def empty(grid, row_count: int) -> list:
+    return grid.get_empty_positions()
+
+
+def coverage(grid, row_count: int) -> tuple:
+    return (tuple(row for row in range(row_count) if grid.row_has(row, ATTACKING_PLANTS)),
+            tuple(col for col in range(grid.cols)
+                  if grid.col_is_walled(col, DEFENSIVE_PLANTS, row_count)))
+
+
+def candidates(grid, row_count: int) -> tuple:
+    found = [grid.first_empty_in_cols((1, 0, 2), row_count)]
+    for row in range(row_count):
+        found.append(grid.first_empty_in_row(row, (4, 5, 3)))
+        found.append(grid.first_empty_in_row(row, (3, 2, 4, 5)))
+        for col in range(grid.cols):
+            found.append(grid.first_empty_in_row(row, (col + 1, col - 1, col + 2, col - 2)))
+    return tuple(found)
+
+
+QUERIES = [('counts', counts), ('empty', empty), ('coverage', coverage),
+           ('candidates', candidates)]
+
+
+def decide(state) -> tuple:
+    """StrategyPlanner's plan and the validation of planting on every cell"""
+    plan = StrategyPlanner(state).plan()
+    validator = ActionValidator()
+    verdicts = []
+    for row in range(SceneType.get_row_count(state.scene)):
+        for col in range(9):
+            result = validator.validate(Action.plant(row, col, PlantType.PEASHOOTER), state)
+            verdicts.append((result.valid, result.action.row, result.action.col))
+    return ([(a.action_type, a.plant_type, a.row, a.col) for a in plan.actions], verdicts)
+
+
+def time_call(func, repeats: int) -> float:
+    """Best microseconds of func() over repeats runs"""
+    best = float('inf')
+    for _ in range(repeats):
+        start = time.perf_counter()
+        func()
+        best = min(best, time.perf_counter() - start)
+    return best * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Bitboard Grid benchmark')
+    parser.add_argument('--repeats', type=int, default=200, help='Timed runs per query set')
+    args = parser.parse_args()
+
+    state_sets = [('decision', [state for _, state in build_decision_states()]),
+                  ('early-wave', [read_board(build_early_wave_board)]),
+                  ('melee', [read_board(build_melee_board)]),
+                  ('late-wave', [read_board(build_late_wave_board)])]
+    print(f"{'states':>10s} {'query':>10s} {'dict us':>8s} {'bits us':>8s} {'speedup':>7s} "
+          f"{'answers':>9s}")
+    for name, states in state_sets:
+        boards = [(state.alive_plants, SceneType.get_row_count(state.scene)) for state in states]
+        dict_grids = [build(DictGrid, plants) for plants, _ in boards]
+        bit_grids = [build(Grid, plants) for plants, _ in boards]
+
+        rows = [('build',
+                 lambda: [build(DictGrid, plants) for plants, _ in boards],
+                 lambda: [build(Grid, plants) for plants, _ in boards], True)]
+        for query_name, query in QUERIES:
+            rows.append((query_name,
+                         lambda q=query: [q(g, n) for g, (_, n) in zip(dict_grids, boards)],
+                         lambda q=query: [q(g, n) for g, (_, n) in zip(bit_grids, boards)],
+                         None))
+        for query_name, on_dict, on_bits, same in rows:
+            dict_us = time_call(on_dict, args.repeats) / len(states)
+            bits_us = time_call(on_bits, args.repeats) / len(states)
+            if same is None:
+                same = on_dict() == on_bits()
+            print(f"{name:>10s} {query_name:>10s} {dict_us:8.2f} {bits_us:8.2f} "
+                  f"{dict_us / bits_us:6.2f}x {'identical' if same else 'DIFFERENT':>9s}")
+
+        decisions = all(decide(replace(state, plant_grid=d)) == decide(replace(state, plant_grid=b))
+                        for state, d, b in zip(states, dict_grids, bit_grids))
+        print(f"{name:>10s} {'decisions':>10s} {'':>8s} {'':>8s} {'':>7s} "
+              f"{'identical' if decisions else 'DIFFERENT':>9s}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,84 @@
+"""
+Headless Bot Benchmark
+Throughput of the whole bot loop on a simulated level
+
+Usage:
+    python -m benchmarks.headless [--waves 20] [--optimizer rules|mcts] [--budget S]
+                                  [--speed X]
+
+OptimalBot plays a level of a HeadlessInterface (engine.headless) from the
+first poll to the end of the level: its poller thread reads states, its
+decision loop picks and executes actions, and the level advances 5 frames
+(the 50 ms BotConfig.refresh_rate) per state read. With --speed 0 the
+poller runs in lockstep with the decisions, so the game runs as fast as
+the bot decides on states; with --speed X the game runs at X times real time
+and the poller keeps refresh_rate.
+
+Faster than real time means the level took less wall time than its game
+time. Decisions count the states the optimizer was asked about; actions
+count the plants and shovels that were done.
+"""
+
+import argparse
+import contextlib
+import io
+import time
+
+from config import BotConfig
+from engine.headless import HeadlessInterface, create_level_waves
+from main import OptimalBot
+from utils.logger import LogLevel, get_logger
+
+
+def play(waves: int, optimizer: str, budget: float, speed: float) -> dict:
+    """Play one level with OptimalBot; what it took"""
+    config = BotConfig()
+    config.use_mcts = optimizer == 'mcts'
+    config.mcts_time_budget = budget
+    if speed == 0:
+        config.refresh_rate = 0.0
+        config.lockstep_polling = True
+    memory = HeadlessInterface(create_level_waves(waves), speed=speed)
+    bot = OptimalBot(config, memory=memory)
+
+    decisions = 0
+    get_best_action = bot.optimizer.get_best_action
+
+    def counted(state):
+        nonlocal decisions
+        decisions += 1
+        return get_best_action(state)
+
+    bot.optimizer.get_best_action = counted
+    start = time.perf_counter()
+    with contextlib.redirect_stdout(io.StringIO()):  # Banner, status line, actions
+        bot.start()
+    wall = time.perf_counter() - start
+    return {'wall': wall, 'game': memory.sim.frame / 100, 'polls': memory.polls,
+            'decisions': decisions, 'actions': memory.actions, 'wave': memory.sim.wave,
+            'result': 'won' if memory.won else 'lost', 'latency': bot.latency}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Headless bot loop benchmark')
+    parser.add_argument('--waves', type=int, default=20, help='Waves of the level')
+    parser.add_argument('--optimizer', choices=('rules', 'mcts'), default='rules',
+                        help='Decision stack (BotConfig.use_mcts)')
+    parser.add_argument('--budget', type=float, default=BotConfig().mcts_time_budget,
+                        help='MCTS seconds per decision')
+    parser.add_argument('--speed', type=float, default=0.0,
+                        help='Game speed (0: as fast as the bot decides on states)')
+    args = parser.parse_args()
+
+    get_logger().set_level(LogLevel.WARNING)  # The bot's own start and end messages
+    r = play(args.waves, args.optimizer, args.budget, args.speed)
+    print(f"level: {r['result']} at wave {r['wave']}/{args.waves}, "
+          f"{r['game']:.0f} s of game time in {r['wall']:.2f} s "
+          f"({r['game'] / r['wall']:.1f}x real time)")
+    print(f"loop: {r['polls']} polls ({r['polls'] / r['wall']:.0f}/s), "
+          f"{r['decisions']} decisions, {r['actions']} actions")
+    print(f"read-to-act: {r['latency'].summary()}")
+
+
+if __name__ == '__main__':
+    main()
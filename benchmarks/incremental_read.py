@@ -0,0 +1,199 @@
+"""
+Incremental Read Benchmark
+Cost of polling the state with GameReader's incremental mode against full reads
+
+Usage:
+    python -m benchmarks.incremental_read [--polls N] [--no-noise]
+
+Each benchmark board is played on by a GameSimulator, 5 frames (the 50 ms
+BotConfig.refresh_rate) between polls. A live process image follows the
+game: every entity keeps its array slot while it lives, as in the game,
+and only the fields the readers decode are rewritten. With noise on, one
+byte outside the decoded fields changes in every live record on every
+poll, as the game's animation counters do, so unchanged records still
+have changed bytes.
+
+Each poll is read by a plain GameReader and an incremental one; both must
+return the same state. "rebuilt" is the info objects created per poll, and
+the encoder columns are StateEncoder.encode() of each state, which the
+incremental state lets reuse the lines of unchanged plants and zombies.
+"""
+
+import argparse
+import random
+import statistics
+import struct
+import time
+
+from data.offsets import Offset
+from game.reader import GameReader, RecordLayout, ZOMBIE_LAYOUT, PLANT_LAYOUT, PROJECTILE_LAYOUT
+from llm.encoder import StateEncoder
+from memory.backend import ImageBackend
+from memory.reader import MemoryReader
+from benchmarks.scenarios import build_early_wave_board, build_late_wave_board, build_melee_board
+from benchmarks.state_read import (
+    ARRAY_STRIDE, BOARD, build_image, plant_record, projectile_record, random_record,
+    state_key, zombie_record,
+)
+
+
+REFRESH_FRAMES = 5
+
+# Where the live arrays go, after those of build_image()
+LIVE_START = 0x06000000
+LIVE_CAPACITY = 1024
+
+
+def free_byte(layout: RecordLayout) -> int:
+    """Offset of the first record byte no decoded field covers"""
+    used = set()
+    for _, offset, code in layout.fields:
+        used.update(range(offset, offset + struct.calcsize('<' + code)))
+    if layout.dead_offset is not None:
+        used.add(layout.dead_offset)
+    return min(set(range(layout.size)) - used)
+
+
+class LiveArray:
+    """One entity array of the image, kept in step with simulator objects"""
+
+    def __init__(self, image: ImageBackend, address: int, layout: RecordLayout,
+                 to_record, rng: random.Random):
+        self.image = image
+        self.address = address
+        self.layout = layout
+        self.to_record = to_record
+        self.offsets = {name: (offset, code) for name, offset, code in layout.fields}
+        self.noise = free_byte(layout)
+        self.slots = {}  # id(object) -> (object, slot); holding the object keeps its id
+        self.free = []
+        self.count = 0
+        data = bytearray(layout.array_bytes(LIVE_CAPACITY))
+        for i in range(LIVE_CAPACITY):
+            data[i * layout.size:(i + 1) * layout.size] = random_record(layout, rng)[:layout.size]
+            data[i * layout.size + layout.dead_offset] = 1
+        image.map(address, data)
+
+    def sync(self, objects: list, noise: int) -> None:
+        """Write the live objects into their slots and free the slots of dead ones"""
+        alive = {id(obj): obj for obj in objects if obj.is_alive}
+        for key in [key for key in self.slots if key not in alive]:
+            _, slot = self.slots.pop(key)
+            self.image.write(self.address + slot * self.layout.size + self.layout.dead_offset,
+                             b'\1')
+            self.free.append(slot)
+        for key, obj in alive.items():
+            if key in self.slots:
+                slot = self.slots[key][1]
+            else:
+                slot = self.free.pop(0) if self.free else self.count
+                self.count = max(self.count, slot + 1)
+                self.slots[key] = (obj, slot)
+            base = self.address + slot * self.layout.size
+            for name, value in self.to_record(obj).items():
+                offset, code = self.offsets[name]
+                self.image.write(base + offset, struct.pack('<' + code, value))
+            self.image.write(base + self.layout.dead_offset, b'\0')
+            if noise:
+                self.image.write(base + self.noise, bytes([noise]))
+
+
+class LiveImage:
+    """A process image that follows a simulated game"""
+
+    def __init__(self, sim, seed: int = 0):
+        self.sim = sim
+        self.image = build_image(sim, 0.0, seed)
+        rng = random.Random(seed)
+        self.arrays = []
+        kinds = [('zombie', ZOMBIE_LAYOUT, zombie_record, lambda: sim.zombies),
+                 ('plant', PLANT_LAYOUT, plant_record, lambda: sim.plants),
+                 ('projectile', PROJECTILE_LAYOUT, projectile_record, lambda: sim.projectiles)]
+        for n, (name, layout, to_record, objects) in enumerate(kinds):
+            live = LiveArray(self.image, LIVE_START + n * ARRAY_STRIDE, layout, to_record, rng)
+            self.image.write(BOARD + getattr(Offset, f'{name.upper()}_ARRAY'),
+                             struct.pack('<I', live.address))
+            self.arrays.append((name, live, objects))
+
+    def sync(self, noise: int) -> None:
+        """Write the simulator's current board into the image"""
+        for name, live, objects in self.arrays:
+            live.sync(objects(), noise)
+            self.image.write(BOARD + getattr(Offset, f'{name.upper()}_COUNT_MAX'),
+                             struct.pack('<i', live.count))
+        self.image.write(BOARD + Offset.SUN, struct.pack('<i', self.sim.sun))
+        self.image.write(BOARD + Offset.GAME_CLOCK, struct.pack('<i', self.sim.frame))
+
+
+def rebuilt(state, previous) -> int:
+    """Info objects of a state that were not in the previous one"""
+    if previous is None:
+        return len(state.zombies) + len(state.plants) + len(state.projectiles)
+    old = {id(obj) for obj in previous.zombies + previous.plants + previous.projectiles}
+    return sum(id(obj) not in old for obj in state.zombies + state.plants + state.projectiles)
+
+
+def timed(fn):
+    """(result, microseconds) of one call"""
+    start = time.perf_counter()
+    result = fn()
+    return result, (time.perf_counter() - start) * 1e6
+
+
+def play(build, polls: int, noise: bool) -> dict:
+    """Poll one game with both readers; per-poll means of each measurement"""
+    sim = build()
+    live = LiveImage(sim)
+    live.sync(1 if noise else 0)
+    full = GameReader(MemoryReader(backend=live.image))
+    incremental = GameReader(MemoryReader(backend=live.image), incremental=True)
+    full_encoder, incremental_encoder = StateEncoder(), StateEncoder()
+
+    rows = {key: [] for key in ('entities', 'full us', 'incr us', 'full rebuilt', 'incr rebuilt',
+                                'full enc us', 'incr enc us')}
+    previous = {False: None, True: None}
+    identical = True
+    for poll in range(polls):
+        full_state, full_us = timed(full.read_game_state)
+        incr_state, incr_us = timed(incremental.read_game_state)
+        full_text, full_enc_us = timed(lambda: full_encoder.encode(full_state))
+        incr_text, incr_enc_us = timed(lambda: incremental_encoder.encode(incr_state))
+        identical &= state_key(full_state) == state_key(incr_state) and full_text == incr_text
+        if poll:  # The first poll builds everything in both modes
+            rows['entities'].append(len(full_state.zombies) + len(full_state.plants)
+                                    + len(full_state.projectiles))
+            rows['full us'].append(full_us)
+            rows['incr us'].append(incr_us)
+            rows['full rebuilt'].append(rebuilt(full_state, previous[False]))
+            rows['incr rebuilt'].append(rebuilt(incr_state, previous[True]))
+            rows['full enc us'].append(full_enc_us)
+            rows['incr enc us'].append(incr_enc_us)
+        previous = {False: full_state, True: incr_state}
+
+        sim.tick_n(REFRESH_FRAMES)
+        live.sync(poll % 255 + 2 if noise else 0)
+    result = {key: statistics.mean(values) for key, values in rows.items()}
+    result['check'] = 'identical' if identical else 'DIFFERENT'
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Incremental state read benchmark')
+    parser.add_argument('--polls', type=int, default=200, help='Polls per board')
+    parser.add_argument('--no-noise', action='store_true',
+                        help='Leave the bytes outside decoded fields unchanged')
+    args = parser.parse_args()
+
+    boards = [('early-wave', build_early_wave_board), ('melee', build_melee_board),
+              ('late-wave', build_late_wave_board)]
+    print(f"{'board':>10s} {'entities':>8s} {'check':>9s} {'full us':>8s} {'incr us':>8s} "
+          f"{'full rebuilt':>12s} {'incr rebuilt':>12s} {'full enc us':>11s} {'incr enc us':>11s}")
+    for name, build in boards:
+        r = play(build, args.polls, not args.no_noise)
+        print(f"{name:>10s} {r['entities']:8.0f} {r['check']:>9s} {r['full us']:8.1f} "
+              f"{r['incr us']:8.1f} {r['full rebuilt']:12.1f} {r['incr rebuilt']:12.1f} "
+              f"{r['full enc us']:11.1f} {r['incr enc us']:11.1f}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,86 @@
+"""
+MCTS Optimizer Benchmark
+Simulations per second and decision quality against the rule-based optimizer
+
+Usage:
+    python -m benchmarks.mcts [--budget SECONDS] [--states N]
+
+Every state of a fixed set gets one decision from the rule-based
+ActionOptimizer and one from MCTSOptimizer. Each decision is judged the same
+way: apply it to a simulated board, play on without further actions for
+--judge-frames frames, and score the board with evaluate_board (0 = lost,
+1 = every zombie dead with nothing lost). The gap is MCTS minus rule-based.
+States where the planner offers nothing valid are decided "wait" by both.
+
+"ms" is the whole MCTS decision (candidates, board and search) and "over"
+how far it ran past --budget; "untried" counts the root actions the budget
+left unsearched.
+"""
+
+import argparse
+import statistics
+
+from engine.action import Action
+from engine.optimizer import ActionOptimizer, MCTSOptimizer, apply_action, build_simulator, evaluate_board
+from benchmarks.scenarios import build_decision_states
+
+
+def judge(state, action: Action, frames: int) -> float:
+    """Score of the board a decision leads to"""
+    sim = build_simulator(state)
+    zombie_hp = sum(z.total_health for z in sim.zombies if z.is_alive)
+    plant_hp = sum(p.health for p in sim.plants if p.is_alive)
+    if action is not None and not action.is_wait:
+        apply_action(sim, action)
+    sim.tick_n(frames, skip_ahead=True)
+    return evaluate_board(sim, zombie_hp, plant_hp)
+
+
+def describe(action: Action) -> str:
+    if action is None or action.is_wait:
+        return 'wait'
+    if action.plant_type >= 0:
+        return f"{action.type_name.lower()} {action.plant_type}@({action.row},{action.col})"
+    return f"{action.type_name.lower()}@({action.row},{action.col})"
+
+
+def main():
+    parser = argparse.ArgumentParser(description='MCTS optimizer benchmark')
+    parser.add_argument('--budget', type=float, default=0.03, help='MCTS seconds per decision')
+    parser.add_argument('--states', type=int, default=12, help='Decision states')
+    parser.add_argument('--judge-frames', type=int, default=1000, help='Frames played to judge')
+    args = parser.parse_args()
+
+    rule_based = ActionOptimizer()
+    mcts = MCTSOptimizer(time_budget=args.budget, reuse_tree=False)
+    gaps, sim_rates, rollout_rates, overruns = [], [], [], []
+    print(f"{'state':>8s} {'rule-based':>22s} {'value':>6s} {'mcts':>22s} {'value':>6s} "
+          f"{'sims/s':>8s} {'rollouts/s':>10s} {'ms':>6s} {'over':>5s} {'untried':>7s}")
+    for name, state in build_decision_states(args.states):
+        rule_action = rule_based.get_best_action(state)
+        mcts_action = mcts.get_best_action(state)
+        rule_value = judge(state, rule_action, args.judge_frames)
+        mcts_value = judge(state, mcts_action, args.judge_frames)
+        gaps.append(mcts_value - rule_value)
+        stats = mcts.last_stats
+        if stats.simulations:
+            sim_rates.append(stats.simulations_per_second)
+            rollout_rates.append(stats.rollouts_per_second)
+        overruns.append(stats.overrun)
+        print(f"{name:>8s} {describe(rule_action):>22s} {rule_value:6.3f} "
+              f"{describe(mcts_action):>22s} {mcts_value:6.3f} "
+              f"{stats.simulations_per_second:8.0f} {stats.rollouts_per_second:10.0f} "
+              f"{stats.decision * 1e3:6.1f} {stats.overrun * 1e3:5.1f} {stats.untried:7d}")
+
+    print(f"mean gap (mcts - rule-based): {statistics.mean(gaps):+.4f}, "
+          f"better on {sum(g > 1e-9 for g in gaps)}, worse on {sum(g < -1e-9 for g in gaps)} "
+          f"of {len(gaps)} states")
+    print(f"over budget: {sum(o > 0 for o in overruns)} of {len(overruns)} decisions, "
+          f"worst by {max(overruns) * 1e3:.1f} ms")
+    if sim_rates:
+        print(f"median at {args.budget * 1e3:.0f} ms budget: {statistics.median(sim_rates):.0f} "
+              f"simulations/s, {statistics.median(rollout_rates):.0f} rollouts/s")
+
+
+if __name__ == '__main__':
+    main()
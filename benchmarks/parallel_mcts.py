@@ -0,0 +1,131 @@
+"""
+Parallel MCTS Benchmark
+Root-parallel search scaling over worker processes, and board encoding cost
+
+Usage:
+    python -m benchmarks.parallel_mcts [--budget SECONDS] [--workers 1,2,4,8,16]
+
+First compares the encode_state() bytes shipped to workers against pickling
+the packed snapshot and the entity dataclass lists, and checks that decoded
+boards play on identically. Then runs the decision states of benchmarks.mcts
+with the serial MCTSOptimizer and with ParallelMCTSOptimizer at each worker
+count: simulations and rollouts per second are totals over all workers, the
+latency is the wall time of a whole decision (budget plus shipping and
+merging), and the gap is the decision value against the serial search.
+Scaling is bounded by the CPU count printed first.
+"""
+
+import argparse
+import os
+import pickle
+import statistics
+import time
+
+from engine.optimizer import MCTSOptimizer, build_simulator
+from engine.parallel_search import ParallelMCTSOptimizer
+from engine.simulator import encode_state, decode_state
+from benchmarks.mcts import judge
+from benchmarks.scenarios import (
+    build_decision_states, build_early_wave_board, build_late_wave_board, build_melee_board,
+)
+from benchmarks.simulator import board_signature
+
+
+def time_call(fn, repeats: int, inner: int = 20) -> float:
+    """Best time per call in microseconds"""
+    best = float('inf')
+    for _ in range(repeats):
+        start = time.perf_counter()
+        for _ in range(inner):
+            fn()
+        best = min(best, time.perf_counter() - start)
+    return best / inner * 1e6
+
+
+def check_decoded(board, frames: int) -> bool:
+    """Check that a decoded snapshot plays on like the original board"""
+    board.state_hash
+    copy = board.clone()
+    copy.restore(decode_state(encode_state(board.snapshot())))
+    if copy.state_hash != board.state_hash:
+        return False
+    reference = board.clone()
+    reference.tick_n(frames)
+    copy.tick_n(frames)
+    return board_signature(copy) == board_signature(reference)
+
+
+def report_encoding(repeats: int) -> None:
+    print(f"{'board':>10s} {'check':>9s} {'bytes':>7s} {'pickled':>8s} {'dataclass':>10s} "
+          f"{'encode+decode us':>17s} {'pickle+unpickle us':>19s}")
+    boards = [('early-wave', build_early_wave_board), ('melee', build_melee_board),
+              ('late-wave', build_late_wave_board)]
+    for name, build in boards:
+        board = build()
+        status = 'identical' if check_decoded(board, 300) else 'DIVERGED'
+        state = board.snapshot()
+        data = encode_state(state)
+        pickled = pickle.dumps(state)
+        entities = pickle.dumps((board.plants, board.zombies, board.projectiles))
+        encoded_us = time_call(lambda: decode_state(encode_state(state)), repeats)
+        pickled_us = time_call(lambda: pickle.loads(pickle.dumps(state)), repeats)
+        print(f"{name:>10s} {status:>9s} {len(data):7d} {len(pickled):8d} {len(entities):10d} "
+              f"{encoded_us:17.1f} {pickled_us:19.1f}")
+
+
+def run_decisions(optimizer, states, reference_values, judge_frames: int):
+    """
+    Decide every state with one optimizer
+
+    Returns:
+        (median sims/s, median rollouts/s, median latency ms, mean gap, decision values)
+    """
+    sim_rates, rollout_rates, latencies, values = [], [], [], []
+    for name, state in states:
+        start = time.perf_counter()
+        action = optimizer.get_best_action(state)
+        latency = time.perf_counter() - start
+        values.append(judge(state, action, judge_frames))
+        stats = optimizer.last_stats
+        if stats.simulations:
+            sim_rates.append(stats.simulations / latency)
+            rollout_rates.append(stats.nodes / latency)
+            latencies.append(latency * 1e3)
+    gaps = [v - r for v, r in zip(values, reference_values)] if reference_values else [0.0]
+    return (statistics.median(sim_rates), statistics.median(rollout_rates),
+            statistics.median(latencies), statistics.mean(gaps), values)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Parallel MCTS benchmark')
+    parser.add_argument('--budget', type=float, default=0.03, help='MCTS seconds per decision')
+    parser.add_argument('--states', type=int, default=12, help='Decision states')
+    parser.add_argument('--workers', default='1,2,4,8,16', help='Worker counts to measure')
+    parser.add_argument('--judge-frames', type=int, default=1000, help='Frames played to judge')
+    parser.add_argument('--repeats', type=int, default=5, help='Timed runs per encoding')
+    args = parser.parse_args()
+
+    print(f"cpus: {os.cpu_count()}")
+    report_encoding(args.repeats)
+
+    states = build_decision_states(args.states)
+    serial = MCTSOptimizer(time_budget=args.budget, reuse_tree=False)
+    print(f"{'search':>10s} {'sims/s':>8s} {'rollouts/s':>10s} {'latency ms':>11s} "
+          f"{'speedup':>8s} {'gap':>8s}")
+    rates = run_decisions(serial, states, None, args.judge_frames)
+    reference_values = rates[4]
+    print(f"{'serial':>10s} {rates[0]:8.0f} {rates[1]:10.0f} {rates[2]:11.1f} "
+          f"{'':>8s} {'':>8s}")
+
+    base_rate = None
+    for workers in (int(w) for w in args.workers.split(',')):
+        with ParallelMCTSOptimizer(workers=workers, time_budget=args.budget) as parallel:
+            parallel.warm_up()  # start the workers before timing
+            rates = run_decisions(parallel, states, reference_values, args.judge_frames)
+        base_rate = base_rate or rates[1]
+        print(f"{f'{workers} workers':>10s} {rates[0]:8.0f} {rates[1]:10.0f} {rates[2]:11.1f} "
+              f"{rates[1] / base_rate:7.2f}x {rates[3]:+8.4f}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,139 @@
+"""
+Pointer Cache Benchmark
+Memory reads per state refresh with and without MemoryReader's pointer cache
+
+Usage:
+    python -m benchmarks.pointer_cache [--repeats N]
+
+Runs refreshes of the bot loop against the process images of
+benchmarks.state_read, with the pointer cache off (every getter walks
+BASE -> Board) and on (refresh() walks it once per tick):
+
+    getters    the per-getter reads main.py used to make: UI state, the
+               scalars through get_sun()/get_wave()/..., each array through
+               its getters and per-field records
+    interface  PVZMemoryInterface.get_game_state() and collect_all_items()
+
+Correctness: both settings must read the same states, and the cache must
+follow the board when it moves and when the game leaves the board.
+"""
+
+import argparse
+import struct
+import time
+
+from data.offsets import Offset
+from main import PVZMemoryInterface
+from memory.backend import ImageBackend
+from memory.reader import MemoryReader
+from benchmarks.scenarios import build_early_wave_board, build_late_wave_board, build_melee_board
+from benchmarks.state_read import BOARD, PVZ_BASE, FieldReader, SyscallBackend, build_image, state_key
+
+
+MOVED_BOARD = 0x05000000
+
+
+def read_with_getters(reader: MemoryReader):
+    """One refresh the way main.py read before GameReader, through the getters"""
+    if not reader.refresh():
+        return None
+    state = FieldReader(reader).read_game_state()
+    state.sun = reader.get_sun()
+    state.wave = reader.get_wave()
+    state.total_waves = reader.get_total_waves()
+    state.game_clock = reader.get_game_clock()
+    state.scene = reader.get_scene()
+    return state
+
+
+def read_with_interface(memory: PVZMemoryInterface):
+    """One refresh of OptimalBot._run_loop"""
+    state = memory.get_game_state()
+    memory.collect_all_items()
+    return state
+
+
+def run(workload: str, backend, cache: bool):
+    """(state reader, MemoryReader) for a workload"""
+    if workload == 'getters':
+        reader = MemoryReader(backend=backend, cache_pointers=cache)
+        return (lambda: read_with_getters(reader)), reader
+    memory = PVZMemoryInterface(backend)
+    memory.attach()
+    memory.reader.cache_pointers = cache
+    return (lambda: read_with_interface(memory)), memory.reader
+
+
+def reads_per_refresh(workload: str, image: ImageBackend, cache: bool) -> tuple:
+    """(reads per refresh after warm-up, state)"""
+    refresh, reader = run(workload, image, cache)
+    refresh()
+    start = reader.reads
+    state = refresh()
+    return reader.reads - start, state
+
+
+def time_refresh(workload: str, backend, cache: bool, repeats: int, inner: int = 5) -> float:
+    """Best time per refresh in microseconds"""
+    refresh, _ = run(workload, backend, cache)
+    refresh()
+    best = float('inf')
+    for _ in range(repeats):
+        start = time.perf_counter()
+        for _ in range(inner):
+            refresh()
+        best = min(best, time.perf_counter() - start)
+    return best / inner * 1e6
+
+
+def check_invalidation(image: ImageBackend) -> bool:
+    """Move the board and leave the game; the cached reader must follow"""
+    memory = PVZMemoryInterface(image)
+    memory.attach()
+    before = memory.get_game_state()
+
+    # New board object with more sun, different arrays would follow the same way
+    board = bytearray(image.read(BOARD, Offset.CLICK_PAO_COUNTDOWN + 4))
+    struct.pack_into('<i', board, Offset.SUN, before.sun + 1234)
+    image.map(MOVED_BOARD, board)
+    image.write(PVZ_BASE + Offset.MAIN_OBJECT, struct.pack('<I', MOVED_BOARD))
+    moved = memory.get_game_state()
+    moved_ok = (moved is not None and moved.sun == before.sun + 1234
+                and memory.reader.get_board() == MOVED_BOARD)
+
+    image.write(PVZ_BASE + Offset.GAME_UI, struct.pack('<i', 2))
+    left_ok = memory.get_game_state() is None and not memory.reader._board_pointers
+    image.write(PVZ_BASE + Offset.GAME_UI, struct.pack('<i', 3))
+    image.write(PVZ_BASE + Offset.MAIN_OBJECT, struct.pack('<I', BOARD))
+    back = memory.get_game_state()
+    return moved_ok and left_ok and state_key(back) == state_key(before)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pointer cache benchmark')
+    parser.add_argument('--repeats', type=int, default=5, help='Timed runs per setting')
+    args = parser.parse_args()
+
+    boards = [('early-wave', build_early_wave_board), ('melee', build_melee_board),
+              ('late-wave', build_late_wave_board)]
+    print(f"{'board':>10s} {'workload':>9s} {'check':>9s} {'reads off':>9s} {'reads on':>9s} "
+          f"{'off us':>8s} {'on us':>8s}")
+    for name, build in boards:
+        image = build_image(build(), 0.25)
+        for workload in ('getters', 'interface'):
+            reads_off, state_off = reads_per_refresh(workload, image, False)
+            reads_on, state_on = reads_per_refresh(workload, image, True)
+            status = 'identical' if state_key(state_off) == state_key(state_on) else 'DIFFERENT'
+            syscalls = SyscallBackend(image)
+            off_us = time_refresh(workload, syscalls, False, args.repeats)
+            on_us = time_refresh(workload, syscalls, True, args.repeats)
+            syscalls.close()
+            print(f"{name:>10s} {workload:>9s} {status:>9s} {reads_off:9d} {reads_on:9d} "
+                  f"{off_us:8.0f} {on_us:8.0f}")
+
+    image = build_image(build_melee_board(), 0.25)
+    print(f"invalidation: {'ok' if check_invalidation(image) else 'FAILED'}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,178 @@
+"""
+State Poller Benchmark
+Reaction time of the bot loop with state reads inline and on a poller thread
+
+Usage:
+    python -m benchmarks.poller [--seconds S] [--budget SECONDS]
+
+A game runs in real time on its own thread: a GameSimulator on the
+early-wave board ticks 100 frames per second into a live process image
+(benchmarks.incremental_read), read through SyscallBackend so reads cost
+what they cost against the game. Each decision computes for --budget
+seconds, as MCTSOptimizer does (the image's random seed bank gives the
+real optimizer nothing to search), in two loops:
+
+    inline    OptimalBot's loop before the poller: read, decide, sleep
+              refresh_rate
+    threaded  StatePoller reads every refresh_rate on its own thread and
+              the decider takes the latest state as soon as it is free
+
+An event happens every 7 game frames. Reaction is the wall time from an
+event to the end of the first decision on a state that shows it; read to
+act is the age of a state when its decision ends. Decisions per second
+count the decisions made.
+"""
+
+import argparse
+import threading
+import time
+
+from config import BotConfig
+from game.poller import LatencyHistogram, StatePoller
+from main import PVZMemoryInterface
+from benchmarks.incremental_read import REFRESH_FRAMES, LiveImage
+from benchmarks.scenarios import build_early_wave_board
+from benchmarks.state_read import SyscallBackend
+
+
+EVENT_FRAMES = 7
+
+
+class RealTimeGame:
+    """A simulated game ticking at 100 frames per second on a thread"""
+
+    def __init__(self):
+        self.sim = build_early_wave_board()
+        self.live = LiveImage(self.sim)
+        self.live.sync(1)
+        self.start = 0.0
+        self._stop = threading.Event()
+        self._thread = threading.Thread(target=self._run, daemon=True)
+
+    def event_time(self, frame: int) -> float:
+        """perf_counter() time at which a game frame was reached"""
+        return self.start + frame / 100.0
+
+    def begin(self) -> None:
+        self.start = time.perf_counter()
+        self._thread.start()
+
+    def end(self) -> None:
+        self._stop.set()
+        self._thread.join()
+
+    def _run(self) -> None:
+        noise = 0
+        while not self._stop.is_set():
+            target = int((time.perf_counter() - self.start) * 100)
+            if target - self.sim.frame >= REFRESH_FRAMES:
+                self.sim.tick_n(target - self.sim.frame)
+                noise = noise % 250 + 2
+                self.live.sync(noise)
+            self._stop.wait(0.01)
+
+
+def decide(state, budget: float) -> int:
+    """Stand-in decision: Python work on the state for budget seconds"""
+    deadline = time.perf_counter() + budget
+    work = 0
+    while time.perf_counter() < deadline:
+        work += sum(zombie.row for zombie in state.zombies)
+    return work
+
+
+class Measurement:
+    """Reaction and read-to-act latencies of one loop"""
+
+    def __init__(self, game: RealTimeGame):
+        self.game = game
+        self.reaction = LatencyHistogram()
+        self.read_to_act = LatencyHistogram()
+        self.decisions = 0
+        self._next_event = EVENT_FRAMES
+
+    def decided(self, game_clock: int, read_time: float) -> None:
+        """Record a decision on a state of game_clock read at read_time"""
+        now = time.perf_counter()
+        self.decisions += 1
+        self.read_to_act.record(now - read_time)
+        while self._next_event <= game_clock:
+            self.reaction.record(now - self.game.event_time(self._next_event))
+            self._next_event += EVENT_FRAMES
+
+
+def run_inline(memory, budget: float, measure: Measurement, config: BotConfig, deadline: float):
+    """The loop as it was: read, decide, sleep"""
+    while time.perf_counter() < deadline:
+        state = memory.get_game_state()
+        read_time = time.perf_counter()
+        if state is None:
+            time.sleep(0.5)
+            continue
+        memory.collect_all_items()
+        decide(state, budget)
+        measure.decided(state.game_clock, read_time)
+        time.sleep(config.refresh_rate)
+
+
+def run_threaded(memory, budget: float, measure: Measurement, config: BotConfig, deadline: float):
+    """OptimalBot's loop: decide on the poller's latest state"""
+    def poll():
+        state = memory.get_game_state()
+        if state is not None:
+            memory.collect_all_items()
+        return state
+
+    poller = StatePoller(poll, config.refresh_rate)
+    poller.start()
+    sequence = 0
+    try:
+        while time.perf_counter() < deadline:
+            published = poller.wait_newer(sequence, timeout=0.5)
+            if published is None:
+                continue
+            sequence = published.sequence
+            if published.state is None:
+                continue
+            decide(published.state, budget)
+            measure.decided(published.game_clock, published.read_time)
+    finally:
+        poller.stop()
+
+
+def measure_loop(loop, seconds: float, budget: float) -> Measurement:
+    config = BotConfig()
+    game = RealTimeGame()
+    memory = PVZMemoryInterface(SyscallBackend(game.live.image))
+    memory.attach()
+    measure = Measurement(game)
+    game.begin()
+    try:
+        loop(memory, budget, measure, config, time.perf_counter() + seconds)
+    finally:
+        game.end()
+        memory.close()
+    return measure
+
+
+def main():
+    parser = argparse.ArgumentParser(description='State poller benchmark')
+    parser.add_argument('--seconds', type=float, default=10.0, help='Wall time per loop')
+    parser.add_argument('--budget', type=float, default=BotConfig().mcts_time_budget,
+                        help='Seconds per decision')
+    args = parser.parse_args()
+
+    print(f"{'loop':>9s} {'decisions/s':>11s} {'reaction mean':>13s} {'p50':>6s} {'p99':>6s} "
+          f"{'read-to-act mean':>16s} {'p99':>6s}")
+    for name, loop in (('inline', run_inline), ('threaded', run_threaded)):
+        m = measure_loop(loop, args.seconds, args.budget)
+        print(f"{name:>9s} {m.decisions / args.seconds:11.1f} {m.reaction.mean:11.1f}ms "
+              f"{m.reaction.percentile(50):4.0f}ms {m.reaction.percentile(99):4.0f}ms "
+              f"{m.read_to_act.mean:14.1f}ms {m.read_to_act.percentile(99):4.0f}ms")
+        if name == 'threaded':
+            for line in m.reaction.lines():
+                print(f"  reaction {line}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,99 @@
+"""
+Read Schedule Benchmark
+Bytes read per poll with and without a ReadSchedule, and the age of what is served
+
+Usage:
+    python -m benchmarks.read_schedule [--polls N] [--require-every K]
+
+Each benchmark board is played on by a GameSimulator and followed by a live
+process image (benchmarks.incremental_read), polled every 5 frames as the
+bot polls. Every poll is read by a plain GameReader and by an incremental
+one with the default ReadSchedule, each through a CountingBackend. Every
+--require-every polls the scheduled reader is asked for fresh plants and
+seed cards, as OptimalBot does before acting (action_interval over
+refresh_rate polls).
+
+Each section the scheduled reader serves must equal the plain reader's
+section from as many game centiseconds earlier as its age says, and that
+age must stay within the section's budget.
+"""
+
+import argparse
+import statistics
+
+from game.reader import GameReader
+from game.schedule import SECTIONS, ReadSchedule
+from memory.reader import MemoryReader
+from benchmarks.incremental_read import REFRESH_FRAMES, LiveImage
+from benchmarks.scenarios import build_early_wave_board, build_late_wave_board, build_melee_board
+from benchmarks.state_read import CountingBackend
+
+
+def play(build, polls: int, require_every: int) -> dict:
+    """Poll one game with both readers; per-poll means and the checks"""
+    sim = build()
+    live = LiveImage(sim)
+    live.sync(1)
+    full_backend = CountingBackend(live.image)
+    scheduled_backend = CountingBackend(live.image)
+    full = GameReader(MemoryReader(backend=full_backend))
+    schedule = ReadSchedule()
+    scheduled = GameReader(MemoryReader(backend=scheduled_backend), incremental=True,
+                           schedule=schedule)
+
+    history = {}  # Game clock -> plain reader's sections
+    rows = {key: [] for key in ('full bytes', 'sched bytes', 'full reads', 'sched reads')}
+    served, within = True, True
+    worst = {name: 0 for name in SECTIONS}
+    for poll in range(polls):
+        if require_every and poll % require_every == 0:
+            schedule.require_fresh('plants', 'seeds')
+        before = (full_backend.bytes, full_backend.reads,
+                  scheduled_backend.bytes, scheduled_backend.reads)
+        full_state = full.read_game_state()
+        state = scheduled.read_game_state()
+        if poll:  # The first poll reads everything in both modes
+            rows['full bytes'].append(full_backend.bytes - before[0])
+            rows['full reads'].append(full_backend.reads - before[1])
+            rows['sched bytes'].append(scheduled_backend.bytes - before[2])
+            rows['sched reads'].append(scheduled_backend.reads - before[3])
+
+        clock = full_state.game_clock
+        history[clock] = {name: getattr(full_state, name) for name in SECTIONS}
+        for name in SECTIONS:
+            age = state.ages[name]
+            worst[name] = max(worst[name], age)
+            served &= getattr(state, name) == history[clock - age][name]
+            within &= age <= schedule.policies[name].budget
+
+        sim.tick_n(REFRESH_FRAMES)
+        live.sync(poll % 250 + 2)
+    result = {key: statistics.mean(values) for key, values in rows.items()}
+    result['served'] = 'ok' if served else 'WRONG'
+    result['budget'] = 'ok' if within else 'EXCEEDED'
+    result['worst'] = worst
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Read schedule benchmark')
+    parser.add_argument('--polls', type=int, default=400, help='Polls per board')
+    parser.add_argument('--require-every', type=int, default=3,
+                        help='Polls between fresh-plant requests (0: never)')
+    args = parser.parse_args()
+
+    boards = [('early-wave', build_early_wave_board), ('melee', build_melee_board),
+              ('late-wave', build_late_wave_board)]
+    print(f"{'board':>10s} {'full B/poll':>11s} {'sched B/poll':>12s} {'ratio':>6s} "
+          f"{'full reads':>10s} {'sched reads':>11s} {'served':>6s} {'budget':>8s}")
+    for name, build in boards:
+        r = play(build, args.polls, args.require_every)
+        print(f"{name:>10s} {r['full bytes']:11.0f} {r['sched bytes']:12.0f} "
+              f"{r['full bytes'] / r['sched bytes']:5.1f}x {r['full reads']:10.1f} "
+              f"{r['sched reads']:11.1f} {r['served']:>6s} {r['budget']:>8s}")
+        print(f"{'':>10s} worst age (cs): "
+              + ', '.join(f"{section} {age}" for section, age in r['worst'].items()))
+
+
+if __name__ == '__main__':
+    main()
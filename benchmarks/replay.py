@@ -0,0 +1,220 @@
+"""
+Session Replay Benchmark
+Recording a game session to a log and replaying it through the decision stack
+
+Usage:
+    python -m benchmarks.replay [--waves 20] [--wave-frames 2500] [--optimizer rules|mcts]
+
+Records a session played by a GameSimulator on the early-wave board: a wave
+of zombies comes every --wave-frames frames, the bot's memory interface
+polls every 5 frames (the 50 ms BotConfig.refresh_rate) through a
+RecordingBackend over a live process image (benchmarks.incremental_read),
+and the optimizer's decisions are played on the board. Recorded wall time
+is game time.
+
+The log is then replayed through a ReplayBackend as fast as possible,
+running the bot's pipeline per poll: PVZMemoryInterface.get_game_state(),
+collect_all_items() and a decision every action_interval. Every replayed
+state and decision must match the recording. Faster than real time means
+the replay takes less wall time than the session's game time.
+
+The session is then recorded again with a second thread looking up plants
+through the interface's injector while the main thread polls, as the
+decision thread does while a StatePoller reads. Its reads land in the
+polls open at the time; the replay must still match that recording.
+"""
+
+import argparse
+import os
+import random
+import struct
+import tempfile
+import threading
+import time
+import zlib
+
+from config import BotConfig
+from data.offsets import Offset
+from engine.optimizer import ActionOptimizer, MCTSOptimizer, apply_action
+from main import PVZMemoryInterface
+from memory.recording import RecordingBackend, ReplayBackend
+from benchmarks.incremental_read import REFRESH_FRAMES, LiveImage
+from benchmarks.scenarios import LATE_WAVE_ZOMBIES, build_early_wave_board
+from benchmarks.state_read import BOARD, state_key
+
+
+# Sun collected per second of play (the simulator makes none)
+SUN_PER_SECOND = 50
+
+
+def make_optimizer(name: str, budget: float):
+    """The bot's optimizer for --optimizer"""
+    if name == 'mcts':
+        return MCTSOptimizer(time_budget=budget, reuse_tree=False)
+    return ActionOptimizer()
+
+
+def state_digest(state) -> int:
+    """Checksum of everything read_game_state() reads"""
+    return zlib.crc32(repr(state_key(state)).encode()) if state else 0
+
+
+def action_key(action):
+    """What a decision does, for comparing decisions"""
+    if action is None:
+        return None
+    return (action.action_type, action.plant_type, action.row, action.col)
+
+
+def look_up_plants(memory: PVZMemoryInterface, stop: threading.Event, seed: int) -> int:
+    """Find plants at random cells until stopped; the number of lookups"""
+    rng = random.Random(seed)
+    lookups = 0
+    while not stop.is_set():
+        memory.injector.find_plant(rng.randrange(5), rng.randrange(9))
+        lookups += 1
+        time.sleep(0)
+    return lookups
+
+
+def record_session(path: str, waves: int, wave_frames: int, decide_every: int,
+                   optimizer, seed: int = 0, threaded: bool = False) -> tuple:
+    """
+    Play and record a session
+
+    Args:
+        threaded: Look up plants on a second thread while recording
+
+    Returns:
+        (recorder, per-poll state digests, per-poll decisions, plant lookups)
+    """
+    rng = random.Random(seed)
+    sim = build_early_wave_board(seed=seed)
+    sim.sun = 150
+    live = LiveImage(sim, seed)
+    live.sync(1)
+    recorder = RecordingBackend(live.image, path, clock=lambda: sim.frame / 100)
+    memory = PVZMemoryInterface(recorder)
+    memory.attach()
+    stop = threading.Event()
+    lookups = []
+    if threaded:
+        thread = threading.Thread(target=lambda: lookups.append(look_up_plants(memory, stop, seed)))
+        thread.start()
+
+    digests, decisions = [], []
+    poll = 0
+    end = waves * wave_frames
+    while sim.frame < end:
+        state = memory.get_game_state()
+        memory.collect_all_items()
+        digests.append(state_digest(state))
+        action = None
+        if state is not None and poll % decide_every == 0:
+            action = optimizer.get_best_action(state)
+            if action is not None and not action.is_wait:
+                apply_action(sim, action)
+        decisions.append(action_key(action))
+
+        frame = sim.frame
+        sim.tick_n(REFRESH_FRAMES)
+        if sim.frame // 100 > frame // 100:
+            sim.sun += SUN_PER_SECOND
+        if sim.frame // wave_frames > frame // wave_frames and sim.frame < end:
+            sim.wave += 1
+            for _ in range(3 + sim.wave):
+                sim.spawn_zombie(rng.choice(LATE_WAVE_ZOMBIES[2:]), rng.randrange(5),
+                                 rng.uniform(750.0, 850.0))
+        live.sync(poll % 250 + 2)
+        live.image.write(BOARD + Offset.WAVE, struct.pack('<i', sim.wave))
+        poll += 1
+    if threaded:
+        stop.set()
+        thread.join()
+    memory.close()
+    return recorder, digests, decisions, sum(lookups)
+
+
+def replay_session(path: str, decide_every: int, optimizer) -> tuple:
+    """
+    Replay a session through the bot's pipeline as fast as possible
+
+    Returns:
+        (polls, wall seconds, read seconds, decide seconds, digests, decisions)
+    """
+    replay = ReplayBackend(path, speed=0)
+    memory = PVZMemoryInterface(replay)
+    memory.attach()
+    digests, decisions = [], []
+    read_time = decide_time = 0.0
+    start = time.perf_counter()
+    poll = 0
+    while not replay.finished:
+        t0 = time.perf_counter()
+        state = memory.get_game_state()
+        memory.collect_all_items()
+        t1 = time.perf_counter()
+        action = None
+        if state is not None and poll % decide_every == 0:
+            action = optimizer.get_best_action(state)
+        t2 = time.perf_counter()
+        read_time += t1 - t0
+        decide_time += t2 - t1
+        digests.append(state_digest(state))
+        decisions.append(action_key(action))
+        poll += 1
+    wall = time.perf_counter() - start
+    memory.close()
+    return poll, wall, read_time, decide_time, digests, decisions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Session recording and replay benchmark')
+    parser.add_argument('--waves', type=int, default=20, help='Waves in the session')
+    parser.add_argument('--wave-frames', type=int, default=2500, help='Frames between waves')
+    parser.add_argument('--optimizer', choices=('rules', 'mcts'), default='rules',
+                        help='Decision stack (BotConfig.use_mcts)')
+    parser.add_argument('--budget', type=float, default=BotConfig().mcts_time_budget,
+                        help='MCTS seconds per decision')
+    args = parser.parse_args()
+
+    config = BotConfig()
+    decide_every = max(1, round(config.action_interval / config.refresh_rate))
+    path = os.path.join(tempfile.mkdtemp(), 'session.pvzrec')
+
+    start = time.perf_counter()
+    recorder, digests, decisions, _ = record_session(
+        path, args.waves, args.wave_frames, decide_every,
+        make_optimizer(args.optimizer, args.budget))
+    record_s = time.perf_counter() - start
+    game_s = args.waves * args.wave_frames / 100
+    print(f"session: {args.waves} waves, {recorder.polls} polls, {game_s:.0f} s of game time "
+          f"(recorded in {record_s:.1f} s)")
+    print(f"log: {recorder.raw_bytes / 1e6:.1f} MB read, {os.path.getsize(path) / 1e6:.2f} MB "
+          f"on disk ({recorder.raw_bytes / os.path.getsize(path):.0f}x)")
+
+    polls, wall, read_s, decide_s, replay_digests, replay_decisions = replay_session(
+        path, decide_every, make_optimizer(args.optimizer, args.budget))
+    states_ok = replay_digests == digests
+    decisions_ok = replay_decisions == decisions
+    print(f"replay: {polls} polls in {wall:.2f} s ({game_s / wall:.1f}x real time), "
+          f"reads {read_s / polls * 1e6:.0f} us/poll, "
+          f"decisions {decide_s / polls * 1e6:.0f} us/poll")
+    print(f"states: {'identical' if states_ok else 'DIFFERENT'}, "
+          f"decisions: {'identical' if decisions_ok else 'DIFFERENT'}")
+    os.remove(path)
+
+    recorder, digests, decisions, lookups = record_session(
+        path, args.waves, args.wave_frames, decide_every,
+        make_optimizer(args.optimizer, args.budget), threaded=True)
+    polls, _, _, _, replay_digests, replay_decisions = replay_session(
+        path, decide_every, make_optimizer(args.optimizer, args.budget))
+    print(f"threaded: {lookups} plant lookups during {recorder.polls} polls, "
+          f"{polls} replayed, states: "
+          f"{'identical' if replay_digests == digests else 'DIFFERENT'}, decisions: "
+          f"{'identical' if replay_decisions == decisions else 'DIFFERENT'}")
+    os.remove(path)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,272 @@
+"""
+Benchmark Scenarios
+Reproducible boards shared by the benchmarks
+"""
+
+import random
+
+from data.plants import PlantType
+from data.zombies import ZombieType
+from data.projectiles import ProjectileType
+from data.constants import PEASHOOTER_ATTACK_INTERVAL
+from engine.simulator import GameSimulator
+
+
+# Plant layout per row for the late-wave board (column -> plant)
+LATE_WAVE_ROW = [
+    PlantType.GATLINGPEA,
+    PlantType.GATLINGPEA,
+    PlantType.GATLINGPEA,
+    PlantType.GATLINGPEA,
+    PlantType.GATLINGPEA,
+    PlantType.GATLINGPEA,
+    PlantType.GATLINGPEA,
+    PlantType.SNOW_PEA,
+    PlantType.WINTERMELON,
+]
+
+LATE_WAVE_ZOMBIES = [
+    ZombieType.GIGA_GARGANTUAR,
+    ZombieType.GARGANTUAR,
+    ZombieType.BUCKETHEAD,
+    ZombieType.FOOTBALL,
+    ZombieType.SCREENDOOR,
+    ZombieType.CONEHEAD,
+]
+
+
+def build_late_wave_board(zombies_per_row: int = 12, warmup_frames: int = 400,
+                          min_projectiles: int = 240, seed: int = 0) -> GameSimulator:
+    """
+    Build a pool board in a late-wave state
+
+    Every row holds a full gatling/melon battery, zombies are spread over the
+    right half of the lawn, and the board is stepped until the projectile
+    population has built up. A full pool battery sustains roughly 150
+    projectiles, so peas in flight are added on top to reach min_projectiles
+    (the density of a board with cob/gloom support firing as well).
+
+    Args:
+        zombies_per_row: Zombies spawned in each of the 6 rows
+        warmup_frames: Frames to simulate before returning
+        min_projectiles: Minimum projectile count of the returned board
+        seed: Random seed for zombie types and positions
+
+    Returns:
+        GameSimulator holding the board
+    """
+    rng = random.Random(seed)
+    sim = GameSimulator(sun=1_000_000, scene=2)
+    for row in range(6):
+        for col, plant_type in enumerate(LATE_WAVE_ROW):
+            sim.place_plant(plant_type, row, col)
+    for plant in sim.plants:
+        # Spread volleys out instead of every plant firing on the same frame
+        plant.attack_countdown = rng.randint(1, PEASHOOTER_ATTACK_INTERVAL)
+    for row in range(6):
+        for _ in range(zombies_per_row):
+            sim.spawn_zombie(rng.choice(LATE_WAVE_ZOMBIES), row, rng.uniform(750.0, 1100.0))
+
+    if warmup_frames:
+        # Warm up on the array path, which is much faster for this board
+        from engine.array_simulator import ArraySimulator
+        fast = ArraySimulator.from_simulator(sim)
+        fast.tick_n(warmup_frames)
+        sim = fast.to_simulator()
+
+    while len(sim.projectiles) < min_projectiles:
+        sim._create_projectile(ProjectileType.PEA, rng.randrange(6), rng.uniform(100.0, 700.0), -1)
+    return sim
+
+
+def build_melee_board(seed: int = 0) -> GameSimulator:
+    """
+    Build a day board where zombies are already chewing through plants
+
+    Plant HP is lowered so bites kill plants within the run, which exercises
+    the order-dependent bite/contact paths of the simulators.
+
+    Args:
+        seed: Random seed for zombie types and positions
+
+    Returns:
+        GameSimulator holding the board
+    """
+    rng = random.Random(seed)
+    sim = GameSimulator(sun=1_000_000, scene=0)
+    for row in range(5):
+        for col in range(6):
+            sim.place_plant(rng.choice([PlantType.PEASHOOTER, PlantType.REPEATER,
+                                        PlantType.SPLITPEA, PlantType.WALLNUT]), row, col)
+    for plant in sim.plants:
+        plant.health = rng.randint(1, 3)
+    for row in range(5):
+        for _ in range(6):
+            sim.spawn_zombie(rng.choice(LATE_WAVE_ZOMBIES), row, rng.uniform(60.0, 500.0))
+    return sim
+
+
+def build_collision_board(zombie_count: int, projectile_count: int,
+                          seed: int = 0) -> GameSimulator:
+    """
+    Build a pool board with given zombie and projectile populations
+
+    Plants are the late-wave battery, so every volley check runs, but the
+    populations are set directly: zombies spread over the right half of the
+    lawn and peas in flight over the whole lawn. Zombies are gargantuars so
+    the zombie count barely changes over a short run.
+
+    Args:
+        zombie_count: Zombies on the board
+        projectile_count: Projectiles in flight
+        seed: Random seed for positions
+
+    Returns:
+        GameSimulator holding the board
+    """
+    rng = random.Random(seed)
+    sim = GameSimulator(sun=1_000_000, scene=2)
+    for row in range(6):
+        for col, plant_type in enumerate(LATE_WAVE_ROW):
+            sim.place_plant(plant_type, row, col)
+    for plant in sim.plants:
+        plant.attack_countdown = rng.randint(1, PEASHOOTER_ATTACK_INTERVAL)
+    for _ in range(zombie_count):
+        sim.spawn_zombie(ZombieType.GIGA_GARGANTUAR, rng.randrange(6), rng.uniform(450.0, 800.0))
+    for _ in range(projectile_count):
+        sim._create_projectile(ProjectileType.PEA, rng.randrange(6), rng.uniform(100.0, 800.0), -1)
+    return sim
+
+
+def build_early_wave_board(zombies_per_row: int = 2, seed: int = 0) -> GameSimulator:
+    """
+    Build a day board early in a level
+
+    A few defenders per row and a handful of zombies still walking in from
+    beyond the right edge: most frames only move zombies, peas and
+    countdowns, as in long rollouts between waves.
+
+    Args:
+        zombies_per_row: Zombies spawned in each of the 5 rows
+        seed: Random seed for plants, zombie types and positions
+
+    Returns:
+        GameSimulator holding the board
+    """
+    rng = random.Random(seed)
+    sim = GameSimulator(sun=1_000_000, scene=0)
+    for row in range(5):
+        sim.place_plant(rng.choice([PlantType.PEASHOOTER, PlantType.SNOW_PEA]), row, 0)
+        sim.place_plant(rng.choice([PlantType.PEASHOOTER, PlantType.REPEATER]), row, 1)
+        sim.place_plant(PlantType.WALLNUT, row, 3)
+    for plant in sim.plants:
+        plant.attack_countdown = rng.randint(1, PEASHOOTER_ATTACK_INTERVAL)
+    for row in range(5):
+        for _ in range(zombies_per_row):
+            sim.spawn_zombie(rng.choice(LATE_WAVE_ZOMBIES[2:]), row, rng.uniform(750.0, 1000.0))
+    return sim
+
+
+def build_economy_board(zombies_per_row: int = 2, seed: int = 0) -> GameSimulator:
+    """
+    Build a day board saving sun behind wall-nuts
+
+    Sunflowers and a wall-nut in every row and a single peashooter: zombies
+    walk the whole lawn and then chew wall-nuts, so most lanes go hundreds
+    of frames between events.
+
+    Args:
+        zombies_per_row: Zombies spawned in each of the 5 rows
+        seed: Random seed for zombie types and positions
+
+    Returns:
+        GameSimulator holding the board
+    """
+    rng = random.Random(seed)
+    sim = GameSimulator(sun=1_000_000, scene=0)
+    for row in range(5):
+        sim.place_plant(PlantType.SUNFLOWER, row, 0)
+        sim.place_plant(PlantType.SUNFLOWER, row, 1)
+        sim.place_plant(PlantType.WALLNUT, row, 4)
+    sim.place_plant(PlantType.PEASHOOTER, 2, 2)
+    for row in range(5):
+        for _ in range(zombies_per_row):
+            sim.spawn_zombie(rng.choice(LATE_WAVE_ZOMBIES[2:]), row, rng.uniform(700.0, 900.0))
+    return sim
+
+
+# Seed cards of the decision states
+DECISION_DECK = [
+    PlantType.SUNFLOWER,
+    PlantType.PEASHOOTER,
+    PlantType.SNOW_PEA,
+    PlantType.WALLNUT,
+    PlantType.CHERRY_BOMB,
+    PlantType.JALAPENO,
+]
+
+DECISION_ZOMBIES = [
+    ZombieType.ZOMBIE,
+    ZombieType.CONEHEAD,
+    ZombieType.BUCKETHEAD,
+    ZombieType.FOOTBALL,
+    ZombieType.GARGANTUAR,
+]
+
+
+def build_decision_states(count: int = 12, seed: int = 0) -> list:
+    """
+    Build game states as read from memory, for judging optimizer decisions
+
+    Day boards at random points of a 20-wave level: some sunflowers and
+    defenders in the left columns, zombies anywhere from the house to the
+    right edge, and a deck where a card may be recharging. Together they
+    reach every phase of the StrategyPlanner.
+
+    Args:
+        count: Number of states
+        seed: Random seed
+
+    Returns:
+        List of (name, game.state.GameState)
+    """
+    from game.state import GameState, SeedInfo
+    from game.plant import PlantInfo
+    from game.zombie import ZombieInfo
+    from data.plants import PLANT_HP
+    from data.zombies import ZOMBIE_BASE_SPEED, ZOMBIE_HP_DATA
+
+    rng = random.Random(seed)
+    states = []
+    for n in range(count):
+        state = GameState(sun=rng.choice([50, 100, 150, 250, 400]), wave=rng.randint(1, 20),
+                          total_waves=20, game_clock=rng.randint(1000, 60000), scene=0)
+        for index, plant_type in enumerate(DECISION_DECK):
+            usable = rng.random() < 0.8
+            state.seeds.append(SeedInfo(index=index, type=plant_type,
+                                        recharge_countdown=0 if usable else 500,
+                                        recharge_time=750, usable=usable))
+
+        cells = [(row, col) for row in range(5) for col in range(6)]
+        for row, col in rng.sample(cells, rng.randint(3, 14)):
+            if col <= 1 and rng.random() < 0.6:
+                plant_type = PlantType.SUNFLOWER
+            else:
+                plant_type = rng.choice([PlantType.PEASHOOTER, PlantType.SNOW_PEA,
+                                         PlantType.REPEATER, PlantType.WALLNUT])
+            hp_max = PLANT_HP.get(plant_type, 300)
+            state.plants.append(PlantInfo(
+                index=len(state.plants), row=row, col=col, type=plant_type,
+                hp=rng.randint(hp_max // 5, hp_max), hp_max=hp_max, state=0,
+                shoot_countdown=rng.randint(1, PEASHOOTER_ATTACK_INTERVAL), effective=True))
+
+        for _ in range(rng.randint(2, 10)):
+            zombie_type = rng.choice(DECISION_ZOMBIES)
+            body_hp, armor_hp = ZOMBIE_HP_DATA.get(zombie_type, (270, 0))
+            state.zombies.append(ZombieInfo(
+                index=len(state.zombies), row=rng.randrange(5), x=rng.uniform(120.0, 800.0),
+                y=0.0, type=zombie_type, hp=body_hp, hp_max=body_hp, accessory_hp=armor_hp,
+                state=0, speed=ZOMBIE_BASE_SPEED.get(zombie_type, 0.23), slow_countdown=0,
+                freeze_countdown=0, butter_countdown=0, at_wave=state.wave))
+        states.append((f"state-{n:02d}", state))
+    return states
@@ -0,0 +1,110 @@
+"""
+Simulator Benchmark
+Compares the object (GameSimulator) and struct-of-arrays (ArraySimulator) paths
+
+Usage:
+    python -m benchmarks.simulator [--frames N] [--repeats N]
+
+Checks that both paths produce identical boards frame by frame, then reports
+frames per second on a late-wave board (70 zombies, 200+ projectiles).
+"""
+
+import argparse
+import time
+
+from engine.simulator import GameSimulator
+from engine.array_simulator import ArraySimulator
+from benchmarks.scenarios import build_late_wave_board, build_melee_board
+
+
+def board_signature(sim: GameSimulator) -> tuple:
+    """Comparable summary of every live entity on a board"""
+    plants = tuple(
+        (p.id, int(p.type), p.row, p.col, p.health, p.attack_countdown, p.is_alive)
+        for p in sim.plants
+    )
+    zombies = tuple(
+        (z.id, int(z.type), z.row, z.x, z.body_health, z.armor_health, z.shield_health,
+         z.is_slowed, z.slow_countdown, z.is_frozen, z.freeze_countdown,
+         z.is_eating, z.eat_countdown, z.target_plant_id)
+        for z in sim.zombies if z.is_alive
+    )
+    projectiles = tuple(
+        (p.id, int(p.type), p.row, p.x, p.damage, p.source_plant_id)
+        for p in sim.projectiles if p.is_alive
+    )
+    grid = tuple(sorted(sim._plant_grid.items()))
+    return (sim.frame, sim.sun, sim.is_game_over, grid, plants, zombies, projectiles)
+
+
+def check_equivalence(board: GameSimulator, frames: int) -> int:
+    """
+    Step both paths from the same board and compare after every frame
+
+    Returns:
+        Frame at which the boards first differ, or -1 if they never do
+    """
+    reference = board.clone()
+    fast = ArraySimulator.from_simulator(board)
+    for _ in range(frames):
+        reference.tick()
+        fast.tick()
+        if board_signature(reference) != board_signature(fast.to_simulator()):
+            return reference.frame
+    return -1
+
+
+def measure_fps(builders: dict, board: GameSimulator, frames: int, repeats: int) -> dict:
+    """
+    Measure frames per second of several simulators on the same board
+
+    Runs are interleaved so that machine noise hits every path alike, and
+    the fastest run of each path is reported.
+
+    Args:
+        builders: Name -> function building a fresh simulator from the board (not timed)
+        board: Starting board
+        frames: Frames per run
+        repeats: Runs per path
+
+    Returns:
+        Name -> frames per second
+    """
+    best = {name: float('inf') for name in builders}
+    for _ in range(repeats):
+        for name, build in builders.items():
+            sim = build(board)
+            start = time.perf_counter()
+            sim.tick_n(frames)
+            best[name] = min(best[name], time.perf_counter() - start)
+    return {name: frames / elapsed for name, elapsed in best.items()}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='GameSimulator vs ArraySimulator benchmark')
+    parser.add_argument('--frames', type=int, default=60, help='Frames per timed run')
+    parser.add_argument('--repeats', type=int, default=10, help='Timed runs per path')
+    parser.add_argument('--check-frames', type=int, default=600, help='Frames compared per board')
+    args = parser.parse_args()
+
+    for name, board in (('late-wave', build_late_wave_board(min_projectiles=0)),
+                        ('melee', build_melee_board())):
+        diverged = check_equivalence(board, args.check_frames)
+        status = 'identical' if diverged < 0 else f'DIVERGED at frame {diverged}'
+        print(f"equivalence [{name}, {args.check_frames} frames]: {status}")
+
+    board = build_late_wave_board()
+    print(f"board: {board.alive_zombie_count} zombies, {len(board.projectiles)} projectiles, "
+          f"{board.alive_plant_count} plants")
+
+    fps = measure_fps({
+        'GameSimulator': lambda b: b.clone(),
+        'ArraySimulator': ArraySimulator.from_simulator,
+    }, board, args.frames, args.repeats)
+    for name, value in fps.items():
+        print(f"{name + ':':16s}{value:10.0f} frames/s")
+    print(f"{'speedup:':16s}{fps['ArraySimulator'] / fps['GameSimulator']:10.1f}x")
+
+
+if __name__ == '__main__':
+    main()
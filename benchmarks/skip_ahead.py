@@ -0,0 +1,94 @@
+"""
+Skip-Ahead Benchmark
+Frame-by-frame tick_n() against event skip-ahead (advance_to_next_event)
+
+Usage:
+    python -m benchmarks.skip_ahead [--frames N] [--repeats N]
+
+Both modes are first checked for identical boards at regular intervals on
+every scenario, then timed over a long rollout. Speedup depends on how far
+apart events are: quiet lanes skip hundreds of frames at a time, while a
+late-wave board has an event nearly every frame and falls back to ticking.
+"""
+
+import argparse
+import time
+
+from engine.simulator import GameSimulator
+from benchmarks.scenarios import (
+    build_economy_board,
+    build_early_wave_board,
+    build_late_wave_board,
+    build_melee_board,
+)
+from benchmarks.simulator import board_signature
+
+
+SCENARIOS = [
+    ('economy', build_economy_board),
+    ('early-wave', build_early_wave_board),
+    ('melee', build_melee_board),
+    ('late-wave', build_late_wave_board),
+]
+
+
+def check_equivalence(board: GameSimulator, frames: int, interval: int = 25) -> int:
+    """
+    Step both modes from the same board and compare every interval frames
+
+    Returns:
+        Frame at which the boards first differ, or -1 if they never do
+    """
+    reference, skipping = board.clone(), board.clone()
+    for frame in range(interval, frames + 1, interval):
+        reference.tick_n(interval)
+        skipping.tick_n(interval, skip_ahead=True)
+        if board_signature(reference) != board_signature(skipping):
+            return frame
+    return -1
+
+
+def time_rollout(board: GameSimulator, frames: int, repeats: int, skip_ahead: bool) -> float:
+    """Best time of a rollout in milliseconds"""
+    best = float('inf')
+    for _ in range(repeats):
+        sim = board.clone()
+        start = time.perf_counter()
+        sim.tick_n(frames, skip_ahead=skip_ahead)
+        best = min(best, time.perf_counter() - start)
+    return best * 1e3
+
+
+def mean_jump(board: GameSimulator, frames: int) -> float:
+    """Average frames advanced per advance_to_next_event() call"""
+    sim = board.clone()
+    calls = 0
+    done = 0
+    while done < frames and not sim.is_game_over:
+        done += sim.advance_to_next_event(frames - done)
+        calls += 1
+    return done / max(calls, 1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Event skip-ahead benchmark')
+    parser.add_argument('--frames', type=int, default=3000, help='Frames per rollout')
+    parser.add_argument('--repeats', type=int, default=3, help='Timed runs per mode')
+    parser.add_argument('--check-frames', type=int, default=1500, help='Frames compared')
+    args = parser.parse_args()
+
+    print(f"{'board':>11s} {'check':>10s} {'tick_n ms':>10s} {'skip ms':>9s} "
+          f"{'speedup':>8s} {'frames/jump':>12s}")
+    for name, build in SCENARIOS:
+        board = build()
+        frames = args.frames if name != 'late-wave' else args.frames // 10
+        diverged = check_equivalence(board, args.check_frames if name != 'late-wave' else 300)
+        status = 'identical' if diverged < 0 else f'DIVERGED@{diverged}'
+        ticked = time_rollout(board, frames, args.repeats, skip_ahead=False)
+        skipped = time_rollout(board, frames, args.repeats, skip_ahead=True)
+        print(f"{name:>11s} {status:>10s} {ticked:10.1f} {skipped:9.1f} "
+              f"{ticked / skipped:7.1f}x {mean_jump(board, frames):12.1f}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,113 @@
+"""
+Snapshot Benchmark
+Cost of GameSimulator.snapshot() / restore() / clone() against deepcopy
+
+Usage:
+    python -m benchmarks.snapshot [--repeats N]
+
+The deepcopy versions the packed snapshots replaced are kept here as the
+reference. Correctness: one snapshot is restored several times, each copy
+is played forward with the same actions, and every copy must match a board
+that was never snapshotted.
+"""
+
+import argparse
+import copy
+import time
+
+from data.plants import PlantType
+from data.zombies import ZombieType
+from engine.simulator import GameSimulator
+from benchmarks.scenarios import build_late_wave_board
+from benchmarks.simulator import board_signature
+
+
+def deepcopy_clone(sim: GameSimulator) -> GameSimulator:
+    """Clone by deep-copying every entity twice, as snapshot() + restore() used to (reference)"""
+    new_sim = GameSimulator(sun=sim.sun, scene=sim.scene)
+    new_sim.frame = sim.frame
+    new_sim.wave = sim.wave
+    new_sim.plants = copy.deepcopy(copy.deepcopy(sim.plants))
+    new_sim.zombies = copy.deepcopy(copy.deepcopy(sim.zombies))
+    new_sim.projectiles = copy.deepcopy(copy.deepcopy(sim.projectiles))
+    new_sim._plant_grid = dict(sim._plant_grid)
+    new_sim._row_count = sim._row_count
+    new_sim._next_plant_id = sim._next_plant_id
+    new_sim._next_zombie_id = sim._next_zombie_id
+    new_sim._next_projectile_id = sim._next_projectile_id
+    return new_sim
+
+
+def play(sim: GameSimulator, frames: int) -> GameSimulator:
+    """Apply a fixed action script while ticking"""
+    for frame in range(frames):
+        if frame % 50 == 0:
+            sim.spawn_zombie(ZombieType.CONEHEAD, frame // 50 % 5, 700.0)
+            sim.place_plant(PlantType.PEASHOOTER, frame // 50 % 5, 8)
+        sim.tick()
+    return sim
+
+
+def check_restores(board: GameSimulator, copies: int, frames: int) -> bool:
+    """Restore one snapshot several times and compare each copy against a fresh clone"""
+    expected = board_signature(play(deepcopy_clone(board), frames))
+    state = board.snapshot()
+    sim = GameSimulator(scene=board.scene)
+    sim._row_count = board._row_count
+    for _ in range(copies):
+        sim.restore(state)
+        if board_signature(play(sim, frames)) != expected:
+            return False
+        # Clones of a restored board share its records until they are unpacked
+        sim.restore(state)
+        if board_signature(play(sim.clone().clone(), frames)) != expected:
+            return False
+    return True
+
+
+def time_call(fn, repeats: int, inner: int = 20) -> float:
+    """Best time per call in microseconds"""
+    best = float('inf')
+    for _ in range(repeats):
+        start = time.perf_counter()
+        for _ in range(inner):
+            fn()
+        best = min(best, time.perf_counter() - start)
+    return best / inner * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Snapshot / restore / clone benchmark')
+    parser.add_argument('--repeats', type=int, default=5, help='Timed runs per operation')
+    parser.add_argument('--check-frames', type=int, default=300, help='Frames played per copy')
+    args = parser.parse_args()
+
+    board = build_late_wave_board()
+    status = 'identical' if check_restores(board, 3, args.check_frames) else 'DIVERGED'
+    print(f"equivalence [late-wave, 3 restores of one snapshot, {args.check_frames} frames]: {status}")
+    print(f"board: {board.alive_zombie_count} zombies, {len(board.projectiles)} projectiles, "
+          f"{board.alive_plant_count} plants")
+
+    state = board.snapshot()
+    sim = board.clone()
+
+    def restore_and_unpack():
+        sim.restore(state)
+        sim.plants
+
+    restored = GameSimulator()
+    restored.restore(state)
+    timings = [
+        ('deepcopy clone', time_call(lambda: deepcopy_clone(board), args.repeats, inner=3)),
+        ('snapshot', time_call(board.snapshot, args.repeats)),
+        ('restore', time_call(lambda: sim.restore(state), args.repeats)),
+        ('restore + unpack', time_call(restore_and_unpack, args.repeats)),
+        ('clone', time_call(board.clone, args.repeats)),
+        ('clone of restored', time_call(restored.clone, args.repeats)),
+    ]
+    for name, us in timings:
+        print(f"{name:>18s}: {us:9.1f} us")
+
+
+if __name__ == '__main__':
+    main()
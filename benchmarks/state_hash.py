@@ -0,0 +1,156 @@
+"""
+State Hash Benchmark
+Incremental GameSimulator.state_hash and transposition table sharing
+
+Usage:
+    python -m benchmarks.state_hash [--repeats N]
+
+Checks that the incrementally kept hash always equals one summed from
+scratch while random actions, skip-ahead, snapshots and restores are played.
+Then times a full hash pass (the first read after a tick) against hashing a
+child board after one action, and counts how many evaluations a two-move
+search shares through a TranspositionTable when moves played in either
+order reach the same board.
+"""
+
+import argparse
+import itertools
+import random
+import time
+
+from data.plants import PlantType, PLANT_COST
+from data.zombies import ZombieType
+from engine.simulator import GameSimulator
+from engine.transposition import TranspositionTable
+from benchmarks.scenarios import build_early_wave_board, build_late_wave_board, build_melee_board
+
+
+ACTION_PLANTS = [PlantType.PEASHOOTER, PlantType.SNOW_PEA, PlantType.REPEATER, PlantType.WALLNUT]
+
+
+def fresh_hash(sim: GameSimulator) -> int:
+    """Hash of a board summed from scratch"""
+    copy = sim.clone()
+    copy.invalidate_hash()
+    return copy.state_hash
+
+
+def check_incremental(board: GameSimulator, frames: int, seed: int = 0) -> int:
+    """
+    Play random actions and compare the kept hash against a fresh one
+
+    Returns:
+        Frame at which the hashes first differ, or -1 if they never do
+    """
+    rng = random.Random(seed)
+    sim = board.clone()
+    sim.state_hash
+    saved = sim.snapshot()
+    for frame in range(0, frames, 10):
+        kind = rng.randrange(6)
+        row, col = rng.randrange(sim._row_count), rng.randrange(9)
+        if kind == 0:
+            sim.place_plant(rng.choice(ACTION_PLANTS), row, col)
+        elif kind == 1:
+            sim.remove_plant(row, col)
+        elif kind == 2:
+            sim.spawn_zombie(ZombieType.CONEHEAD, row, rng.uniform(300.0, 800.0))
+        elif kind == 3:
+            sim.restore(saved)
+        elif kind == 4:
+            saved = sim.snapshot()
+        sim.tick_n(10, skip_ahead=rng.random() < 0.5)
+        if sim.state_hash != fresh_hash(sim):
+            return frame + 10
+    return -1
+
+
+def time_call(fn, repeats: int, inner: int = 50) -> float:
+    """Best time per call in microseconds"""
+    best = float('inf')
+    for _ in range(repeats):
+        start = time.perf_counter()
+        for _ in range(inner):
+            fn()
+        best = min(best, time.perf_counter() - start)
+    return best / inner * 1e6
+
+
+def time_hashing(board: GameSimulator, repeats: int):
+    """
+    Cost of a full hash pass and of an action on a hashed board
+
+    Returns:
+        (tick us, full hash us, action + hash us)
+    """
+    sim = board.clone()
+    sim.state_hash
+    plant = next(p for p in sim.plants if p.is_alive)
+    plant_type, row, col = plant.type, plant.row, plant.col
+
+    def full_hash():
+        sim.invalidate_hash()
+        sim.state_hash
+
+    def action_and_hash():
+        # Shovel and replant the same cell, so the board stays alike
+        sim.remove_plant(row, col)
+        sim.sun += PLANT_COST.get(plant_type, 100)
+        sim.place_plant(plant_type, row, col)
+        sim.state_hash
+
+    ticking = board.clone()
+    return (time_call(ticking.tick, repeats), time_call(full_hash, repeats),
+            time_call(action_and_hash, repeats))
+
+
+def two_move_search(board: GameSimulator, cells: int, frames: int, table: TranspositionTable):
+    """
+    Evaluate every ordered pair of plantings, sharing results by board hash
+
+    Returns:
+        (leaf count, evaluations run)
+    """
+    moves = [(ACTION_PLANTS[i % len(ACTION_PLANTS)], i % board._row_count, 8 - i // board._row_count)
+             for i in range(cells)]
+    leaves = evaluations = 0
+    for first, second in itertools.permutations(moves, 2):
+        sim = board.clone()
+        sim.remove_plant(first[1], first[2])
+        sim.place_plant(*first)
+        sim.remove_plant(second[1], second[2])
+        sim.place_plant(*second)
+        leaves += 1
+        key = sim.state_hash
+        if table.lookup(key) is None:
+            sim.tick_n(frames)
+            table.store(key, sim.alive_zombie_count)
+            evaluations += 1
+    return leaves, evaluations
+
+
+def main():
+    parser = argparse.ArgumentParser(description='State hash benchmark')
+    parser.add_argument('--repeats', type=int, default=5, help='Timed runs per operation')
+    parser.add_argument('--check-frames', type=int, default=600, help='Frames compared')
+    args = parser.parse_args()
+
+    boards = [('early-wave', build_early_wave_board), ('melee', build_melee_board),
+              ('late-wave', build_late_wave_board)]
+    print(f"{'board':>10s} {'check':>9s} {'tick us':>9s} {'full hash us':>13s} "
+          f"{'action + hash us':>17s}")
+    for name, build in boards:
+        board = build()
+        diverged = check_incremental(board, args.check_frames)
+        status = 'identical' if diverged < 0 else f'DIVERGED@{diverged}'
+        tick, full, action = time_hashing(board, args.repeats)
+        print(f"{name:>10s} {status:>9s} {tick:9.1f} {full:13.1f} {action:17.1f}")
+
+    table = TranspositionTable(capacity=4096)
+    leaves, evaluations = two_move_search(build_melee_board(), cells=8, frames=50, table=table)
+    print(f"two-move search [melee, 8 cells]: {leaves} leaves, {evaluations} evaluations, "
+          f"hit rate {table.hit_rate:.0%}")
+
+
+if __name__ == '__main__':
+    main()
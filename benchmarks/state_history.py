@@ -0,0 +1,166 @@
+"""
+State History Benchmark
+Memory of a rolling state history as GameStates and as StateSnapshots, and diff time
+
+Usage:
+    python -m benchmarks.state_history [--polls N]
+
+The late-wave and melee boards are played by a GameSimulator and followed
+by a live process image (benchmarks.incremental_read), polled every 5
+frames. Every poll is kept in three histories: the GameStates of a plain
+GameReader, those of an incremental one (unchanged entities are shared
+with the previous state), and StateSnapshots of the plain reads. Memory
+is the size of everything a history holds, each object counted once,
+per retained state.
+
+diff() of every two consecutive snapshots is timed against the same
+comparison done on the two GameStates' entity objects ("objects"); both
+must report the same appearances, deaths, HP changes and jumps.
+"""
+
+import argparse
+import gc
+import statistics
+import sys
+import time
+import types
+
+from game.reader import GameReader
+from game.snapshot import JUMP_SLACK, StateSnapshot, diff
+from memory.reader import MemoryReader
+from benchmarks.incremental_read import REFRESH_FRAMES, LiveImage
+from benchmarks.scenarios import build_late_wave_board, build_melee_board
+
+
+_NOT_HELD = (type, types.ModuleType, types.FunctionType, types.BuiltinFunctionType)
+
+
+def deep_size(roots: list) -> int:
+    """Bytes of every object reachable from roots, each counted once (classes excluded)"""
+    seen = set()
+    pending = list(roots)
+    size = 0
+    while pending:
+        obj = pending.pop()
+        if id(obj) in seen or isinstance(obj, _NOT_HELD):
+            continue
+        seen.add(id(obj))
+        size += sys.getsizeof(obj)
+        pending.extend(gc.get_referents(obj))
+    return size
+
+
+def object_diff(prev, cur) -> tuple:
+    """diff() done on two GameStates' entity objects; what it reports, comparable"""
+    elapsed = cur.game_clock - prev.game_clock
+    before = {(z.index, z.type): z for z in prev.alive_zombies}
+    after = {(z.index, z.type): z for z in cur.alive_zombies}
+    hp, jumps = [], []
+    for key, z in after.items():
+        o = before.get(key)
+        if o is None:
+            continue
+        if o.hp + o.accessory_hp != z.hp + z.accessory_hp:
+            hp.append(('zombie', z.index, o.hp + o.accessory_hp, z.hp + z.accessory_hp))
+        if o.row != z.row or abs(z.x - o.x) > abs(o.speed) * max(elapsed, 0) + JUMP_SLACK:
+            jumps.append((z.index, z.row, z.x))
+    zombies = (sorted(after.keys() - before.keys()), sorted(before.keys() - after.keys()))
+
+    before = {(p.index, p.row, p.col, p.type): p for p in prev.alive_plants}
+    after = {(p.index, p.row, p.col, p.type): p for p in cur.alive_plants}
+    for key, p in after.items():
+        o = before.get(key)
+        if o is not None and o.hp != p.hp:
+            hp.append(('plant', p.index, o.hp, p.hp))
+    plants = (sorted(after.keys() - before.keys()), sorted(before.keys() - after.keys()))
+    return zombies, plants, hp, jumps
+
+
+def reported(d) -> tuple:
+    """What a StateDiff reports, comparable with object_diff()"""
+    zombies = (sorted((z.index, z.type) for z in d.zombies_appeared),
+               sorted((z.index, z.type) for z in d.zombies_died))
+    plants = (sorted((p.index, p.row, p.col, p.type) for p in d.plants_appeared),
+              sorted((p.index, p.row, p.col, p.type) for p in d.plants_died))
+    hp = [(c.kind, c.index, c.before, c.after) for c in d.hp_changes]
+    return zombies, plants, hp, [(j.index, j.row, j.x) for j in d.jumps]
+
+
+def time_pairs(fn, history: list, repeats: int = 3) -> float:
+    """Best mean microseconds of fn over every two consecutive states of a history"""
+    pairs = list(zip(history, history[1:]))
+    best = float('inf')
+    for _ in range(repeats):
+        start = time.perf_counter()
+        for prev, cur in pairs:
+            fn(prev, cur)
+        best = min(best, (time.perf_counter() - start) / len(pairs) * 1e6)
+    return best
+
+
+def play(build, polls: int) -> dict:
+    """Keep the three histories of one game; memory per state and per-poll times"""
+    sim = build()
+    live = LiveImage(sim)
+    live.sync(1)
+    plain = GameReader(MemoryReader(backend=live.image))
+    incremental = GameReader(MemoryReader(backend=live.image), incremental=True)
+
+    histories = {'plain': [], 'incremental': [], 'snapshots': []}
+    entities = []
+    for poll in range(polls):
+        state = plain.read_game_state()
+        histories['plain'].append(state)
+        histories['incremental'].append(incremental.read_game_state())
+        entities.append(len(state.alive_zombies) + len(state.alive_plants))
+        sim.tick_n(REFRESH_FRAMES)
+        live.sync(poll % 250 + 2)
+
+    states, snapshots = histories['plain'], []
+    start = time.perf_counter()
+    for state in states:
+        snapshots.append(StateSnapshot.of(state))
+    result = {'entities': statistics.mean(entities),
+              'snap us': (time.perf_counter() - start) / len(states) * 1e6,
+              'diff us': time_pairs(diff, snapshots),
+              'objects us': time_pairs(object_diff, states)}
+    histories['snapshots'] = snapshots
+
+    events = {'appeared': 0, 'died': 0, 'hp': 0, 'jumps': 0}
+    same = True
+    for (prev, cur), (prev_state, state) in zip(zip(snapshots, snapshots[1:]),
+                                                zip(states, states[1:])):
+        d = diff(prev, cur)
+        same &= reported(d) == object_diff(prev_state, state)
+        events['appeared'] += len(d.zombies_appeared) + len(d.plants_appeared)
+        events['died'] += len(d.zombies_died) + len(d.plants_died)
+        events['hp'] += len(d.hp_changes)
+        events['jumps'] += len(d.jumps)
+    for name, history in histories.items():
+        for state in history if name != 'snapshots' else ():
+            state._index = None  # Count the state as read, not its query index
+        result[name] = deep_size(history) / len(history)
+    result['events'] = events
+    result['check'] = 'identical' if same else 'DIFFERENT'
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description='State history benchmark')
+    parser.add_argument('--polls', type=int, default=200, help='Polls (retained states) per board')
+    args = parser.parse_args()
+
+    boards = [('late-wave', build_late_wave_board), ('melee', build_melee_board)]
+    print(f"{'board':>10s} {'entities':>8s} {'plain B':>9s} {'incr B':>9s} {'snap B':>8s} "
+          f"{'ratio':>6s} {'snap us':>8s} {'diff us':>8s} {'objects us':>10s} {'reports':>9s}")
+    for name, build in boards:
+        r = play(build, args.polls)
+        print(f"{name:>10s} {r['entities']:8.0f} {r['plain']:9.0f} {r['incremental']:9.0f} "
+              f"{r['snapshots']:8.0f} {r['plain'] / r['snapshots']:5.1f}x {r['snap us']:8.1f} "
+              f"{r['diff us']:8.1f} {r['objects us']:10.1f} {r['check']:>9s}")
+        print(f"{'':>10s} per diff: " + ', '.join(
+            f"{kind} {count / (args.polls - 1):.1f}" for kind, count in r['events'].items()))
+
+
+if __name__ == '__main__':
+    main()
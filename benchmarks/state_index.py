@@ -0,0 +1,138 @@
+"""
+State Index Benchmark
+Analysis cost per game state with GameState's query index against list filtering
+
+Usage:
+    python -m benchmarks.state_index [--repeats N]
+
+Each state goes through what one decision runs on it: ThreatAnalyzer,
+ResourceAnalyzer and DefenseAnalyzer, EmergencyHandler.check(),
+StateEncoder.encode() (a new encoder, so no line is reused) and
+ActionOptimizer.get_best_action(). The states are the decision states of
+benchmarks.scenarios and the early-wave, melee and late-wave boards read
+from a process image.
+
+"lists" is GameState as it was before the index: every query filters the
+entity lists again. Decisions on both must be the same.
+"""
+
+import argparse
+import time
+from dataclasses import fields
+
+from data.offsets import SceneType
+from engine.analyzer import DefenseAnalyzer, ResourceAnalyzer, ThreatAnalyzer
+from engine.optimizer import ActionOptimizer
+from game.reader import GameReader
+from game.state import GameState
+from llm.emergency import EmergencyHandler
+from llm.encoder import StateEncoder
+from memory.reader import MemoryReader
+from benchmarks.scenarios import (
+    build_decision_states, build_early_wave_board, build_late_wave_board, build_melee_board,
+)
+from benchmarks.state_read import build_image
+
+
+class ListState(GameState):
+    """GameState whose queries filter the entity lists on every call"""
+
+    @property
+    def alive_zombies(self):
+        return [z for z in self.zombies if z.hp > 0]
+
+    @property
+    def alive_plants(self):
+        return [p for p in self.plants if p.hp > 0]
+
+    @property
+    def zombie_count(self):
+        return len(self.alive_zombies)
+
+    @property
+    def plant_count(self):
+        return len(self.alive_plants)
+
+    def get_zombies_in_row(self, row):
+        return [z for z in self.alive_zombies if z.row == row]
+
+    def get_closest_zombie_in_row(self, row):
+        row_zombies = self.get_zombies_in_row(row)
+        return min(row_zombies, key=lambda z: z.x) if row_zombies else None
+
+    def get_zombies_by_type(self, zombie_type):
+        return [z for z in self.alive_zombies if z.type == zombie_type]
+
+    def get_plants_in_row(self, row):
+        return [p for p in self.alive_plants if p.row == row]
+
+    def get_plants_by_type(self, plant_type):
+        return [p for p in self.alive_plants if p.type == plant_type]
+
+    def get_row_threat(self, row):
+        return sum(z.threat_level for z in self.get_zombies_in_row(row))
+
+    def get_ready_cobs(self):
+        return [p for p in self.alive_plants if p.is_cob_cannon and p.cob_ready]
+
+    def can_fire_cob(self):
+        return self.click_pao_countdown <= 0 and len(self.get_ready_cobs()) > 0
+
+
+def copy_state(state: GameState, cls: type) -> GameState:
+    """A new state of class cls with the same fields (and no index built yet)"""
+    return cls(**{f.name: getattr(state, f.name) for f in fields(state) if f.init})
+
+
+def analyze(state: GameState) -> tuple:
+    """One decision's analysis of a state; the decision"""
+    ThreatAnalyzer(state).analyze()
+    ResourceAnalyzer(state).analyze()
+    defense = DefenseAnalyzer(state)
+    for row in range(SceneType.get_row_count(state.scene)):
+        defense.get_defense_score(row)
+    EmergencyHandler().check(state)
+    StateEncoder().encode(state)
+    action = ActionOptimizer().get_best_action(state)
+    return (action.action_type, action.plant_type, action.row, action.col)
+
+
+def read_board(build) -> GameState:
+    """The state of a benchmark board as read from its process image"""
+    return GameReader(MemoryReader(backend=build_image(build(), 0.0))).read_game_state()
+
+
+def time_states(states: list, cls: type, repeats: int) -> tuple:
+    """(best microseconds per state, decisions) over fresh copies of the states"""
+    best = float('inf')
+    decisions = None
+    for _ in range(repeats):
+        copies = [copy_state(state, cls) for state in states]
+        start = time.perf_counter()
+        decisions = [analyze(state) for state in copies]
+        best = min(best, (time.perf_counter() - start) / len(states) * 1e6)
+    return best, decisions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='GameState query index benchmark')
+    parser.add_argument('--repeats', type=int, default=5, help='Timed runs per state set')
+    args = parser.parse_args()
+
+    state_sets = [('decision', [state for _, state in build_decision_states()]),
+                  ('early-wave', [read_board(build_early_wave_board)]),
+                  ('melee', [read_board(build_melee_board)]),
+                  ('late-wave', [read_board(build_late_wave_board)])]
+    print(f"{'states':>10s} {'entities':>8s} {'lists us':>9s} {'index us':>9s} {'speedup':>7s} "
+          f"{'decisions':>9s}")
+    for name, states in state_sets:
+        entities = sum(len(s.alive_zombies) + len(s.alive_plants) for s in states) / len(states)
+        list_us, list_decisions = time_states(states, ListState, args.repeats)
+        index_us, index_decisions = time_states(states, GameState, args.repeats)
+        check = 'identical' if list_decisions == index_decisions else 'DIFFERENT'
+        print(f"{name:>10s} {entities:8.0f} {list_us:9.1f} {index_us:9.1f} "
+              f"{list_us / index_us:6.2f}x {check:>9s}")
+
+
+if __name__ == '__main__':
+    main()
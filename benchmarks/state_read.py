@@ -0,0 +1,296 @@
+"""
+State Read Benchmark
+Reads and latency of GameReader.read_game_state() against per-field reads
+
+Usage:
+    python -m benchmarks.state_read [--repeats N] [--dead-share 0.25]
+
+Each benchmark board is laid out as a PVZ process image (ImageBackend): the
+base pointer, the board's arrays with a share of dead slots between live
+records, and random bytes wherever the reader does not look. GameReader
+reads each entity array with one read and decodes it with RecordLayout;
+the per-field reader it replaced, kept here as the reference, reads every
+field and dead flag on its own. Both must return the same state.
+
+Reads against the in-process image cost a function call; against a game
+they cost a syscall each. The "syscall" column pays one ProcMemBackend
+read of this process's own memory per read, as reading the game under
+Wine (or ReadProcessMemory on Windows) does.
+"""
+
+import argparse
+import ctypes
+import os
+import random
+import struct
+import time
+
+from data.offsets import Offset
+from data.plants import PLANT_HP
+from engine.simulator import GameSimulator
+from game.reader import (
+    GameReader, RecordLayout, ZOMBIE_LAYOUT, PLANT_LAYOUT, PROJECTILE_LAYOUT,
+    LAWNMOWER_LAYOUT, PLACE_ITEM_LAYOUT, SEED_LAYOUT, BOARD_ARRAYS_LAYOUT, BOARD_SCALARS_LAYOUT,
+)
+from memory.backend import MemoryBackend, ImageBackend, ProcMemBackend
+from memory.reader import MemoryReader
+from benchmarks.scenarios import (
+    DECISION_DECK, build_early_wave_board, build_late_wave_board, build_melee_board,
+)
+
+
+# Where the image puts the game's objects
+PVZ_BASE = 0x02000000
+BOARD = 0x03000000
+ARRAY_STRIDE = 0x00100000
+ARRAYS_START = 0x04000000
+
+
+# ============================================================================
+# Process Image
+# ============================================================================
+
+def random_record(layout: RecordLayout, rng: random.Random) -> bytearray:
+    """A record of random bytes with plausible values in the decoded fields"""
+    record = bytearray(rng.randbytes(layout.span))
+    for _, offset, code in layout.fields:
+        if code == 'f':
+            struct.pack_into('<f', record, offset, rng.uniform(-100.0, 900.0))
+        elif code == '?':
+            record[offset] = rng.random() < 0.5
+        else:
+            struct.pack_into('<i', record, offset, rng.randint(-1, 3000))
+    return record
+
+
+def pack_array(layout: RecordLayout, records: list, dead_share: float,
+               rng: random.Random) -> tuple:
+    """
+    Lay records out as a game array with dead slots between them
+
+    Args:
+        layout: Record layout
+        records: {field name: value} of each live record
+        dead_share: Share of slots that are dead
+
+    Returns:
+        (array bytes, slot count)
+    """
+    slots = []
+    for values in records:
+        while dead_share and rng.random() < dead_share:
+            slots.append(None)
+        slots.append(values)
+    data = bytearray(layout.array_bytes(len(slots)))
+    offsets = {name: (offset, code) for name, offset, code in layout.fields}
+    for i, values in enumerate(slots):
+        base = i * layout.size
+        record = random_record(layout, rng)
+        for name, value in (values or {}).items():
+            offset, code = offsets[name]
+            struct.pack_into('<' + code, record, offset, value)
+        # Write the record, then its dead flag, which may lie in the next slot
+        data[base:base + layout.size] = record[:layout.size]
+        if layout.dead_offset is not None:
+            data[base + layout.dead_offset] = values is None
+    return data, len(slots)
+
+
+def plant_record(plant) -> dict:
+    """Field values of a simulated plant"""
+    return {'row': plant.row, 'col': plant.col, 'type': int(plant.type), 'hp': plant.health,
+            'hp_max': PLANT_HP.get(plant.type, 300), 'shoot_countdown': plant.attack_countdown}
+
+
+def zombie_record(zombie) -> dict:
+    """Field values of a simulated zombie"""
+    return {'row': zombie.row, 'x': zombie.x, 'type': int(zombie.type), 'hp': zombie.body_health,
+            'accessory_hp': zombie.armor_health, 'slow_countdown': zombie.slow_countdown,
+            'freeze_countdown': zombie.freeze_countdown, 'is_eating': zombie.is_eating}
+
+
+def projectile_record(projectile) -> dict:
+    """Field values of a simulated projectile"""
+    return {'row': projectile.row, 'x': projectile.x, 'y': projectile.y,
+            'type': int(projectile.type)}
+
+
+def build_image(sim: GameSimulator, dead_share: float, seed: int = 0) -> ImageBackend:
+    """Lay a simulated board out as the memory of a PVZ process"""
+    rng = random.Random(seed)
+    plants = [plant_record(p) for p in sim.plants if p.is_alive]
+    zombies = [zombie_record(z) for z in sim.zombies if z.is_alive]
+    projectiles = [projectile_record(p) for p in sim.projectiles if p.is_alive]
+    lawnmowers = [{'row': row, 'x': -20.0} for row in range(5)]
+    place_items = [{'row': rng.randrange(5), 'col': rng.randrange(9), 'type': 1}
+                   for _ in range(2)]
+    seeds = [{'type': int(plant_type)} for plant_type in DECISION_DECK]
+    seeds += [{'type': -1}] * (10 - len(seeds))
+
+    image = ImageBackend()
+    image.map(Offset.BASE, struct.pack('<I', PVZ_BASE))
+    base = bytearray(Offset.GAME_UI + 4)
+    struct.pack_into('<I', base, Offset.MAIN_OBJECT, BOARD)
+    struct.pack_into('<i', base, Offset.GAME_UI, 3)
+    image.map(PVZ_BASE, base)
+
+    board = bytearray(rng.randbytes(Offset.CLICK_PAO_COUNTDOWN + 4))
+    arrays = [(ZOMBIE_LAYOUT, 'zombie', zombies), (PLANT_LAYOUT, 'plant', plants),
+              (PROJECTILE_LAYOUT, 'projectile', projectiles),
+              (LAWNMOWER_LAYOUT, 'lawnmower', lawnmowers),
+              (PLACE_ITEM_LAYOUT, 'place_item', place_items)]
+    pointers = {}
+    for n, (layout, name, records) in enumerate(arrays):
+        data, count = pack_array(layout, records, dead_share, rng)
+        address = ARRAYS_START + n * ARRAY_STRIDE
+        image.map(address, data)
+        pointers[f'{name}_array'] = address
+        pointers[f'{name}_count_max'] = count
+    data, _ = pack_array(SEED_LAYOUT, seeds, 0.0, rng)
+    pointers['seed_array'] = ARRAYS_START + len(arrays) * ARRAY_STRIDE
+    image.map(pointers['seed_array'], data)
+
+    scalars = {'sun': sim.sun, 'wave': sim.wave, 'total_waves': 20, 'game_clock': sim.frame,
+               'scene': sim.scene}
+    for layout, values in ((BOARD_ARRAYS_LAYOUT, pointers), (BOARD_SCALARS_LAYOUT, scalars)):
+        for name, offset, code in layout.fields:
+            if name in values:
+                struct.pack_into('<' + code, board, offset, values[name])
+    struct.pack_into('<ii', board, Offset.ITEM_ARRAY, 0, 0)  # No collectibles
+    image.map(BOARD, board)
+    return image
+
+
+class CountingBackend(MemoryBackend):
+    """Counts the reads and bytes going to another backend"""
+
+    def __init__(self, inner: MemoryBackend):
+        self.inner = inner
+        self.reads = 0
+        self.bytes = 0
+
+    def read(self, address: int, size: int) -> bytes:
+        self.reads += 1
+        self.bytes += size
+        return self.inner.read(address, size)
+
+
+class SyscallBackend(MemoryBackend):
+    """Reads the image after reading as many bytes of this process through ProcMemBackend"""
+
+    def __init__(self, inner: MemoryBackend):
+        self.inner = inner
+        self._process = ProcMemBackend(os.getpid())
+        self._scratch = ctypes.create_string_buffer(1)
+
+    def read(self, address: int, size: int) -> bytes:
+        if size > len(self._scratch):
+            self._scratch = ctypes.create_string_buffer(size)
+        self._process.read(ctypes.addressof(self._scratch), size)
+        return self.inner.read(address, size)
+
+    def close(self) -> None:
+        self._process.close()
+
+
+# ============================================================================
+# Reference Reader
+# ============================================================================
+
+class FieldReader(GameReader):
+    """GameReader as it was: one read per field and per dead flag (reference)"""
+
+    _READS = {'i': 'read_int', 'I': 'read_uint', 'f': 'read_float', '?': 'read_bool'}
+
+    def _read_fields(self, layout: RecordLayout, addr: int) -> list:
+        values = [getattr(self.reader, self._READS[code])(addr + offset)
+                  for _, offset, code in layout.fields]
+        for name in layout.flags:
+            i = layout.names.index(name)
+            values[i] = values[i] != 0
+        return values
+
+    def _read_records(self, layout: RecordLayout, array: int, count: int) -> list:
+        records = []
+        if array == 0:
+            return records
+        for i in range(count):
+            addr = array + i * layout.size
+            if layout.dead_offset is None or not self.reader.read_bool(addr + layout.dead_offset):
+                records.append(layout.cls(i, *self._read_fields(layout, addr)))
+        return records
+
+    def _read_board_block(self, layout: RecordLayout, board: int) -> dict:
+        return dict(zip(layout.names, self._read_fields(layout, board)))
+
+    def read_game_state(self):
+        # Each array re-read the board pointer and its own length, as before
+        from game.state import GameState
+        board = self.reader.get_board()
+        if board == 0:
+            return GameState()
+        zombies = self._read_records(ZOMBIE_LAYOUT, self.reader.get_zombie_array(),
+                                     self.reader.get_zombie_count_max())
+        plants = self._read_records(PLANT_LAYOUT, self.reader.get_plant_array(),
+                                    self.reader.get_plant_count_max())
+        return GameState(zombies=zombies, plants=plants,
+                         seeds=self.read_all_seeds(), projectiles=self.read_all_projectiles(),
+                         lawnmowers=self.read_all_lawnmowers(),
+                         place_items=self.read_all_place_items(),
+                         **self._read_board_block(BOARD_SCALARS_LAYOUT, board))
+
+
+def state_key(state) -> tuple:
+    """Everything read_game_state() reads, for comparing two readers"""
+    scalars = tuple(getattr(state, name) for name in BOARD_SCALARS_LAYOUT.names)
+    return (scalars, state.zombies, state.plants, state.projectiles, state.lawnmowers,
+            state.place_items, state.seeds)
+
+
+# ============================================================================
+# Measurement
+# ============================================================================
+
+def time_read(game_reader: GameReader, repeats: int, inner: int = 20) -> float:
+    """Best time per read_game_state() in microseconds"""
+    best = float('inf')
+    for _ in range(repeats):
+        start = time.perf_counter()
+        for _ in range(inner):
+            game_reader.read_game_state()
+        best = min(best, time.perf_counter() - start)
+    return best / inner * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser(description='State read benchmark')
+    parser.add_argument('--repeats', type=int, default=5, help='Timed runs per reader')
+    parser.add_argument('--dead-share', type=float, default=0.25,
+                        help='Share of array slots that are dead')
+    args = parser.parse_args()
+
+    boards = [('early-wave', build_early_wave_board), ('melee', build_melee_board),
+              ('late-wave', build_late_wave_board)]
+    print(f"{'board':>10s} {'entities':>8s} {'check':>9s} {'reader':>7s} {'reads':>6s} "
+          f"{'bytes':>7s} {'image us':>9s} {'syscall us':>11s}")
+    for name, build in boards:
+        sim = build()
+        image = build_image(sim, args.dead_share)
+        entities = len(sim.plants) + len(sim.zombies) + len(sim.projectiles)
+        bulk = GameReader(MemoryReader(backend=image))
+        field = FieldReader(MemoryReader(backend=image))
+        status = ('identical' if state_key(bulk.read_game_state()) == state_key(field.read_game_state())
+                  else 'DIFFERENT')
+        for label, cls in (('field', FieldReader), ('bulk', GameReader)):
+            counter = CountingBackend(image)
+            cls(MemoryReader(backend=counter)).read_game_state()
+            image_us = time_read(cls(MemoryReader(backend=image)), args.repeats)
+            syscalls = SyscallBackend(image)
+            syscall_us = time_read(cls(MemoryReader(backend=syscalls)), args.repeats, inner=5)
+            syscalls.close()
+            print(f"{name:>10s} {entities:8d} {status:>9s} {label:>7s} {counter.reads:6d} "
+                  f"{counter.bytes:7d} {image_us:9.1f} {syscall_us:11.1f}")
+
+
+if __name__ == '__main__':
+    main()
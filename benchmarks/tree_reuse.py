@@ -0,0 +1,129 @@
+"""
+Tree Reuse Benchmark
+Effective simulations per decision with and without search-tree reuse
+
+Usage:
+    python -m benchmarks.tree_reuse [--budget SECONDS] [--decisions N]
+
+Each decision state of benchmarks.mcts starts a short game played by a
+GameSimulator: every refresh (5 frames, the 50 ms BotConfig.refresh_rate)
+the board is read back as a game state, MCTSOptimizer decides, the
+decision is applied, seeds recharge and SUN_PER_SECOND sun comes in, as in
+OptimalBot._run_loop. Effective simulations
+are the root visits at the end of a decision: simulations run for it plus
+those carried over by re-rooting the previous tree. The same games are
+played with reuse off, and both are judged by evaluate_board after
+--judge-frames more frames.
+"""
+
+import argparse
+import statistics
+
+from data.plants import PLANT_HP
+from engine.optimizer import MCTSOptimizer, apply_action, board_scale, build_simulator, evaluate_board
+from benchmarks.scenarios import build_decision_states
+
+
+REFRESH_FRAMES = 5
+
+# Sun collected per second of play (a grown economy; the simulator makes none)
+SUN_PER_SECOND = 50
+
+
+def observe(sim, template):
+    """Read a simulated board back as a game state, keeping the template's deck"""
+    from game.state import GameState
+    from game.plant import PlantInfo
+    from game.zombie import ZombieInfo
+
+    state = GameState(sun=sim.sun, wave=template.wave, total_waves=template.total_waves,
+                      game_clock=sim.frame, scene=sim.scene)
+    state.seeds = template.seeds
+    for plant in sim.plants:
+        if plant.is_alive:
+            state.plants.append(PlantInfo(
+                index=len(state.plants), row=plant.row, col=plant.col, type=plant.type,
+                hp=plant.health, hp_max=PLANT_HP.get(plant.type, 300), state=0,
+                shoot_countdown=plant.attack_countdown, effective=True))
+    for zombie in sim.zombies:
+        if zombie.is_alive:
+            state.zombies.append(ZombieInfo(
+                index=len(state.zombies), row=zombie.row, x=zombie.x, y=0.0, type=zombie.type,
+                hp=zombie.body_health, hp_max=zombie.body_health,
+                accessory_hp=zombie.armor_health, state=0, speed=zombie.effective_speed,
+                slow_countdown=zombie.slow_countdown, freeze_countdown=zombie.freeze_countdown,
+                butter_countdown=0, at_wave=template.wave))
+    return state
+
+
+def play_game(optimizer: MCTSOptimizer, template, decisions: int, judge_frames: int):
+    """
+    Play one game of refresh-spaced decisions
+
+    Returns:
+        (effective simulations per decision, new simulations per decision,
+        share of decisions that reused a tree, final value)
+    """
+    game = build_simulator(template)
+    zombie_hp, plant_hp = board_scale(game)
+    seeds = {seed.type: seed for seed in template.seeds}
+    effective, fresh, reused = [], [], 0
+    for step in range(decisions):
+        action = optimizer.get_best_action(observe(game, template))
+        stats = optimizer.last_stats
+        if stats.simulations:
+            effective.append(stats.effective_simulations)
+            fresh.append(stats.simulations)
+            reused += stats.reused > 0
+        if action is not None and not action.is_wait and apply_action(game, action):
+            seed = seeds.get(action.plant_type)
+            if seed is not None:
+                seed.usable = False
+                seed.recharge_countdown = seed.recharge_time
+        game.tick_n(REFRESH_FRAMES)
+        if (step + 1) % (100 // REFRESH_FRAMES) == 0:
+            game.sun += SUN_PER_SECOND
+        for seed in template.seeds:
+            seed.recharge_countdown = max(0, seed.recharge_countdown - REFRESH_FRAMES)
+            seed.usable = seed.recharge_countdown == 0
+    game.tick_n(judge_frames, skip_ahead=True)
+    return effective, fresh, reused / max(len(effective), 1), evaluate_board(game, zombie_hp, plant_hp)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Search-tree reuse benchmark')
+    parser.add_argument('--budget', type=float, default=0.03, help='MCTS seconds per decision')
+    parser.add_argument('--states', type=int, default=12, help='Games (decision states)')
+    parser.add_argument('--decisions', type=int, default=60, help='Decisions per game')
+    parser.add_argument('--judge-frames', type=int, default=1000, help='Frames played to judge')
+    args = parser.parse_args()
+
+    print(f"{'state':>8s} {'reuse':>6s} {'effective':>10s} {'new':>6s} {'reused':>7s} {'value':>6s}")
+    totals = {False: [], True: []}
+    for name, _ in build_decision_states(args.states):
+        for reuse in (False, True):
+            # Fresh states per run: decisions mark the template's seeds used
+            template = dict(build_decision_states(args.states))[name]
+            optimizer = MCTSOptimizer(time_budget=args.budget, reuse_tree=reuse)
+            effective, fresh, share, value = play_game(optimizer, template, args.decisions,
+                                                       args.judge_frames)
+            if not effective:
+                continue
+            totals[reuse].append((statistics.mean(effective), statistics.mean(fresh), share, value))
+            print(f"{name:>8s} {'on' if reuse else 'off':>6s} {statistics.mean(effective):10.0f} "
+                  f"{statistics.mean(fresh):6.0f} {share:7.0%} {value:6.3f}")
+
+    for reuse in (False, True):
+        rows = totals[reuse]
+        if rows:
+            print(f"reuse {'on ' if reuse else 'off'}: {statistics.mean(r[0] for r in rows):.0f} effective, "
+                  f"{statistics.mean(r[1] for r in rows):.0f} new simulations per decision, "
+                  f"{statistics.mean(r[2] for r in rows):.0%} re-rooted, "
+                  f"mean value {statistics.mean(r[3] for r in rows):.4f}")
+    if totals[False] and totals[True]:
+        gain = statistics.mean(r[0] for r in totals[True]) / statistics.mean(r[0] for r in totals[False])
+        print(f"effective simulations gain: {gain:.1f}x")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,122 @@
+"""
+Batched Simulator Benchmark
+Throughput of VecSimulator in env-frames per second
+
+Usage:
+    python -m benchmarks.vec_simulator [--frames N] [--repeats N]
+
+First replays random batched actions on a few boards and checks every board
+against a GameSimulator given the same actions (auto-reset included), then
+reports total env-frames/s on the late-wave board for N = 1, 64 and 1024.
+"""
+
+import argparse
+import random
+import time
+
+from data.plants import PlantType
+from data.zombies import ZombieType
+from engine.simulator import GameSimulator
+from engine.array_simulator import ArraySimulator
+from engine.vec_simulator import VecSimulator
+from benchmarks.scenarios import build_late_wave_board, build_melee_board
+from benchmarks.simulator import board_signature
+
+
+ACTION_PLANTS = [PlantType.PEASHOOTER, PlantType.REPEATER, PlantType.THREEPEATER,
+                 PlantType.SNOW_PEA, PlantType.WALLNUT, PlantType.MELONPULT]
+ACTION_ZOMBIES = [ZombieType.ZOMBIE, ZombieType.CONEHEAD, ZombieType.BUCKETHEAD]
+
+
+def random_actions(rng: random.Random, n_envs: int, per_env: int) -> dict:
+    """One batch of each action kind, with per_env entries for every board"""
+    envs = [e for e in range(n_envs) for _ in range(per_env)]
+    rng.shuffle(envs)
+    n = len(envs)
+    return {
+        'place': (envs, [int(rng.choice(ACTION_PLANTS)) for _ in range(n)],
+                  [rng.randrange(5) for _ in range(n)], [rng.randrange(9) for _ in range(n)]),
+        'remove': (envs, [rng.randrange(5) for _ in range(n)], [rng.randrange(9) for _ in range(n)]),
+        'spawn': (envs, [int(rng.choice(ACTION_ZOMBIES)) for _ in range(n)],
+                  [rng.randrange(5) for _ in range(n)], [rng.uniform(0.0, 800.0) for _ in range(n)]),
+    }
+
+
+def check_equivalence(board: GameSimulator, n_envs: int, frames: int, seed: int = 0) -> int:
+    """
+    Step a VecSimulator and one GameSimulator per board with the same actions
+
+    Returns:
+        Frame at which some board first differs, or -1 if none does
+    """
+    rng = random.Random(seed)
+    vec = VecSimulator(board, n_envs, auto_reset=True)
+    reference = [board.clone() for _ in range(n_envs)]
+    for frame in range(frames):
+        if frame % 25 == 0:
+            actions = random_actions(rng, n_envs, per_env=2)
+            vec.place_plants(*actions['place'])
+            vec.remove_plants(*actions['remove'])
+            vec.spawn_zombies(*actions['spawn'])
+            for e, t, r, c in zip(*actions['place']):
+                reference[e].place_plant(PlantType(t), r, c)
+            for e, r, c in zip(*actions['remove']):
+                reference[e].remove_plant(r, c)
+            for e, t, r, x in zip(*actions['spawn']):
+                reference[e].spawn_zombie(ZombieType(t), r, x)
+
+        vec.tick()
+        for e in range(n_envs):
+            reference[e].tick()
+            if reference[e].is_game_over:
+                if not vec.is_game_over[e]:
+                    return frame + 1
+                reference[e] = board.clone()
+        for e in range(n_envs):
+            if board_signature(reference[e]) != board_signature(vec.get_board(e)):
+                return frame + 1
+    return -1
+
+
+def measure_env_fps(board: GameSimulator, n_envs: int, frames: int, repeats: int) -> float:
+    """Best total env-frames per second of a VecSimulator over board"""
+    best = float('inf')
+    for _ in range(repeats):
+        vec = VecSimulator(board, n_envs)
+        start = time.perf_counter()
+        vec.tick_n(frames)
+        best = min(best, time.perf_counter() - start)
+    return n_envs * frames / best
+
+
+def main():
+    parser = argparse.ArgumentParser(description='VecSimulator throughput benchmark')
+    parser.add_argument('--frames', type=int, default=20, help='Frames per timed run')
+    parser.add_argument('--repeats', type=int, default=3, help='Timed runs per size')
+    parser.add_argument('--check-frames', type=int, default=600, help='Frames compared')
+    args = parser.parse_args()
+
+    diverged = check_equivalence(build_melee_board(), n_envs=6, frames=args.check_frames)
+    status = 'identical' if diverged < 0 else f'DIVERGED at frame {diverged}'
+    print(f"equivalence [melee x 6, random actions, {args.check_frames} frames]: {status}")
+
+    board = build_late_wave_board()
+    print(f"board: {board.alive_zombie_count} zombies, {len(board.projectiles)} projectiles, "
+          f"{board.alive_plant_count} plants")
+
+    # Single-board ArraySimulator for reference
+    best = float('inf')
+    for _ in range(args.repeats):
+        sim = ArraySimulator.from_simulator(board)
+        start = time.perf_counter()
+        sim.tick_n(args.frames)
+        best = min(best, time.perf_counter() - start)
+    print(f"{'ArraySimulator':>16s}: {args.frames / best:12.0f} env-frames/s")
+
+    for n_envs in (1, 64, 1024):
+        fps = measure_env_fps(board, n_envs, args.frames, args.repeats)
+        print(f"{'N = ' + str(n_envs):>16s}: {fps:12.0f} env-frames/s")
+
+
+if __name__ == '__main__':
+    main()
@@ -27,6 +27,10 @@ class BotConfig:
     # Main loop refresh rate (seconds)
     refresh_rate: float = 0.05
     
+    # Read the next state only once the bot is done deciding on the last one
+    # (for games that advance on every read, like a free-running headless level)
+    lockstep_polling: bool = False
+    
     # ========================================================================
     # Debug Settings
     # ========================================================================
@@ -73,6 +77,18 @@ class BotConfig:
     strategic_weight: float = 1.5
     urgency_weight: float = 3.0
     
+    # Search decisions with MCTSOptimizer instead of the rule-based optimizer
+    use_mcts: bool = False
+    
+    # MCTS wall-clock budget per decision (seconds, well under action_interval)
+    mcts_time_budget: float = 0.03
+    
+    # MCTS worker processes (more than 1 searches root-parallel)
+    mcts_workers: int = 1
+    
+    # Re-root the previous decision's search tree instead of starting afresh
+    mcts_reuse_tree: bool = True
+    
     # ========================================================================
     # Strategy Settings
     # ========================================================================
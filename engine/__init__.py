@@ -4,9 +4,10 @@ Provides AI decision making for optimal play and game simulation
 """
 
 from engine.action import Action, ActionType
-from engine.analyzer import ThreatAnalyzer, ResourceAnalyzer
+from engine.analyzer import ThreatAnalyzer, ResourceAnalyzer, BoardAnalysis
 from engine.strategy import StrategyPlanner
-from engine.optimizer import ActionOptimizer
+from engine.optimizer import ActionOptimizer, MCTSOptimizer
+from engine.parallel_search import ParallelMCTSOptimizer
 from engine.simulator import (
     GameSimulator,
     GameState,
@@ -14,6 +15,10 @@ from engine.simulator import (
     Zombie,
     Projectile,
 )
+from engine.array_simulator import ArraySimulator, EntityColumns, LaneSimulator
+from engine.vec_simulator import VecSimulator
+from engine.transposition import TranspositionTable
+from engine.headless import HeadlessInterface, create_level_waves
 from engine.wave_spawner import (
     WaveSpawner,
     WaveConfig,
@@ -34,6 +34,7 @@ class RowThreat:
     has_gargantuar: bool
     has_fast_zombie: bool
     time_to_danger: float  # Time until closest zombie reaches danger zone
+    incoming_hp: int = 0  # Total HP of the row's zombies
 
 
 @dataclass
@@ -63,74 +64,14 @@ class ThreatAnalyzer:
         self.row_count = 6 if state.scene in [2, 3] else 5  # Pool/Fog have 6 rows
     
     def analyze(self) -> ThreatAnalysis:
-        """Perform complete threat analysis"""
-        row_threats = []
-        total_threat = 0.0
-        total_hp = 0
-        garg_count = 0
-        critical_zombies = []
-        
-        for row in range(self.row_count):
-            row_threat = self._analyze_row(row)
-            row_threats.append(row_threat)
-            total_threat += row_threat.total_threat
-            
-            # Collect critical zombies
-            for z in self.state.get_zombies_in_row(row):
-                total_hp += z.total_hp
-                if is_gargantuar(z.type):
-                    garg_count += 1
-                if z.x < self.DANGER_X:
-                    critical_zombies.append(z)
-        
-        # Find most threatened row
-        most_threatened = max(range(self.row_count), 
-                             key=lambda r: row_threats[r].total_threat)
-        
-        return ThreatAnalysis(
-            overall_threat=total_threat,
-            row_threats=row_threats,
-            most_threatened_row=most_threatened,
-            critical_zombies=critical_zombies,
-            gargantuar_count=garg_count,
-            total_zombie_hp=total_hp,
-        )
+        """Perform complete threat analysis (the state's shared BoardAnalysis)"""
+        return BoardAnalysis.of(self.state).threat
     
     def _analyze_row(self, row: int) -> RowThreat:
         """Analyze threat level for a single row"""
-        zombies = self.state.get_zombies_in_row(row)
-        
-        if not zombies:
-            return RowThreat(
-                row=row,
-                total_threat=0.0,
-                zombie_count=0,
-                closest_zombie_x=float('inf'),
-                has_gargantuar=False,
-                has_fast_zombie=False,
-                time_to_danger=float('inf'),
-            )
-        
-        total_threat = sum(z.threat_level for z in zombies)
-        closest = min(zombies, key=lambda z: z.x)
-        has_garg = any(is_gargantuar(z.type) for z in zombies)
-        has_fast = any(z.effective_speed >= 0.4 for z in zombies)
-        
-        # Calculate time to danger
-        if closest.effective_speed > 0:
-            time_to_danger = max(0, (closest.x - self.DANGER_X) / closest.effective_speed)
-        else:
-            time_to_danger = float('inf')
-        
-        return RowThreat(
-            row=row,
-            total_threat=total_threat,
-            zombie_count=len(zombies),
-            closest_zombie_x=closest.x,
-            has_gargantuar=has_garg,
-            has_fast_zombie=has_fast,
-            time_to_danger=time_to_danger,
-        )
+        if 0 <= row < self.row_count:
+            return BoardAnalysis.of(self.state).threat.row_threats[row]
+        return _analyze_row_threat(self.state, row)
     
     def get_priority_targets(self, max_targets: int = 5) -> List[ZombieInfo]:
         """Get high-priority zombie targets"""
@@ -177,7 +118,11 @@ class ResourceAnalyzer:
         self.state = state
     
     def analyze(self) -> ResourceAnalysis:
-        """Perform complete resource analysis"""
+        """Perform complete resource analysis (the state's shared BoardAnalysis)"""
+        return BoardAnalysis.of(self.state).resources
+    
+    def _analyze(self) -> ResourceAnalysis:
+        """Compute the resource analysis"""
         # Count sun production plants
         sun_producers = self.state.get_plants_by_type(PlantType.SUNFLOWER)
         twin_producers = self.state.get_plants_by_type(PlantType.TWINSUNFLOWER)
@@ -247,38 +192,15 @@ class DefenseAnalyzer:
     
     def get_undefended_rows(self) -> List[int]:
         """Get rows without defensive plants"""
-        undefended = []
-        for row in range(self.row_count):
-            has_wall = any(
-                p.type in DEFENSIVE_PLANTS 
-                for p in self.state.get_plants_in_row(row)
-            )
-            if not has_wall:
-                undefended.append(row)
-        return undefended
+        return [d.row for d in self._defenses() if d.defender_count == 0]
     
     def get_weak_defense_rows(self, hp_threshold: float = 0.3) -> List[int]:
         """Get rows where defensive plants have low HP"""
-        weak_rows = []
-        for row in range(self.row_count):
-            for plant in self.state.get_plants_in_row(row):
-                if plant.type in DEFENSIVE_PLANTS:
-                    if plant.hp_ratio < hp_threshold:
-                        weak_rows.append(row)
-                        break
-        return weak_rows
+        return [d.row for d in self._defenses() if d.weakest_wall < hp_threshold]
     
     def get_rows_without_attackers(self) -> List[int]:
         """Get rows without any attacking plants"""
-        no_attackers = []
-        for row in range(self.row_count):
-            has_attacker = any(
-                p.type in ATTACKING_PLANTS
-                for p in self.state.get_plants_in_row(row)
-            )
-            if not has_attacker:
-                no_attackers.append(row)
-        return no_attackers
+        return [d.row for d in self._defenses() if d.attacker_count == 0]
     
     def get_defense_score(self, row: int) -> float:
         """
@@ -286,21 +208,162 @@ class DefenseAnalyzer:
         
         Higher score = better defense
         """
-        plants = self.state.get_plants_in_row(row)
-        if not plants:
-            return 0.0
-        
-        score = 0.0
+        if 0 <= row < self.row_count:
+            return self._defenses()[row].defense_score
+        return _analyze_row_defense(self.state, row).defense_score
+    
+    def _defenses(self) -> List['RowDefense']:
+        """Row defenses of the state's shared BoardAnalysis"""
+        return BoardAnalysis.of(self.state).defenses
+
+
+# ============================================================================
+# Board Analysis
+# ============================================================================
+
+@dataclass
+class RowDefense:
+    """Analysis of the plants in a single row"""
+    row: int
+    attacker_count: int
+    defender_count: int
+    dps: float  # Sum of the plants' attack values
+    weakest_wall: float  # Lowest HP ratio of a defensive plant (inf without one)
+    defense_score: float  # 0-10, higher = better defense
+
+
+@dataclass
+class BoardAnalysis:
+    """
+    Threat, resource and defense analysis of one state, shared by its consumers
+    
+    Computed in one pass over the rows on first use and kept with the
+    state: ThreatAnalyzer, ResourceAnalyzer and DefenseAnalyzer, the
+    StrategyPlanner and ActionOptimizer built on them, and StateEncoder
+    all read the same analysis during a decision. A state whose entity
+    lists, sun or seed list are replaced is analyzed again.
+    
+    The analysis and its lists are shared: read only.
+    """
+    row_count: int
+    threat: ThreatAnalysis
+    resources: ResourceAnalysis
+    defenses: List[RowDefense]
+    
+    @classmethod
+    def of(cls, state: GameState) -> 'BoardAnalysis':
+        """The state's analysis, computed on first use"""
+        key = (state._indexed, state.sun, state.scene, id(state.seeds), len(state.seeds))
+        analysis = state._analysis
+        if analysis is None or state._analysis_key != key:
+            analysis = state._analysis = cls._analyze(state)
+            state._analysis_key = key
+        return analysis
+    
+    @classmethod
+    def _analyze(cls, state: GameState) -> 'BoardAnalysis':
+        """Compute the analysis"""
+        row_count = 6 if state.scene in [2, 3] else 5  # Pool/Fog have 6 rows
+        row_threats = [_analyze_row_threat(state, row) for row in range(row_count)]
         
-        # Add score for defensive plants
-        for p in plants:
-            if p.type in DEFENSIVE_PLANTS:
-                score += 3.0 * p.hp_ratio
-            if p.type in ATTACKING_PLANTS:
-                score += 2.0
+        total_threat = 0.0
+        total_hp = 0
+        garg_count = 0
+        critical_zombies = []
+        for row_threat in row_threats:
+            total_threat += row_threat.total_threat
+            total_hp += row_threat.incoming_hp
+            for z in state.get_zombies_in_row(row_threat.row):
+                if is_gargantuar(z.type):
+                    garg_count += 1
+                if z.x < ThreatAnalyzer.DANGER_X:
+                    critical_zombies.append(z)
         
-        # Bonus for complete defense
-        if self.state.get_row_defense_count(row) > 0:
+        threat = ThreatAnalysis(
+            overall_threat=total_threat,
+            row_threats=row_threats,
+            most_threatened_row=max(range(row_count), key=lambda r: row_threats[r].total_threat),
+            critical_zombies=critical_zombies,
+            gargantuar_count=garg_count,
+            total_zombie_hp=total_hp,
+        )
+        return cls(
+            row_count=row_count,
+            threat=threat,
+            resources=ResourceAnalyzer(state)._analyze(),
+            defenses=[_analyze_row_defense(state, row) for row in range(row_count)],
+        )
+
+
+def _analyze_row_threat(state: GameState, row: int) -> RowThreat:
+    """Analyze threat level for a single row"""
+    zombies = state.get_zombies_in_row(row)
+    
+    if not zombies:
+        return RowThreat(
+            row=row,
+            total_threat=0.0,
+            zombie_count=0,
+            closest_zombie_x=float('inf'),
+            has_gargantuar=False,
+            has_fast_zombie=False,
+            time_to_danger=float('inf'),
+        )
+    
+    has_garg = False
+    has_fast = False
+    incoming_hp = 0
+    for z in zombies:
+        has_garg = has_garg or is_gargantuar(z.type)
+        has_fast = has_fast or z.effective_speed >= 0.4
+        incoming_hp += z.total_hp
+    closest = zombies[0]  # Rows are sorted by x
+    
+    # Calculate time to danger
+    if closest.effective_speed > 0:
+        time_to_danger = max(0, (closest.x - ThreatAnalyzer.DANGER_X) / closest.effective_speed)
+    else:
+        time_to_danger = float('inf')
+    
+    return RowThreat(
+        row=row,
+        total_threat=state.get_row_threat(row),
+        zombie_count=len(zombies),
+        closest_zombie_x=closest.x,
+        has_gargantuar=has_garg,
+        has_fast_zombie=has_fast,
+        time_to_danger=time_to_danger,
+        incoming_hp=incoming_hp,
+    )
+
+
+def _analyze_row_defense(state: GameState, row: int) -> RowDefense:
+    """Analyze the plants of a single row"""
+    plants = state.get_plants_in_row(row)
+    attackers = 0
+    defenders = 0
+    dps = 0.0
+    weakest = float('inf')
+    score = 0.0
+    for p in plants:
+        if p.type in DEFENSIVE_PLANTS:
+            defenders += 1
+            weakest = min(weakest, p.hp_ratio)
+            score += 3.0 * p.hp_ratio
+        if p.type in ATTACKING_PLANTS:
+            attackers += 1
+            dps += p.attack_value
             score += 2.0
-        
-        return min(10.0, score)
+    
+    # Bonus for complete defense
+    if defenders > 0:
+        score += 2.0
+    
+    return RowDefense(
+        row=row,
+        attacker_count=attackers,
+        defender_count=defenders,
+        dps=dps,
+        weakest_wall=weakest,
+        defense_score=min(10.0, score) if plants else 0.0,
+    )
@@ -0,0 +1,1275 @@
+"""
+Struct-of-Arrays Game Simulator for PVZ
+Vectorized counterpart of engine.simulator.GameSimulator for rollout-heavy search
+
+Each entity kind is stored as parallel NumPy columns (x, row, HP layers,
+countdowns, alive mask) and one tick() is a fixed set of array operations.
+Results are identical, frame for frame, to the object path in GameSimulator:
+
+- Slot order equals list order in GameSimulator (entities are appended and
+  compaction keeps relative order), so "first zombie in list order" is the
+  lowest alive slot.
+- Interactions whose outcome depends on processing order (a zombie killed
+  by one projectile before a later projectile reaches it, a plant bitten to
+  death before another zombie walks into it) are detected and resolved by a
+  sequential pass over the few entities involved.
+
+Several boards can share one set of columns (see engine.vec_simulator):
+every board row is a lane, and each board owns LANES_PER_BOARD lanes with
+an empty lane above and below its rows, so row-1/row+1 lookups (splash,
+threepeater) never reach another board.
+
+Time unit: 1 frame = 1 centisecond (cs) = 10 milliseconds
+"""
+
+from __future__ import annotations
+from typing import Dict, List, Optional
+
+import numpy as np
+
+from data.plants import (
+    PlantType,
+    PLANT_HP,
+    PLANT_COST,
+    ATTACKING_PLANTS,
+)
+from data.zombies import (
+    ZombieType,
+    ZOMBIE_HP_DATA,
+    ZOMBIE_BASE_SPEED,
+    SLOW_SPEED_MULTIPLIER,
+    ZOMBIE_BITE_DAMAGE,
+    ZOMBIE_BITE_INTERVAL,
+)
+from data.projectiles import (
+    ProjectileType,
+    PROJECTILE_DAMAGE,
+    PROJECTILE_SPEED,
+    PROJECTILE_SPLASH_RADIUS,
+    SLOWING_PROJECTILES,
+    SPLASH_PROJECTILES,
+)
+from data.constants import (
+    GRID_WIDTH,
+    LAWN_LEFT_X,
+    LAWN_RIGHT_X,
+    GRID_COLS,
+    GRID_ROWS,
+    PEASHOOTER_ATTACK_INTERVAL,
+    SLOW_DURATION,
+)
+from engine.simulator import (
+    GameSimulator,
+    Plant,
+    Zombie,
+    Projectile,
+    PLANT_PROJECTILE_TYPE,
+)
+
+
+# ============================================================================
+# Lookup Tables (indexed by entity type)
+# ============================================================================
+
+_PLANT_TYPES = max(PlantType) + 1
+_ZOMBIE_TYPES = max(ZombieType) + 1
+_PROJECTILE_TYPES = max(ProjectileType) + 1
+
+PLANT_HP_TABLE = np.array([PLANT_HP.get(t, 300) for t in range(_PLANT_TYPES)], dtype=np.int64)
+PLANT_COST_TABLE = np.array([PLANT_COST.get(t, 100) for t in range(_PLANT_TYPES)], dtype=np.int64)
+PLANT_ATTACKS_TABLE = np.array([t in ATTACKING_PLANTS for t in range(_PLANT_TYPES)], dtype=bool)
+
+ZOMBIE_SPEED_TABLE = np.array(
+    [ZOMBIE_BASE_SPEED.get(t, 0.23) for t in range(_ZOMBIE_TYPES)], dtype=np.float64)
+ZOMBIE_BODY_TABLE = np.array(
+    [ZOMBIE_HP_DATA.get(t, (270, 0))[0] for t in range(_ZOMBIE_TYPES)], dtype=np.int64)
+ZOMBIE_ARMOR_TABLE = np.array(
+    [ZOMBIE_HP_DATA.get(t, (270, 0))[1] for t in range(_ZOMBIE_TYPES)], dtype=np.int64)
+
+PROJECTILE_SPEED_TABLE = np.array(
+    [PROJECTILE_SPEED.get(t, 3.7) for t in range(_PROJECTILE_TYPES)], dtype=np.float64)
+PROJECTILE_DAMAGE_TABLE = np.array(
+    [PROJECTILE_DAMAGE.get(t, 20) for t in range(_PROJECTILE_TYPES)], dtype=np.int64)
+PROJECTILE_SPLASH_TABLE = np.array(
+    [t in SPLASH_PROJECTILES for t in range(_PROJECTILE_TYPES)], dtype=bool)
+PROJECTILE_RADIUS_TABLE = np.array(
+    [PROJECTILE_SPLASH_RADIUS.get(t, 80) for t in range(_PROJECTILE_TYPES)], dtype=np.float64)
+PROJECTILE_SLOWS_TABLE = np.array(
+    [t in SLOWING_PROJECTILES for t in range(_PROJECTILE_TYPES)], dtype=bool)
+
+# Fire pattern per plant type as (row offset, x offset from plant.x),
+# in the order GameSimulator._plant_fire creates projectiles
+FIRE_PATTERNS: Dict[PlantType, tuple] = {
+    PlantType.REPEATER: ((0, 40), (0, 45)),
+    PlantType.THREEPEATER: ((-1, 40), (0, 40), (1, 40)),
+    PlantType.SPLITPEA: ((0, 40), (0, -10)),
+    PlantType.GATLINGPEA: ((0, 40), (0, 43), (0, 46), (0, 49)),
+}
+_SINGLE_SHOT = ((0, 40),)
+
+# Right edge of the plant hitbox per column (plant.x + 40)
+PLANT_RIGHT_EDGES = np.array(
+    [LAWN_LEFT_X + c * GRID_WIDTH + 40 for c in range(GRID_COLS)], dtype=np.float64)
+
+# Lanes owned by each board: its rows plus an empty lane on either side
+LANES_PER_BOARD = GRID_ROWS + 2
+
+# Sort key stride separating lanes in the zombie position index
+_LANE_KEY_STRIDE = 1.0e6
+# Search margin around exact hitbox tests (candidates are re-checked exactly)
+_HIT_SEARCH_MARGIN = 1.0
+# Frame that is never reached
+_NEVER = 1 << 62
+
+
+# ============================================================================
+# Column Storage
+# ============================================================================
+
+class EntityColumns:
+    """
+    Parallel NumPy columns for one entity kind
+
+    Slots [0, count) are in use. Appending keeps insertion order and
+    compact() keeps the relative order of surviving slots.
+    """
+
+    def __init__(self, schema: Dict[str, np.dtype], capacity: int = 64):
+        self.count: int = 0
+        self.columns: Dict[str, np.ndarray] = {
+            name: np.zeros(capacity, dtype=dtype) for name, dtype in schema.items()
+        }
+
+    def __getitem__(self, name: str) -> np.ndarray:
+        """Get a writable view of the used part of a column"""
+        return self.columns[name][:self.count]
+
+    @property
+    def capacity(self) -> int:
+        return len(next(iter(self.columns.values())))
+
+    def reserve(self, extra: int) -> None:
+        """Make room for extra slots, doubling capacity as needed"""
+        needed = self.count + extra
+        capacity = self.capacity
+        if needed <= capacity:
+            return
+        while capacity < needed:
+            capacity *= 2
+        for name, column in self.columns.items():
+            grown = np.zeros(capacity, dtype=column.dtype)
+            grown[:self.count] = column[:self.count]
+            self.columns[name] = grown
+
+    def append(self, n: int, **values) -> slice:
+        """
+        Append n slots
+
+        Args:
+            n: Number of slots
+            **values: Column values (scalars or length-n arrays); unset columns are zero
+
+        Returns:
+            Slice covering the new slots
+        """
+        self.reserve(n)
+        start = self.count
+        self.count += n
+        for name, column in self.columns.items():
+            column[start:self.count] = values.get(name, 0)
+        return slice(start, self.count)
+
+    def compact(self, keep: np.ndarray) -> None:
+        """Drop slots where keep is False, preserving order"""
+        kept = int(np.count_nonzero(keep))
+        if kept == self.count:
+            return
+        keep = keep.copy()  # keep may be a view of one of the columns
+        for column in self.columns.values():
+            column[:kept] = column[:self.count][keep]
+        self.count = kept
+
+    def copy(self) -> EntityColumns:
+        """Copy of the columns at full capacity (unused slots included)"""
+        new = EntityColumns.__new__(EntityColumns)
+        new.count = self.count
+        new.columns = {name: column.copy() for name, column in self.columns.items()}
+        return new
+
+
+PLANT_SCHEMA = {
+    'id': np.int64,
+    'env': np.int64,  # Board index
+    'type': np.int64,
+    'row': np.int64,
+    'col': np.int64,
+    'lane': np.int64,
+    'health': np.int64,
+    'attack_countdown': np.int64,
+    'is_alive': np.bool_,
+    'attacks': np.bool_,  # Type is in ATTACKING_PLANTS
+}
+
+ZOMBIE_SCHEMA = {
+    'id': np.int64,
+    'env': np.int64,  # Board index
+    'type': np.int64,
+    'row': np.int64,
+    'lane': np.int64,
+    'x': np.float64,
+    'body_health': np.int64,
+    'armor_health': np.int64,
+    'shield_health': np.int64,
+    'is_alive': np.bool_,
+    'is_slowed': np.bool_,
+    'slow_countdown': np.int64,
+    'is_frozen': np.bool_,
+    'freeze_countdown': np.int64,
+    'is_eating': np.bool_,
+    'eat_countdown': np.int64,
+    'target_plant': np.int64,  # Plant slot being eaten (-1 if none)
+    'speed': np.float64,  # Base speed of the type
+    'step': np.float64,  # Walking speed with slow/freeze applied
+    'lane_key': np.float64,  # lane * _LANE_KEY_STRIDE
+}
+
+PROJECTILE_SCHEMA = {
+    'id': np.int64,
+    'env': np.int64,  # Board index
+    'type': np.int64,
+    'row': np.int64,
+    'x': np.float64,
+    'y': np.float64,
+    'damage': np.int64,
+    'is_alive': np.bool_,
+    'source_plant_id': np.int64,
+    'speed': np.float64,  # Speed of the type
+    'splash': np.bool_,  # Type is in SPLASH_PROJECTILES
+    'window_offset': np.float64,  # Hit window left end key minus x
+    'window_width': np.float64,  # Broad-phase width of the hit window
+}
+
+
+
+def board_lanes(envs, rows):
+    """Lane of a board row (works on scalars and arrays)"""
+    return envs * LANES_PER_BOARD + rows + 1
+
+
+def board_ranks(envs: np.ndarray) -> np.ndarray:
+    """Rank of each entry among the entries for the same board (0 = first)"""
+    order = np.argsort(envs, kind='stable')
+    sorted_envs = envs[order]
+    group_start = np.r_[0, (sorted_envs[1:] != sorted_envs[:-1]).nonzero()[0] + 1]
+    group_size = np.diff(np.r_[group_start, len(envs)])
+    ranks = np.empty(len(envs), dtype=np.int64)
+    ranks[order] = np.arange(len(envs)) - np.repeat(group_start, group_size)
+    return ranks
+
+
+def take_ids(counters: np.ndarray, envs: np.ndarray) -> np.ndarray:
+    """
+    Allocate entity ids from per-board counters
+
+    Args:
+        counters: Next free id per board (advanced in place)
+        envs: Board of each new entity, in creation order
+
+    Returns:
+        Id of each new entity
+    """
+    if len(envs) and np.all(envs == envs[0]):
+        first = int(counters[envs[0]])
+        counters[envs[0]] = first + len(envs)
+        return np.arange(first, first + len(envs))
+    ids = counters[envs] + board_ranks(envs)
+    np.add.at(counters, envs, 1)
+    return ids
+
+
+# ============================================================================
+# Lane Simulator (shared core)
+# ============================================================================
+
+class LaneSimulator:
+    """
+    Struct-of-arrays simulation core for one or more boards
+
+    Holds the entity columns of every board and runs the per-frame phases
+    over all of them at once. Each phase runs a vectorized broad pass over
+    all entities, then a short sequential pass over the handful of entities
+    with a discrete event this frame (projectile hits, bites, plant
+    contacts), in list order.
+
+    Board-level state (sun, game over) and the public interface live in the
+    subclasses: ArraySimulator for one board, VecSimulator for many.
+    """
+
+    def __init__(self, scene: int = 0, board_count: int = 1):
+        """
+        Initialize simulator core
+
+        Args:
+            scene: Scene type (0=day, 2=pool, etc.), shared by all boards
+            board_count: Number of boards sharing the columns
+        """
+        self.frame: int = 0
+        self.scene: int = scene
+
+        # Entity columns
+        self.plants = EntityColumns(PLANT_SCHEMA, capacity=64 * board_count)
+        self.zombies = EntityColumns(ZOMBIE_SCHEMA, capacity=128 * board_count)
+        self.projectiles = EntityColumns(PROJECTILE_SCHEMA, capacity=256 * board_count)
+
+        # Grid of alive plant slots per lane (-1 = empty)
+        self._plant_grid = np.full((board_count * LANES_PER_BOARD, GRID_COLS), -1, dtype=np.int64)
+        self._contact_table: Optional[np.ndarray] = None
+
+        # Projectile columns fired by each plant slot (see _volley_template)
+        self._volleys: List[Dict[str, np.ndarray]] = []
+        self._volley_templates: Dict[tuple, Dict[str, np.ndarray]] = {}
+
+        # Lazy attack countdowns (see _sync_plant_countdowns)
+        self._plant_sync_frame: int = 0
+        self._plant_wake_frame: int = 0
+
+        # ID counters for entities, per board (ids are only unique per board)
+        self._next_plant_ids = np.zeros(board_count, dtype=np.int64)
+        self._next_zombie_ids = np.zeros(board_count, dtype=np.int64)
+        self._next_projectile_ids = np.zeros(board_count, dtype=np.int64)
+
+        # Number of rows (5 for day/night, 6 for pool/fog)
+        self._row_count = 6 if scene in [2, 3] else 5
+
+    def _update_entities(self) -> None:
+        """
+        Run one frame's phases (frame already advanced)
+
+        Same order as GameSimulator.tick():
+        1. Projectiles
+        2. Zombies
+        3. Plants
+        4. Cleanup
+        """
+        self._update_projectiles()
+        self._update_zombies()
+        self._update_plants()
+        self._cleanup_dead_entities()
+
+    # ========================================================================
+    # Projectile Update
+    # ========================================================================
+
+    def _update_projectiles(self) -> None:
+        """Move all projectiles and resolve their collisions with zombies"""
+        projs = self.projectiles
+        n = projs.count
+        if n == 0:
+            return
+        cols = projs.columns
+
+        # Move, then drop projectiles that left the lawn
+        x = cols['x'][:n]
+        x += cols['speed'][:n]
+        alive = cols['is_alive'][:n]
+        alive &= x <= LAWN_RIGHT_X + 50
+
+        zombies = self.zombies
+        nz = zombies.count
+        zombie_alive = zombies.columns['is_alive'][:nz]
+        if not np.count_nonzero(zombie_alive):
+            return
+
+        # Broad phase: alive zombies sorted by (lane, x); dead ones and an end
+        # sentinel are keyed inf and sort last
+        zombie_key = np.full(nz + 1, np.inf)
+        np.add(zombies.columns['lane_key'][:nz], zombies.columns['x'][:nz],
+               out=zombie_key[:nz], where=zombie_alive)
+        index = zombie_key.argsort()
+        sorted_key = zombie_key[index]
+
+        # A projectile is a candidate if the first zombie at or past the left
+        # end of its hit window is still inside the window
+        window_lo = cols['window_offset'][:n] + x
+        width = cols['window_width'][:n]
+        lo = sorted_key.searchsorted(window_lo)
+        candidate = sorted_key[lo] <= window_lo + width
+        candidate &= alive
+
+        # Splash projectiles also look at the lanes above and below
+        neighbour_lo = {}
+        splash = (cols['splash'][:n] & alive).nonzero()[0]
+        if splash.size:
+            splash = np.concatenate((splash, splash))
+            shift = np.full(splash.size, _LANE_KEY_STRIDE)
+            shift[:splash.size // 2] = -_LANE_KEY_STRIDE
+            splash_lo = window_lo[splash] + shift
+            start = sorted_key.searchsorted(splash_lo)
+            found = (sorted_key[start] <= splash_lo + width[splash]).nonzero()[0]
+            candidate[splash[found]] = True
+            for p, row_lo, first in zip(splash[found].tolist(), splash_lo[found].tolist(),
+                                        start[found].tolist()):
+                neighbour_lo.setdefault(p, []).append((row_lo, first))
+
+        hits = candidate.nonzero()[0]
+        if hits.size == 0:
+            return
+        self._resolve_hits(hits.tolist(), window_lo[hits].tolist(), lo[hits].tolist(),
+                           neighbour_lo, sorted_key.tolist(), index.tolist())
+
+    def _resolve_hits(self, hits: list, window_lo: list, first: list, neighbour_lo: dict,
+                      sorted_key: list, sorted_slots: list) -> None:
+        """
+        Narrow phase: exact hit tests in GameSimulator order
+
+        Args:
+            hits: Candidate projectile slots, ascending
+            window_lo: Key of each candidate's hit window left end (own lane)
+            first: Index into sorted_key of the first zombie in that window
+            neighbour_lo: (window_lo, first) of the neighbour lanes of splash projectiles
+            sorted_key, sorted_slots: Zombie keys ascending and their slots
+        """
+        projs = self.projectiles.columns
+        proj_x = projs['x']
+        proj_type = projs['type']
+        proj_width = projs['window_width']
+        proj_alive = projs['is_alive']
+        zombie_x = self.zombies.columns['x']
+        zombie_alive = self.zombies.columns['is_alive']
+
+        for p, key_lo, i in zip(hits, window_lo, first):
+            width = float(proj_width[p])
+            targets = []
+            for window_start, j in [(key_lo, i)] + neighbour_lo.get(p, []):
+                window_end = window_start + width
+                while sorted_key[j] <= window_end:
+                    targets.append(sorted_slots[j])
+                    j += 1
+            targets.sort()  # zombie list order
+
+            px = float(proj_x[p])
+            ptype = int(proj_type[p])
+            if PROJECTILE_SPLASH_TABLE[ptype]:
+                radius = PROJECTILE_RADIUS_TABLE[ptype]
+                hit_any = False
+                for z in targets:
+                    if zombie_alive[z] and abs(px - zombie_x[z]) <= radius:
+                        self._apply_projectile_damage(p, z)
+                        hit_any = True
+                if hit_any:
+                    proj_alive[p] = False
+            else:
+                for z in targets:
+                    zx = float(zombie_x[z])
+                    if zombie_alive[z] and zx - 20 <= px <= zx + 20:
+                        self._apply_projectile_damage(p, z)
+                        proj_alive[p] = False
+                        break
+
+    def _apply_projectile_damage(self, p: int, z: int) -> None:
+        """Apply projectile damage (and slow) to a zombie"""
+        projs = self.projectiles.columns
+        if PROJECTILE_SLOWS_TABLE[projs['type'][p]]:
+            zombies = self.zombies.columns
+            zombies['is_slowed'][z] = True
+            zombies['slow_countdown'][z] = SLOW_DURATION
+            if not zombies['is_frozen'][z]:
+                zombies['step'][z] = zombies['speed'][z] * SLOW_SPEED_MULTIPLIER
+        self._apply_damage_to_zombie(z, int(projs['damage'][p]))
+
+    def _apply_damage_to_zombie(self, z: int, damage: int) -> None:
+        """
+        Apply damage to zombie following correct order:
+        Shield → Armor → Body
+
+        Reference: Zombie::TakeDamage() in Zombie.cpp
+        """
+        zombies = self.zombies.columns
+        remaining_damage = damage
+
+        shield = int(zombies['shield_health'][z])
+        if shield > 0:
+            absorbed = min(shield, remaining_damage)
+            zombies['shield_health'][z] = shield - absorbed
+            remaining_damage -= absorbed
+
+        armor = int(zombies['armor_health'][z])
+        if remaining_damage > 0 and armor > 0:
+            absorbed = min(armor, remaining_damage)
+            zombies['armor_health'][z] = armor - absorbed
+            remaining_damage -= absorbed
+
+        if remaining_damage > 0:
+            body = int(zombies['body_health'][z]) - remaining_damage
+            zombies['body_health'][z] = body
+            if body <= 0:
+                zombies['is_alive'][z] = False
+
+    # ========================================================================
+    # Zombie Update
+    # ========================================================================
+
+    def _update_zombies(self) -> None:
+        """Update zombie status effects, bites, movement and plant contact"""
+        zombies = self.zombies
+        n = zombies.count
+        if n == 0:
+            return
+        cols = zombies.columns
+        alive = cols['is_alive'][:n]
+
+        # Status effects
+        slow_cd = cols['slow_countdown'][:n]
+        if np.count_nonzero(slow_cd):
+            ticking = alive & (slow_cd > 0)
+            slow_cd -= ticking
+            expired = ticking & (slow_cd <= 0)
+            if np.count_nonzero(expired):
+                cols['is_slowed'][:n][expired] = False
+                self._update_zombie_steps(expired.nonzero()[0])
+        freeze_cd = cols['freeze_countdown'][:n]
+        if np.count_nonzero(freeze_cd):
+            ticking = alive & (freeze_cd > 0)
+            freeze_cd -= ticking
+            expired = ticking & (freeze_cd <= 0)
+            if np.count_nonzero(expired):
+                cols['is_frozen'][:n][expired] = False
+                self._update_zombie_steps(expired.nonzero()[0])
+
+        # Eating zombies count down to their next bite, everyone else walks
+        if np.count_nonzero(cols['is_eating'][:n]):
+            eating = cols['is_eating'][:n] & alive
+            eat_cd = cols['eat_countdown'][:n]
+            eat_cd -= eating
+            biting = eating & (eat_cd <= 0)
+            walking = alive ^ eating
+        else:
+            biting = np.zeros(n, dtype=bool)
+            walking = alive
+        x = cols['x'][:n]
+        np.subtract(x, cols['step'][:n], out=x, where=walking)
+
+        # Walkers reaching a plant hitbox (plant.x + 40 >= zombie.x)
+        contact_col = PLANT_RIGHT_EDGES.searchsorted(x, side='left')
+        contact = self._get_contact_table()[cols['lane'][:n], contact_col] >= 0
+        contact &= walking
+
+        events = (biting | contact).nonzero()[0]
+        if events.size:
+            self._resolve_zombie_events(events.tolist(), biting, contact_col)
+
+    def _update_zombie_steps(self, slots: np.ndarray) -> None:
+        """Recompute walking speed after a slow or freeze change (Zombie.effective_speed)"""
+        cols = self.zombies.columns
+        speed = cols['speed'][slots]
+        speed = np.where(cols['is_slowed'][slots], speed * SLOW_SPEED_MULTIPLIER, speed)
+        cols['step'][slots] = np.where(cols['is_frozen'][slots], 0.0, speed)
+
+    def _get_contact_table(self) -> np.ndarray:
+        """
+        Any alive plant at or right of each column, per lane
+
+        Returns:
+            (lanes, GRID_COLS + 1) array, -1 where there is none
+        """
+        if self._contact_table is None:
+            table = np.full((len(self._plant_grid), GRID_COLS + 1), -1, dtype=np.int64)
+            table[:, :GRID_COLS] = np.maximum.accumulate(self._plant_grid[:, ::-1], axis=1)[:, ::-1]
+            self._contact_table = table
+        return self._contact_table
+
+    def _resolve_zombie_events(self, events: list, biting: np.ndarray,
+                               contact_col: np.ndarray) -> None:
+        """Resolve bites and plant contacts one zombie at a time (list order)"""
+        cols = self.zombies.columns
+        plants = self.plants.columns
+        plant_alive = plants['is_alive']
+        plant_health = plants['health']
+        target_plant = cols['target_plant']
+        is_eating = cols['is_eating']
+        eat_cd = cols['eat_countdown']
+        lanes = cols['lane']
+        bite = int(ZOMBIE_BITE_DAMAGE)
+
+        for z in events:
+            if not biting[z]:
+                # First plant in list order whose hitbox the zombie reached
+                lane_slots = self._plant_grid[lanes[z], contact_col[z]:]
+                lane_slots = lane_slots[lane_slots >= 0]
+                if lane_slots.size:
+                    is_eating[z] = True
+                    target_plant[z] = lane_slots.min()
+                    eat_cd[z] = ZOMBIE_BITE_INTERVAL
+                continue
+
+            p = int(target_plant[z])
+            if p >= 0 and plant_alive[p]:
+                plant_health[p] -= bite
+                if plant_health[p] <= 0:
+                    # Plants have not been updated yet this frame
+                    self._sync_plant_countdowns(self.frame - 1)
+                    plant_alive[p] = False
+                    self._remove_plant_from_grid(p)
+                    is_eating[z] = False
+                    target_plant[z] = -1
+                else:
+                    eat_cd[z] = ZOMBIE_BITE_INTERVAL
+            else:
+                is_eating[z] = False
+                target_plant[z] = -1
+
+    # ========================================================================
+    # Plant Update
+    # ========================================================================
+
+    def _update_plants(self) -> None:
+        """Update attack countdowns and fire at zombies ahead"""
+        if self.frame < self._plant_wake_frame:
+            return
+        self._sync_plant_countdowns(self.frame)
+
+        plants = self.plants
+        n = plants.count
+        cols = plants.columns
+        attacking = cols['attacks'][:n] & cols['is_alive'][:n]
+        countdown = cols['attack_countdown'][:n]
+        ready = (attacking & (countdown <= 0)).nonzero()[0]
+        if ready.size:
+            self._fire_ready_plants(ready.tolist())
+
+        # Countdowns reach zero no earlier than the smallest one says
+        if np.count_nonzero(attacking):
+            self._plant_wake_frame = self.frame + max(int(countdown[attacking].min()), 1)
+        else:
+            self._plant_wake_frame = _NEVER
+
+    def _wake_plants_by(self, countdowns: np.ndarray) -> None:
+        """Make the plant phase run by the time the first of new (current) countdowns is due"""
+        if countdowns.size:
+            self._plant_wake_frame = min(self._plant_wake_frame,
+                                         self.frame + max(int(countdowns.min()), 1))
+
+    def _sync_plant_countdowns(self, frame: int) -> None:
+        """
+        Bring attack countdowns up to date as of the end of a frame
+
+        Countdowns are decremented lazily: between frames where some plant
+        can be ready, attack_countdown holds its value as of
+        _plant_sync_frame and is caught up here in one step.
+        """
+        elapsed = frame - self._plant_sync_frame
+        if elapsed <= 0:
+            return
+        self._plant_sync_frame = frame
+        plants = self.plants
+        n = plants.count
+        if n == 0:
+            return
+        cols = plants.columns
+        countdown = cols['attack_countdown'][:n]
+        ticking = cols['attacks'][:n] & cols['is_alive'][:n] & (countdown > 0)
+        np.subtract(countdown, np.minimum(countdown, elapsed), out=countdown, where=ticking)
+
+    def _fire_ready_plants(self, ready: list) -> None:
+        """Fire every ready plant that has a zombie ahead, in plant order"""
+        cols = self.plants.columns
+        countdown = cols['attack_countdown']
+
+        # Rightmost alive zombie per lane
+        zombies = self.zombies
+        zombie_alive = zombies['is_alive']
+        rightmost = np.full(len(self._plant_grid), -np.inf)
+        np.maximum.at(rightmost, zombies['lane'][zombie_alive], zombies['x'][zombie_alive])
+        rightmost = rightmost.tolist()
+
+        firing = []
+        for p, plant_type, lane, col in zip(ready, cols['type'][ready].tolist(),
+                                            cols['lane'][ready].tolist(),
+                                            cols['col'][ready].tolist()):
+            if plant_type == PlantType.THREEPEATER:
+                ahead = max(rightmost[lane - 1:lane + 2])
+            else:
+                ahead = rightmost[lane]
+            if ahead > LAWN_LEFT_X + col * GRID_WIDTH:
+                countdown[p] = PEASHOOTER_ATTACK_INTERVAL
+                firing.append(p)
+
+        if len(firing) == 1:
+            self._spawn_volley(firing[0])
+        elif firing:
+            self._spawn_volleys(firing)
+
+    def _spawn_volley(self, p: int) -> None:
+        """Create the projectiles fired by one plant"""
+        volley = self._volleys[p]
+        n = len(volley['type'])
+        if n == 0:
+            return
+        plants = self.plants.columns
+        env = int(plants['env'][p])
+        first_id = int(self._next_projectile_ids[env])
+        self._next_projectile_ids[env] = first_id + n
+        slots = self.projectiles.append(
+            n,
+            id=np.arange(first_id, first_id + n),
+            env=env,
+            source_plant_id=plants['id'][p],
+            **volley,
+        )
+        if env:
+            self.projectiles.columns['window_offset'][slots] += env * LANES_PER_BOARD * _LANE_KEY_STRIDE
+
+    def _spawn_volleys(self, firing: list) -> None:
+        """Create the projectiles fired by several plants, in plant order"""
+        volleys = [self._volleys[p] for p in firing]
+        counts = [len(volley['type']) for volley in volleys]
+        total = sum(counts)
+        if total == 0:
+            return
+        values = {name: np.concatenate([volley[name] for volley in volleys]) for name in volleys[0]}
+        plants = self.plants.columns
+        envs = np.repeat(plants['env'][firing], counts)
+        values['window_offset'] += envs * (LANES_PER_BOARD * _LANE_KEY_STRIDE)
+        self.projectiles.append(
+            total,
+            id=take_ids(self._next_projectile_ids, envs),
+            env=envs,
+            source_plant_id=np.repeat(plants['id'][firing], counts),
+            **values,
+        )
+
+    def _volley_template(self, plant_type: int, row: int, col: int) -> Dict[str, np.ndarray]:
+        """
+        Column values of the projectiles a plant fires, as if on board 0
+
+        Matches GameSimulator._plant_fire. A plant's volley never changes, so
+        it is looked up once when the plant is added; _spawn_volley fills in
+        the id, board and source plant.
+        """
+        key = (plant_type, row, col)
+        template = self._volley_templates.get(key)
+        if template is not None:
+            return template
+
+        plant_x = LAWN_LEFT_X + col * GRID_WIDTH
+        rows, xs = [], []
+        proj_type = PLANT_PROJECTILE_TYPE.get(plant_type)
+        if proj_type is not None:
+            for row_offset, x_offset in FIRE_PATTERNS.get(plant_type, _SINGLE_SHOT):
+                if 0 <= row + row_offset < self._row_count:
+                    rows.append(row + row_offset)
+                    xs.append(plant_x + x_offset)
+        rows = np.array(rows, dtype=np.int64)
+        template = self._projectile_columns(
+            np.full(len(rows), proj_type if proj_type is not None else 0, dtype=np.int64),
+            rows,
+            board_lanes(0, rows),
+            np.array(xs, dtype=np.float64),
+        )
+        self._volley_templates[key] = template
+        return template
+
+    @staticmethod
+    def _projectile_columns(types: np.ndarray, rows: np.ndarray, lanes: np.ndarray,
+                            xs: np.ndarray) -> Dict[str, np.ndarray]:
+        """Column values of new live projectiles (all but id, env and source_plant_id)"""
+        splash = PROJECTILE_SPLASH_TABLE[types]
+        reach = np.where(splash, PROJECTILE_RADIUS_TABLE[types], 20.0) + _HIT_SEARCH_MARGIN
+        return {
+            'type': types,
+            'row': rows,
+            'x': xs,
+            'y': np.zeros(len(types)),
+            'damage': PROJECTILE_DAMAGE_TABLE[types],
+            'is_alive': np.ones(len(types), dtype=bool),
+            'speed': PROJECTILE_SPEED_TABLE[types],
+            'splash': splash,
+            'window_offset': lanes * _LANE_KEY_STRIDE - reach,
+            'window_width': 2 * reach,
+        }
+
+    # ========================================================================
+    # Entity Cleanup
+    # ========================================================================
+
+    def _cleanup_dead_entities(self) -> None:
+        """
+        Compact dead projectiles and zombies away
+
+        Dead slots never interact, so compaction is batched: projectiles once
+        a quarter of the slots are dead, zombies once half are.
+        """
+        projs = self.projectiles
+        alive = projs['is_alive']
+        if np.count_nonzero(alive) * 4 < projs.count * 3:
+            projs.compact(alive)
+
+        zombies = self.zombies
+        alive = zombies['is_alive']
+        if zombies.count >= 64 and np.count_nonzero(alive) * 2 < zombies.count:
+            zombies.compact(alive)
+
+    def _remove_plant_from_grid(self, p: int) -> None:
+        """Remove plant slot from grid lookup"""
+        plants = self.plants.columns
+        lane, col = plants['lane'][p], plants['col'][p]
+        if self._plant_grid[lane, col] == p:
+            self._plant_grid[lane, col] = -1
+            self._contact_table = None
+
+    # ========================================================================
+    # Board Contents
+    # ========================================================================
+
+    def _add_plants(self, envs: np.ndarray, types: np.ndarray, rows: np.ndarray,
+                    cols: np.ndarray, ids: Optional[np.ndarray] = None,
+                    health: Optional[np.ndarray] = None,
+                    attack_countdown: Optional[np.ndarray] = None,
+                    is_alive: Optional[np.ndarray] = None) -> slice:
+        """
+        Append plants (the caller puts them on the grid)
+
+        Args:
+            envs, types, rows, cols: Board, type and cell of each plant
+            ids: Plant ids (default: next free ids)
+            health, attack_countdown, is_alive: State (default: freshly placed)
+
+        Returns:
+            Slice covering the new plant slots
+        """
+        n = len(types)
+        attacks = PLANT_ATTACKS_TABLE[types]
+        if ids is None:
+            ids = take_ids(self._next_plant_ids, envs)
+        if health is None:
+            health = PLANT_HP_TABLE[types]
+        if attack_countdown is None:
+            attack_countdown = np.where(attacks, PEASHOOTER_ATTACK_INTERVAL, 0)
+        if is_alive is None:
+            is_alive = np.ones(n, dtype=bool)
+
+        # Existing countdowns must be current before new ones join them
+        self._sync_plant_countdowns(self.frame)
+        self._wake_plants_by(attack_countdown[attacks & is_alive])
+
+        slots = self.plants.append(
+            n,
+            id=ids,
+            env=envs,
+            type=types,
+            row=rows,
+            col=cols,
+            lane=board_lanes(envs, rows),
+            health=health,
+            attack_countdown=attack_countdown,
+            is_alive=is_alive,
+            attacks=attacks,
+        )
+        self._volleys.extend(
+            self._volley_template(plant_type, row, col)
+            for plant_type, row, col in zip(types.tolist(), rows.tolist(), cols.tolist())
+        )
+        self._contact_table = None
+        return slots
+
+    def _add_zombies(self, envs: np.ndarray, types: np.ndarray, rows: np.ndarray,
+                     xs: np.ndarray, ids: Optional[np.ndarray] = None, **state) -> slice:
+        """
+        Append zombies
+
+        Args:
+            envs, types, rows, xs: Board, type, row and position of each zombie
+            ids: Zombie ids (default: next free ids)
+            **state: Other ZOMBIE_SCHEMA columns (default: freshly spawned)
+
+        Returns:
+            Slice covering the new zombie slots
+        """
+        n = len(types)
+        if ids is None:
+            ids = take_ids(self._next_zombie_ids, envs)
+        state.setdefault('body_health', ZOMBIE_BODY_TABLE[types])
+        state.setdefault('armor_health', ZOMBIE_ARMOR_TABLE[types])
+        state.setdefault('is_alive', True)
+        state.setdefault('target_plant', -1)
+        lanes = board_lanes(envs, rows)
+        slots = self.zombies.append(
+            n,
+            id=ids,
+            env=envs,
+            type=types,
+            row=rows,
+            lane=lanes,
+            x=xs,
+            speed=ZOMBIE_SPEED_TABLE[types],
+            lane_key=lanes * _LANE_KEY_STRIDE,
+            **state,
+        )
+        self._update_zombie_steps(np.arange(slots.start, slots.stop))
+        return slots
+
+    def _add_projectiles(self, envs: np.ndarray, types: np.ndarray, rows: np.ndarray,
+                         xs: np.ndarray, source_plant_ids: np.ndarray,
+                         ids: np.ndarray, **state) -> slice:
+        """
+        Append live projectiles
+
+        Args:
+            envs, types, rows, xs: Board, type, row and position of each projectile
+            source_plant_ids, ids: Firing plant and projectile ids
+            **state: Other PROJECTILE_SCHEMA columns (default: freshly fired)
+
+        Returns:
+            Slice covering the new projectile slots
+        """
+        values = self._projectile_columns(types, rows, board_lanes(envs, rows), xs)
+        values.update(state)
+        return self.projectiles.append(
+            len(types), id=ids, env=envs, source_plant_id=source_plant_ids, **values)
+
+    def _load_board(self, sim: GameSimulator, env: int) -> None:
+        """
+        Append every entity of a GameSimulator board to one board
+
+        Args:
+            sim: Source simulator (not modified)
+            env: Board to load into (should be empty)
+        """
+        plant_slot: Dict[int, int] = {}
+        if sim.plants:
+            slots = self._add_plants(
+                np.full(len(sim.plants), env, dtype=np.int64),
+                np.array([int(p.type) for p in sim.plants], dtype=np.int64),
+                np.array([p.row for p in sim.plants], dtype=np.int64),
+                np.array([p.col for p in sim.plants], dtype=np.int64),
+                ids=np.array([p.id for p in sim.plants], dtype=np.int64),
+                health=np.array([p.health for p in sim.plants], dtype=np.int64),
+                attack_countdown=np.array([p.attack_countdown for p in sim.plants], dtype=np.int64),
+                is_alive=np.array([p.is_alive for p in sim.plants], dtype=bool),
+            )
+            for slot, plant in zip(range(slots.start, slots.stop), sim.plants):
+                # Like GameSimulator._get_plant_by_id, the first plant with an id wins
+                plant_slot.setdefault(plant.id, slot)
+        for (row, col), plant_id in sim._plant_grid.items():
+            self._plant_grid[board_lanes(env, row), col] = plant_slot[plant_id]
+
+        zombies = sim.zombies
+        if zombies:
+            self._add_zombies(
+                np.full(len(zombies), env, dtype=np.int64),
+                np.array([int(z.type) for z in zombies], dtype=np.int64),
+                np.array([z.row for z in zombies], dtype=np.int64),
+                np.array([z.x for z in zombies], dtype=np.float64),
+                ids=np.array([z.id for z in zombies], dtype=np.int64),
+                body_health=[z.body_health for z in zombies],
+                armor_health=[z.armor_health for z in zombies],
+                shield_health=[z.shield_health for z in zombies],
+                is_alive=[z.is_alive for z in zombies],
+                is_slowed=[z.is_slowed for z in zombies],
+                slow_countdown=[z.slow_countdown for z in zombies],
+                is_frozen=[z.is_frozen for z in zombies],
+                freeze_countdown=[z.freeze_countdown for z in zombies],
+                is_eating=[z.is_eating for z in zombies],
+                eat_countdown=[z.eat_countdown for z in zombies],
+                target_plant=[plant_slot.get(z.target_plant_id, -1) for z in zombies],
+            )
+
+        # Dead projectiles are skipped by every update and dropped at cleanup
+        live = [p for p in sim.projectiles if p.is_alive]
+        if live:
+            self._add_projectiles(
+                np.full(len(live), env, dtype=np.int64),
+                np.array([int(p.type) for p in live], dtype=np.int64),
+                np.array([p.row for p in live], dtype=np.int64),
+                np.array([p.x for p in live], dtype=np.float64),
+                np.array([p.source_plant_id for p in live], dtype=np.int64),
+                np.array([p.id for p in live], dtype=np.int64),
+                y=np.array([p.y for p in live], dtype=np.float64),
+                damage=np.array([p.damage for p in live], dtype=np.int64),
+            )
+
+    def _export_board(self, env: int, sim: GameSimulator) -> GameSimulator:
+        """
+        Copy every entity of one board into a GameSimulator
+
+        Zombies already compacted away are not included; every alive entity is.
+
+        Args:
+            env: Board to export
+            sim: Target simulator (board-level fields already set, no entities)
+
+        Returns:
+            sim
+        """
+        self._sync_plant_countdowns(self.frame)
+        sim._next_plant_id = int(self._next_plant_ids[env])
+        sim._next_zombie_id = int(self._next_zombie_ids[env])
+        sim._next_projectile_id = int(self._next_projectile_ids[env])
+
+        plants = self.plants
+        plant_ids = plants['id'].tolist()
+        for slot in (plants['env'] == env).nonzero()[0].tolist():
+            sim.plants.append(Plant(
+                type=PlantType(int(plants['type'][slot])),
+                row=int(plants['row'][slot]),
+                col=int(plants['col'][slot]),
+                health=int(plants['health'][slot]),
+                attack_countdown=int(plants['attack_countdown'][slot]),
+                is_alive=bool(plants['is_alive'][slot]),
+                id=plant_ids[slot],
+            ))
+        grid = self._plant_grid[board_lanes(env, 0):board_lanes(env, GRID_ROWS)]
+        for row, col in zip(*np.nonzero(grid >= 0)):
+            sim._plant_grid[(int(row), int(col))] = plant_ids[grid[row, col]]
+
+        zombies = self.zombies
+        for slot in (zombies['env'] == env).nonzero()[0].tolist():
+            target = int(zombies['target_plant'][slot])
+            sim.zombies.append(Zombie(
+                type=ZombieType(int(zombies['type'][slot])),
+                row=int(zombies['row'][slot]),
+                x=float(zombies['x'][slot]),
+                body_health=int(zombies['body_health'][slot]),
+                armor_health=int(zombies['armor_health'][slot]),
+                shield_health=int(zombies['shield_health'][slot]),
+                is_alive=bool(zombies['is_alive'][slot]),
+                is_slowed=bool(zombies['is_slowed'][slot]),
+                slow_countdown=int(zombies['slow_countdown'][slot]),
+                is_frozen=bool(zombies['is_frozen'][slot]),
+                freeze_countdown=int(zombies['freeze_countdown'][slot]),
+                is_eating=bool(zombies['is_eating'][slot]),
+                eat_countdown=int(zombies['eat_countdown'][slot]),
+                target_plant_id=plant_ids[target] if target >= 0 else -1,
+                id=int(zombies['id'][slot]),
+            ))
+
+        projs = self.projectiles
+        for slot in (projs['is_alive'] & (projs['env'] == env)).nonzero()[0].tolist():
+            sim.projectiles.append(Projectile(
+                type=ProjectileType(int(projs['type'][slot])),
+                row=int(projs['row'][slot]),
+                x=float(projs['x'][slot]),
+                y=float(projs['y'][slot]),
+                damage=int(projs['damage'][slot]),
+                is_alive=bool(projs['is_alive'][slot]),
+                source_plant_id=int(projs['source_plant_id'][slot]),
+                id=int(projs['id'][slot]),
+            ))
+        return sim
+
+    def _clear_boards(self, envs: np.ndarray) -> None:
+        """Remove every entity of the given boards"""
+        cleared = np.zeros(len(self._plant_grid) // LANES_PER_BOARD, dtype=bool)
+        cleared[envs] = True
+        self._plant_grid.reshape(len(cleared), LANES_PER_BOARD, GRID_COLS)[cleared] = -1
+        self._compact_plants(~cleared[self.plants['env']])
+        self.zombies.compact(~cleared[self.zombies['env']])
+        self.projectiles.compact(~cleared[self.projectiles['env']])
+
+    def _compact_plants(self, keep: np.ndarray) -> None:
+        """
+        Drop plant slots where keep is False, preserving order
+
+        Unlike projectiles and zombies, plant slots are referenced by the
+        grid, zombie targets and volleys, which are remapped here. Dropped
+        plants must already be off the grid.
+        """
+        if np.count_nonzero(keep) == self.plants.count:
+            return
+        new_slot = np.cumsum(keep) - 1
+        new_slot[~keep] = -1
+
+        grid = self._plant_grid
+        on_grid = grid >= 0
+        grid[on_grid] = new_slot[grid[on_grid]]
+        target = self.zombies['target_plant']
+        targeting = target >= 0
+        target[targeting] = new_slot[target[targeting]]
+
+        self._volleys = [volley for volley, kept in zip(self._volleys, keep.tolist()) if kept]
+        self.plants.compact(keep)
+        self._contact_table = None
+
+
+# ============================================================================
+# Array Simulator
+# ============================================================================
+
+class ArraySimulator(LaneSimulator):
+    """
+    Struct-of-arrays game simulator
+
+    Drop-in replacement for GameSimulator's simulation interface
+    (tick/tick_n/place_plant/remove_plant/spawn_zombie) with the same
+    per-frame results. Use from_simulator()/to_simulator() to move a board
+    between the two representations.
+    """
+
+    def __init__(self, sun: int = 50, scene: int = 0):
+        """
+        Initialize simulator
+
+        Args:
+            sun: Initial sun count
+            scene: Scene type (0=day, 2=pool, etc.)
+        """
+        super().__init__(scene=scene, board_count=1)
+        self.sun: int = sun
+        self.wave: int = 0
+        self.is_game_over: bool = False
+        self.is_win: bool = False
+
+    # ========================================================================
+    # Main Simulation Loop
+    # ========================================================================
+
+    def tick(self) -> None:
+        """
+        Advance simulation by one frame (1cs = 10ms)
+
+        Same order as GameSimulator.tick():
+        1. Projectiles
+        2. Zombies
+        3. Plants
+        4. Cleanup
+        5. Game over check
+        """
+        if self.is_game_over:
+            return
+
+        self.frame += 1
+        self._update_entities()
+        self._check_game_over()
+
+    def tick_n(self, n: int) -> None:
+        """Advance simulation by n frames"""
+        for _ in range(n):
+            if self.is_game_over:
+                break
+            self.tick()
+
+    def _check_game_over(self) -> None:
+        """Check if game is over (zombies reached left edge)"""
+        zombies = self.zombies
+        x = zombies['x']
+        if x.size and x.min() < 0 and np.any(zombies['is_alive'] & (x < 0)):
+            self.is_game_over = True
+            self.is_win = False
+
+    # ========================================================================
+    # Operation Interface
+    # ========================================================================
+
+    def place_plant(self, plant_type: PlantType, row: int, col: int) -> bool:
+        """
+        Place a plant on the grid
+
+        Returns:
+            True if plant was placed successfully
+        """
+        if row < 0 or row >= self._row_count:
+            return False
+        if col < 0 or col >= GRID_COLS:
+            return False
+        lane = board_lanes(0, row)
+        if self._plant_grid[lane, col] >= 0:
+            return False
+
+        cost = int(PLANT_COST_TABLE[plant_type])
+        if self.sun < cost:
+            return False
+
+        slots = self._add_plants(np.zeros(1, dtype=np.int64), np.array([int(plant_type)]),
+                                 np.array([row]), np.array([col]))
+        self._plant_grid[lane, col] = slots.start
+        self.sun -= cost
+        return True
+
+    def remove_plant(self, row: int, col: int) -> bool:
+        """
+        Remove (shovel) a plant from the grid
+
+        Returns:
+            True if plant was removed
+        """
+        if not (0 <= row < GRID_ROWS and 0 <= col < GRID_COLS):
+            return False
+        lane = board_lanes(0, row)
+        p = self._plant_grid[lane, col]
+        if p < 0:
+            return False
+        self._sync_plant_countdowns(self.frame)
+        self.plants['is_alive'][p] = False
+        self._plant_grid[lane, col] = -1
+        self._contact_table = None
+        return True
+
+    def spawn_zombie(self, zombie_type: ZombieType, row: int, x: float = 800.0) -> None:
+        """
+        Spawn a zombie on the field
+
+        Args:
+            zombie_type: Type of zombie to spawn
+            row: Row to spawn on (0 to GRID_ROWS - 1)
+            x: Starting x position (default: right edge)
+        """
+        self._add_zombies(np.zeros(1, dtype=np.int64), np.array([int(zombie_type)]),
+                          np.array([row]), np.array([x], dtype=np.float64))
+
+    def get_plant_slot(self, row: int, col: int) -> int:
+        """Get the slot of the alive plant at a grid cell (-1 if empty)"""
+        return int(self._plant_grid[board_lanes(0, row), col])
+
+    @property
+    def alive_zombie_count(self) -> int:
+        """Get count of alive zombies"""
+        return int(np.count_nonzero(self.zombies['is_alive']))
+
+    @property
+    def alive_plant_count(self) -> int:
+        """Get count of alive plants"""
+        return int(np.count_nonzero(self.plants['is_alive']))
+
+    @property
+    def projectile_count(self) -> int:
+        """Get count of live projectiles"""
+        return int(np.count_nonzero(self.projectiles['is_alive']))
+
+    # ========================================================================
+    # Conversion
+    # ========================================================================
+
+    @classmethod
+    def from_simulator(cls, sim: GameSimulator) -> ArraySimulator:
+        """
+        Build an array simulator holding the same board as a GameSimulator
+
+        Args:
+            sim: Source simulator (not modified)
+        """
+        new = cls(sun=sim.sun, scene=sim.scene)
+        new.frame = sim.frame
+        new._plant_sync_frame = sim.frame
+        new.wave = sim.wave
+        new.is_game_over = sim.is_game_over
+        new.is_win = sim.is_win
+        new._row_count = sim._row_count
+        new._load_board(sim, 0)
+        new._next_plant_ids[0] = sim._next_plant_id
+        new._next_zombie_ids[0] = sim._next_zombie_id
+        new._next_projectile_ids[0] = sim._next_projectile_id
+        return new
+
+    def to_simulator(self) -> GameSimulator:
+        """
+        Build a GameSimulator holding the same board
+
+        Zombies already compacted away are not included; every alive entity is.
+        """
+        sim = GameSimulator(sun=self.sun, scene=self.scene)
+        sim.frame = self.frame
+        sim.wave = self.wave
+        sim.is_game_over = self.is_game_over
+        sim.is_win = self.is_win
+        sim._row_count = self._row_count
+        return self._export_board(0, sim)
@@ -0,0 +1,312 @@
+"""
+Headless Game Module
+A simulated PVZ level behind the surface of PVZMemoryInterface
+
+HeadlessInterface plays a level on a GameSimulator, with zombies from a
+WaveSpawner, so OptimalBot and LLMBot run end to end without the game
+(e.g. on a Linux CI box), at real speed, faster, or as fast as the bot
+polls. What the simulator does not model is kept simple:
+- Sun falls from the sky every SKY_SUN_INTERVAL and sunflowers make sun
+  every SUNFLOWER_SUN_INTERVAL; both wait as items for collect_all_items()
+- Seed cards recharge for their PLANT_RECHARGE after planting
+- Ash plants explode when planted (apply_action, as in MCTS rollouts)
+- A zombie past LAWNMOWER_X sets off its row's lawnmower, which kills
+  every zombie in the row; past a used lawnmower it ends the level
+"""
+
+import math
+import threading
+import time
+from typing import Dict, List, Optional, Sequence
+
+from data.plants import PlantType, PLANT_HP, PLANT_RECHARGE
+from data.zombies import ZOMBIE_HP_DATA
+from engine.action import Action, ActionType
+from engine.optimizer import apply_action
+from engine.simulator import GameSimulator
+from engine.wave_spawner import WaveConfig, WaveSpawner, create_standard_waves
+from game.grid import Grid
+from game.lawnmower import LawnmowerInfo
+from game.plant import PlantInfo
+from game.projectile import ProjectileInfo
+from game.state import GameState, SeedInfo
+from game.zombie import ZombieInfo
+
+
+# Seed cards of a headless level
+DEFAULT_DECK = [
+    PlantType.SUNFLOWER,
+    PlantType.PEASHOOTER,
+    PlantType.SNOW_PEA,
+    PlantType.REPEATER,
+    PlantType.WALLNUT,
+    PlantType.CHERRY_BOMB,
+    PlantType.JALAPENO,
+]
+
+SUN_VALUE = 25  # Sun per collected item
+SKY_SUN_INTERVAL = 600  # cs between falling suns (about a day level's)
+SUNFLOWER_SUN_INTERVAL = 2400  # cs between two suns of a sunflower
+SUN_LIFETIME = 800  # cs an uncollected sun stays on the lawn
+
+LAWNMOWER_X = 20.0  # A zombie left of this sets off its row's lawnmower
+LAWNMOWER_DAMAGE = 1 << 20  # Kills anything
+
+# Most frames ticked between two lawnmower checks: a zombie walks less than
+# 5 px in them, so none reaches the house (x < 0) unchecked
+_LAWNMOWER_CHECK_FRAMES = 5
+
+FIRST_WAVE_DELAY = 1800  # cs before the first wave
+WAVE_INTERVAL = 2500  # cs between the end of a wave's spawns and the next wave
+
+# Plants that explode when planted, as the action apply_action() models
+_ASH_ACTIONS = {
+    PlantType.CHERRY_BOMB: ActionType.USE_CHERRY,
+    PlantType.JALAPENO: ActionType.USE_JALAPENO,
+}
+
+
+def create_level_waves(total_waves: int = 20) -> List[WaveConfig]:
+    """The standard waves, paced about as far apart as the game's"""
+    waves = create_standard_waves(total_waves)
+    for wave in waves:
+        wave.spawn_delay = WAVE_INTERVAL
+    waves[0].spawn_delay = 0
+    return waves
+
+
+class HeadlessInterface:
+    """
+    Simulated game with the methods of PVZMemoryInterface
+    
+    The level advances when a state is read: with speed > 0 up to the
+    game time of the wall time since attach() (1.0 is real time), with
+    speed 0 by frames_per_poll frames per get_game_state(), so the game
+    runs exactly as fast as the bot polls it. Methods may be called from
+    the poller and the decision threads at once.
+    """
+    
+    def __init__(self, waves: Optional[List[WaveConfig]] = None,
+                 deck: Sequence[PlantType] = DEFAULT_DECK, sun: int = 50,
+                 speed: float = 0.0, frames_per_poll: int = 5):
+        """
+        Initialize the level
+        
+        Args:
+            waves: Waves of the level (default: create_level_waves())
+            deck: Seed cards in hand
+            sun: Sun at the start
+            speed: Game time per wall time (0: frames_per_poll per state read)
+            frames_per_poll: Frames a state read advances when speed is 0
+                (5 frames are BotConfig.refresh_rate)
+        """
+        self.waves = waves if waves is not None else create_level_waves()
+        self.deck = list(deck)
+        self.start_sun = sun
+        self.speed = speed
+        self.frames_per_poll = frames_per_poll
+        self.sim: Optional[GameSimulator] = None
+        self.spawner: Optional[WaveSpawner] = None
+        self.reader = None  # No memory to count reads of
+        self.polls = 0
+        self.actions = 0  # Plants and shovels done
+        self._recharge: List[int] = []  # Remaining cooldown per seed card
+        self._sun_items: List[int] = []  # Frames the uncollected suns fell at
+        self._next_sun: Dict[int, int] = {}  # Plant ID -> frame of its next sun
+        self._next_sky_sun = SKY_SUN_INTERVAL
+        self._lawnmowers: List[int] = []  # Rows whose lawnmower is unused
+        self._start_time = 0.0
+        self._lock = threading.Lock()
+    
+    def attach(self) -> bool:
+        """Start the level"""
+        self.sim = GameSimulator(sun=self.start_sun)
+        self.spawner = WaveSpawner(self.waves, initial_delay=FIRST_WAVE_DELAY)
+        self._recharge = [0] * len(self.deck)
+        self._lawnmowers = list(range(self.sim._row_count))
+        self._start_time = time.perf_counter()
+        return True
+    
+    def is_attached(self) -> bool:
+        """Check if the level has started"""
+        return self.sim is not None
+    
+    def is_in_game(self) -> bool:
+        """Check if in game (until the level ends)"""
+        return self.sim is not None and not self.finished
+    
+    @property
+    def finished(self) -> bool:
+        """Whether the level is over"""
+        return self.sim is not None and (self.sim.is_game_over or self.won)
+    
+    @property
+    def won(self) -> bool:
+        """Whether every wave was spawned and killed"""
+        return (self.spawner is not None and self.spawner.is_finished()
+                and self.sim.alive_zombie_count == 0)
+    
+    def get_game_state(self) -> Optional[GameState]:
+        """Advance the level and read its state"""
+        if self.sim is None:
+            return None
+        with self._lock:
+            if self.speed > 0:
+                target = int((time.perf_counter() - self._start_time) * 100 * self.speed)
+                self._advance(target - self.sim.frame)
+            elif self.polls:
+                self._advance(self.frames_per_poll)
+            self.polls += 1
+            return self._build_state()
+    
+    def require_fresh(self, *sections: str) -> None:
+        """Every state is read whole: nothing to schedule"""
+    
+    def close(self):
+        """Nothing to release"""
+    
+    def plant(self, row: int, col: int, plant_type: int) -> bool:
+        """Plant at position (a ready seed card and enough sun needed)"""
+        with self._lock:
+            if self.sim is None or plant_type not in self.deck:
+                return False
+            index = self.deck.index(plant_type)
+            if self._recharge[index] > 0:
+                return False
+            plant_type = PlantType(plant_type)
+            action = Action(_ASH_ACTIONS.get(plant_type, ActionType.PLANT), row=row, col=col,
+                            plant_type=plant_type)
+            if not apply_action(self.sim, action):
+                return False
+            self._recharge[index] = PLANT_RECHARGE.get(plant_type, 750)
+            self.actions += 1
+            return True
+    
+    def shovel(self, row: int, col: int) -> bool:
+        """Remove plant at position"""
+        with self._lock:
+            if self.sim is None or not self.sim.remove_plant(row, col):
+                return False
+            self.actions += 1
+            return True
+    
+    def execute_batch(self, actions: List[Action],
+                      state: Optional[GameState] = None) -> List[bool]:
+        """Execute several actions in order (cob cannons are not simulated)"""
+        results = []
+        for action in actions:
+            if action.is_plant_action:
+                results.append(self.plant(action.row, action.col, action.plant_type))
+            elif action.action_type == ActionType.SHOVEL:
+                results.append(self.shovel(action.row, action.col))
+            else:
+                results.append(False)
+        return results
+    
+    def collect_all_items(self) -> int:
+        """Collect the suns on the lawn"""
+        with self._lock:
+            count = len(self._sun_items)
+            if self.sim is not None:
+                self.sim.sun += count * SUN_VALUE
+            self._sun_items = []
+            return count
+    
+    @property
+    def pid(self) -> Optional[int]:
+        """No process"""
+        return None
+    
+    # ========================================================================
+    # Simulation
+    # ========================================================================
+    
+    def _advance(self, frames: int) -> None:
+        """Run the level for some frames, spawning zombies as the waves come"""
+        if frames <= 0:
+            return
+        sim = self.sim
+        quiet = 0  # Frames without spawns, ticked together
+        for _ in range(frames):
+            if sim.is_game_over:
+                break
+            spawns = self.spawner.update(sim.frame + quiet)
+            if spawns or quiet == _LAWNMOWER_CHECK_FRAMES:
+                self._tick(quiet)
+                quiet = 0
+            for zombie_type, row in spawns:
+                sim.spawn_zombie(zombie_type, row)
+            if spawns:
+                sim.wave = self.spawner.current_wave
+            quiet += 1
+        self._tick(quiet)
+        
+        self._recharge = [max(0, countdown - frames) for countdown in self._recharge]
+        self._drop_sun()
+    
+    def _tick(self, frames: int) -> None:
+        """Tick the simulator, then set off the lawnmowers zombies reached"""
+        self.sim.tick_n(frames)
+        for zombie in self.sim.zombies:
+            if zombie.is_alive and zombie.x < LAWNMOWER_X and zombie.row in self._lawnmowers:
+                self._lawnmowers.remove(zombie.row)
+                self.sim.damage_zombies_in_area([zombie.row], -math.inf, math.inf,
+                                                LAWNMOWER_DAMAGE)
+    
+    def _drop_sun(self) -> None:
+        """Add the suns that fell or grew by now; remove those that faded"""
+        frame = self.sim.frame
+        while self._next_sky_sun <= frame:
+            self._sun_items.append(self._next_sky_sun)
+            self._next_sky_sun += SKY_SUN_INTERVAL
+        
+        sunflowers = set()
+        for plant in self.sim.plants:
+            if not plant.is_alive or plant.type != PlantType.SUNFLOWER:
+                continue
+            sunflowers.add(plant.id)
+            next_sun = self._next_sun.setdefault(plant.id, frame + SUNFLOWER_SUN_INTERVAL)
+            while next_sun <= frame:
+                self._sun_items.append(next_sun)
+                next_sun += SUNFLOWER_SUN_INTERVAL
+            self._next_sun[plant.id] = next_sun
+        self._next_sun = {plant_id: next_sun for plant_id, next_sun in self._next_sun.items()
+                          if plant_id in sunflowers}
+        self._sun_items = [fell for fell in self._sun_items if frame - fell < SUN_LIFETIME]
+    
+    def _build_state(self) -> GameState:
+        """The level as GameReader would read it; entity IDs stand for array slots"""
+        sim = self.sim
+        plants = [PlantInfo(index=plant.id, row=plant.row, col=plant.col, type=int(plant.type),
+                            hp=plant.health, hp_max=PLANT_HP.get(plant.type, 300), state=0,
+                            shoot_countdown=plant.attack_countdown, effective=True)
+                  for plant in sim.plants if plant.is_alive]
+        zombies = []
+        for zombie in sim.zombies:
+            if not zombie.is_alive:
+                continue
+            zombies.append(ZombieInfo(
+                index=zombie.id, row=zombie.row, x=zombie.x, y=0.0, type=int(zombie.type),
+                hp=zombie.body_health, hp_max=ZOMBIE_HP_DATA.get(zombie.type, (270, 0))[0],
+                accessory_hp=zombie.armor_health, state=0, speed=zombie.effective_speed,
+                slow_countdown=zombie.slow_countdown, freeze_countdown=zombie.freeze_countdown,
+                butter_countdown=0, at_wave=sim.wave, is_eating=zombie.is_eating))
+        projectiles = [ProjectileInfo(index=proj.id, x=proj.x, y=proj.y, row=proj.row,
+                                      type=int(proj.type), exist_time=0, is_dead=False)
+                       for proj in sim.projectiles if proj.is_alive]
+        seeds = [SeedInfo(index=index, type=int(plant_type), recharge_countdown=countdown,
+                          recharge_time=PLANT_RECHARGE.get(plant_type, 750),
+                          usable=countdown <= 0)
+                 for index, (plant_type, countdown) in enumerate(zip(self.deck, self._recharge))]
+        
+        lawnmowers = [LawnmowerInfo(index=row, row=row, x=-20.0, state=0, is_dead=False)
+                      for row in self._lawnmowers]
+        
+        plant_grid = Grid()
+        for plant in plants:
+            plant_grid.set(plant.row, plant.col, plant)
+        
+        return GameState(sun=sim.sun, wave=sim.wave, total_waves=self.spawner.total_waves,
+                         game_clock=sim.frame, global_clock=sim.frame, scene=sim.scene,
+                         zombies=zombies, plants=plants, seeds=seeds, projectiles=projectiles,
+                         lawnmowers=lawnmowers, plant_grid=plant_grid)
@@ -2,19 +2,36 @@
 Action Optimizer
 Evaluates and optimizes actions for best decision making
 
-This module provides the core optimization algorithm interface.
-Future implementations can include MCTS, reinforcement learning, etc.
+This module provides the core optimization algorithm interface: the
+rule-based ActionOptimizer and an MCTSOptimizer that searches the same
+candidates with GameSimulator rollouts. Future implementations can include
+reinforcement learning, etc.
 """
 
-from typing import List, Optional, Callable, Dict, Any
+from __future__ import annotations
+from typing import List, Optional, Callable, Dict, Any, Tuple
 from dataclasses import dataclass
 from abc import ABC, abstractmethod
+import math
+import random
+import time
 
 from game.state import GameState
 from engine.action import Action, ActionType
 from engine.analyzer import ThreatAnalyzer, ResourceAnalyzer
 from engine.strategy import StrategyPlanner
-from data.plants import PlantType, PLANT_COST
+from engine.simulator import GameSimulator, GameState as SimState, Plant, Zombie, Projectile
+from data.plants import PlantType, PLANT_COST, ATTACKING_PLANTS, DEFENSIVE_PLANTS
+from data.zombies import ZombieType
+from data.projectiles import ProjectileType, PROJECTILE_SPEED
+from data.constants import (
+    GRID_WIDTH,
+    LAWN_LEFT_X,
+    LAWN_RIGHT_X,
+    CHERRY_EXPLODE_RADIUS,
+    CHERRY_DAMAGE,
+    JALAPENO_DAMAGE,
+)
 
 
 @dataclass
@@ -47,6 +64,14 @@ class BaseOptimizer(ABC):
     def evaluate_action(self, state: GameState, action: Action) -> ActionEvaluation:
         """Evaluate a single action"""
         pass
+    
+    def warm_up(self) -> None:
+        """Start what decisions need (worker processes, etc.) ahead of the first one"""
+        pass
+    
+    def close(self) -> None:
+        """Release resources held by the optimizer (worker processes, etc.)"""
+        pass
 
 
 class ActionOptimizer(BaseOptimizer):
@@ -295,27 +320,577 @@ class ActionOptimizer(BaseOptimizer):
         return actions
 
 
+# ============================================================================
+# Simulator Bridge
+# ============================================================================
+
+# Entity types the simulator knows
+_SIM_PLANT_TYPES = set(PlantType)
+_SIM_ZOMBIE_TYPES = set(ZombieType)
+
+
+def build_simulator(state: GameState) -> GameSimulator:
+    """
+    Build a GameSimulator holding the board of a game state read from memory
+    
+    Entities the simulator cannot model (unknown types, dying zombies, cob
+    cannon shells) are left out.
+    
+    Args:
+        state: Game state from the reader
+        
+    Returns:
+        GameSimulator at the state's game clock
+    """
+    sim = GameSimulator(sun=state.sun, scene=state.scene)
+    sim.frame = state.game_clock
+    sim.wave = state.wave
+    
+    for info in state.alive_plants:
+        if info.type not in _SIM_PLANT_TYPES:
+            continue
+        plant = Plant.create(PlantType(info.type), info.row, info.col, len(sim.plants))
+        plant.health = info.hp
+        if plant.type in ATTACKING_PLANTS:
+            plant.attack_countdown = max(info.shoot_countdown, 1)
+        sim.plants.append(plant)
+        sim._plant_grid[(info.row, info.col)] = plant.id
+    sim._next_plant_id = len(sim.plants)
+    
+    for info in state.alive_zombies:
+        if info.is_dying or info.type not in _SIM_ZOMBIE_TYPES:
+            continue
+        zombie = Zombie.create(ZombieType(info.type), info.row, info.x, len(sim.zombies))
+        zombie.body_health = info.hp
+        zombie.armor_health = info.accessory_hp
+        zombie.slow_countdown = info.slow_countdown
+        zombie.is_slowed = info.slow_countdown > 0
+        zombie.freeze_countdown = info.freeze_countdown
+        zombie.is_frozen = info.freeze_countdown > 0
+        sim.zombies.append(zombie)
+    sim._next_zombie_id = len(sim.zombies)
+    
+    for info in state.projectiles:
+        if info.is_dead or info.is_cob or info.type not in PROJECTILE_SPEED:
+            continue
+        sim.projectiles.append(Projectile.create(ProjectileType(info.type), info.row, info.x,
+                                                 proj_id=len(sim.projectiles)))
+    sim._next_projectile_id = len(sim.projectiles)
+    return sim
+
+
+def apply_action(sim: GameSimulator, action: Action) -> bool:
+    """
+    Apply a bot action to a simulated board
+    
+    Ash plants explode at once instead of after their fuse; actions the
+    simulator has no model for (cob, ice, doom, sun collection) do nothing.
+    
+    Returns:
+        True if the action changed the board
+    """
+    action_type = action.action_type
+    if action_type == ActionType.PLANT:
+        plant_type = PlantType(action.plant_type)
+        if plant_type in DEFENSIVE_PLANTS and sim.get_plant_at(action.row, action.col):
+            # Walls are planted over worn walls
+            if sim.sun < PLANT_COST.get(plant_type, 100):
+                return False
+            sim.remove_plant(action.row, action.col)
+        return sim.place_plant(plant_type, action.row, action.col)
+    
+    if action_type == ActionType.SHOVEL:
+        return sim.remove_plant(action.row, action.col)
+    
+    if action_type in (ActionType.USE_CHERRY, ActionType.USE_JALAPENO):
+        cost = action.sun_cost
+        if sim.sun < cost:
+            return False
+        sim.sun -= cost
+        if action_type == ActionType.USE_CHERRY:
+            x = LAWN_LEFT_X + action.col * GRID_WIDTH + GRID_WIDTH / 2
+            sim.damage_zombies_in_area([action.row - 1, action.row, action.row + 1],
+                                       x - CHERRY_EXPLODE_RADIUS, x + CHERRY_EXPLODE_RADIUS,
+                                       CHERRY_DAMAGE)
+        else:
+            sim.damage_zombies_in_area([action.row], -math.inf, math.inf, JALAPENO_DAMAGE)
+        return True
+    
+    return False
+
+
+def _action_key(action: Action) -> tuple:
+    """Identity of an action across planner runs"""
+    return (action.action_type, action.plant_type, action.row, action.col)
+
+
+def board_scale(sim: GameSimulator) -> Tuple[int, int]:
+    """Get (zombie HP, plant HP) of a starting board, the scale of evaluate_board"""
+    return (sum(z.total_health for z in sim.zombies if z.is_alive),
+            sum(p.health for p in sim.plants if p.is_alive))
+
+
+def evaluate_board(sim: GameSimulator, zombie_hp: int, plant_hp: int) -> float:
+    """
+    Score a simulated board in [0, 1] (0 = lost)
+    
+    Averages three terms: share of the starting zombie HP destroyed, how far
+    the closest zombie still is from the house, and share of the starting
+    plant HP left.
+    
+    Args:
+        sim: Board to score
+        zombie_hp: Total zombie HP on the starting board
+        plant_hp: Total plant HP on the starting board
+    """
+    if sim.is_game_over:
+        return 0.0
+    
+    remaining_hp = 0
+    closest_x = LAWN_RIGHT_X
+    for zombie in sim.zombies:
+        if zombie.is_alive:
+            remaining_hp += zombie.total_health
+            closest_x = min(closest_x, zombie.x)
+    damage = 1.0 - remaining_hp / zombie_hp if zombie_hp > 0 else 1.0
+    safety = max(0.0, min(1.0, closest_x / LAWN_RIGHT_X))
+    
+    plants = 1.0
+    if plant_hp > 0:
+        plants = min(1.0, sum(p.health for p in sim.plants if p.is_alive) / plant_hp)
+    return (max(0.0, damage) + safety + plants) / 3.0
+
+
+# How far a predicted board may be off an observed one and still be reused:
+# a few frames of walking, and about two pea hits or bites of health
+REUSE_X_TOLERANCE = 8.0
+REUSE_HP_TOLERANCE = 40
+
+
+def boards_agree(state: SimState, board: GameSimulator) -> bool:
+    """
+    Check that a predicted board still describes an observed one
+    
+    Plants must match by type and cell, and zombies by row and type, with
+    positions and health within the REUSE tolerances. Sun and projectiles
+    are not compared; neither is a frame offset of a few frames.
+    
+    Args:
+        state: Predicted board (a search node's snapshot)
+        board: Observed board
+    """
+    predicted = sorted((p.row, p.col, p.type, p.health) for p in state.alive_plants)
+    observed = sorted((p.row, p.col, p.type, p.health) for p in board.plants if p.is_alive)
+    if len(predicted) != len(observed):
+        return False
+    for (row, col, plant_type, health), (row2, col2, plant_type2, health2) in zip(predicted, observed):
+        if (row, col, plant_type) != (row2, col2, plant_type2) or abs(health - health2) > REUSE_HP_TOLERANCE:
+            return False
+    
+    predicted = sorted((z.row, z.type, z.x, z.total_health) for z in state.alive_zombies)
+    observed = sorted((z.row, z.type, z.x, z.total_health) for z in board.zombies if z.is_alive)
+    if len(predicted) != len(observed):
+        return False
+    for (row, zombie_type, x, health), (row2, zombie_type2, x2, health2) in zip(predicted, observed):
+        if ((row, zombie_type) != (row2, zombie_type2) or abs(x - x2) > REUSE_X_TOLERANCE
+                or abs(health - health2) > REUSE_HP_TOLERANCE):
+            return False
+    return True
+
+
+# ============================================================================
+# Monte Carlo Tree Search
+# ============================================================================
+
+class MCTSNode:
+    """
+    Search tree node: the board one decision interval after an action
+    
+    Candidates used on the way down are not offered again (their seed is
+    recharging), so every path plays each candidate at most once. The
+    simulator and the default policy are deterministic, so a node's rollout
+    is played once, when the node is added.
+    """
+    
+    def __init__(self, state: SimState, action: Optional[Action], depth: int,
+                 candidates: List[Action], parent: Optional[MCTSNode] = None):
+        self.state = state
+        self.action = action
+        self.depth = depth
+        self.parent = parent
+        self.children: List[MCTSNode] = []
+        self.untried: List[Action] = candidates + [Action.wait("Search: wait")]
+        self.candidates = candidates
+        self.visits: int = 0
+        self.value_sum: float = 0.0
+        self.rollout_value: float = 0.0
+    
+    @property
+    def mean_value(self) -> float:
+        """Get average rollout value"""
+        return self.value_sum / self.visits if self.visits else 0.0
+    
+    def select_child(self, exploration: float) -> MCTSNode:
+        """Pick the child with the highest UCB1 score"""
+        log_visits = math.log(self.visits)
+        return max(self.children, key=lambda child: (
+            child.mean_value + exploration * math.sqrt(log_visits / child.visits)))
+
+
+@dataclass
+class MCTSStats:
+    """Statistics of the last search"""
+    simulations: int = 0  # Iterations, including revisits of finished leaves
+    elapsed: float = 0.0  # Seconds
+    nodes: int = 0  # Nodes added, one rollout each
+    reused: int = 0  # Root visits carried over from the previous decision
+    budget: float = 0.0  # Wall-clock seconds allowed
+    untried: int = 0  # Root actions left unsearched when the budget ran out
+    decision: float = 0.0  # Seconds of the whole decision (candidates, board, search)
+    
+    @property
+    def overrun(self) -> float:
+        """Get seconds the decision took beyond its budget"""
+        return max(0.0, self.decision - self.budget)
+    
+    @property
+    def effective_simulations(self) -> int:
+        """Get root visits at the end of the search (reused + new)"""
+        return self.reused + self.simulations
+    
+    @property
+    def simulations_per_second(self) -> float:
+        """Get simulation throughput"""
+        return self.simulations / self.elapsed if self.elapsed > 0 else 0.0
+    
+    @property
+    def rollouts_per_second(self) -> float:
+        """Get throughput of rollouts actually played"""
+        return self.nodes / self.elapsed if self.elapsed > 0 else 0.0
+
+
+@dataclass
+class SearchTree:
+    """A search kept for re-rooting at the next decision"""
+    root: MCTSNode
+    zombie_hp: int  # evaluate_board scale of the tree's first root,
+    plant_hp: int  # kept so old and new values stay comparable
+    action: Optional[Action] = None  # Root action returned from it
+
+
 class MCTSOptimizer(BaseOptimizer):
     """
-    Monte Carlo Tree Search optimizer (placeholder for future implementation)
+    Anytime UCT search over StrategyPlanner candidates
+    
+    The root offers the planner's valid actions plus waiting. Each tree step
+    applies an action (or waits) and advances decision_frames frames in a
+    GameSimulator; a rollout then plays the default policy, waiting, up to
+    horizon_frames from the root and scores the board with evaluate_board.
+    Acting later is left to the tree rather than the rollouts, so a rollout
+    compares acting now against not acting at all. Root actions are tried
+    once each, highest planner priority first and waiting last; after that
+    the search runs until the simulation cap, and returns the root action
+    with the best mean value (a budget of a few dozen simulations is too
+    small for visit counts to settle).
+    
+    The wall-clock budget covers the whole decision: candidates, board and
+    search. The search checks it before every expansion, and does not start
+    one that its longest expansion so far says would end past the budget.
+    Root actions still untried then rank below the tried ones, as their
+    priority does; with none tried, the highest-priority one is returned.
+    
+    The simulator has no sun income or zombie spawns, so the search judges
+    what the current board will do, not the waves to come.
     
-    This would implement proper MCTS for finding optimal action sequences.
+    With reuse_tree, the tree of the last decision is kept and the next
+    decision re-roots it at the node the game has reached (see _reroot), so
+    its statistics count toward the new search.
     """
     
-    def __init__(self, simulations: int = 1000, exploration: float = 1.41):
+    def __init__(self, simulations: int = 1000, exploration: float = 1.41,
+                 time_budget: float = 0.03, decision_frames: int = 15,
+                 horizon_frames: int = 300, reuse_tree: bool = True):
+        """
+        Initialize the search
+        
+        Args:
+            simulations: Most simulations per decision
+            exploration: UCB1 exploration constant
+            time_budget: Wall-clock seconds per decision
+            decision_frames: Frames between decisions (15 = the 0.15 s
+                BotConfig.action_interval)
+            horizon_frames: Frames simulated from the root per simulation
+            reuse_tree: Carry the search tree over to the next decision
+        """
         self.simulations = simulations
         self.exploration = exploration
+        self.time_budget = time_budget
+        self.decision_frames = decision_frames
+        self.horizon_frames = horizon_frames
+        self.reuse_tree = reuse_tree
+        self.rule_based = ActionOptimizer()
+        self.last_stats = MCTSStats()
+        self._tree: Optional[SearchTree] = None
     
     def get_best_action(self, state: GameState) -> Optional[Action]:
-        """MCTS-based action selection (not implemented)"""
-        # Placeholder - falls back to rule-based
-        fallback = ActionOptimizer()
-        return fallback.get_best_action(state)
+        """
+        Search the planner's candidates and return the best one
+        
+        Falls back to waiting when the planner has no valid action, and to
+        the highest-priority candidate when the budget ran out before any
+        root action was searched.
+        """
+        start = time.perf_counter()
+        candidates = self._candidate_actions(state)
+        if not candidates:
+            self.last_stats = MCTSStats(budget=self.time_budget,
+                                        decision=time.perf_counter() - start)
+            return Action.wait("No valid actions")
+        
+        board = build_simulator(state)
+        tree = self._reroot(board, candidates) if self.reuse_tree else None
+        root = self.search(board, candidates, tree=tree, start=start)
+        self.last_stats.decision = time.perf_counter() - start
+        if not root.children:
+            return max(candidates, key=lambda action: action.priority)
+        best = max(root.children, key=lambda child: (child.mean_value, child.visits))
+        if self.reuse_tree:
+            scale = (tree.zombie_hp, tree.plant_hp) if tree is not None else board_scale(board)
+            self._tree = SearchTree(root, *scale, best.action)
+        if best.action.is_wait:
+            return Action.wait("Search prefers waiting")
+        return best.action
     
     def evaluate_action(self, state: GameState, action: Action) -> ActionEvaluation:
-        """MCTS evaluation (not implemented)"""
-        fallback = ActionOptimizer()
-        return fallback.evaluate_action(state, action)
+        """
+        Evaluate an action by searching it against waiting
+        
+        The score is the action's mean rollout value in [0, 1].
+        """
+        evaluation = self.rule_based.evaluate_action(state, action)
+        if not evaluation.is_valid or action.is_wait:
+            return evaluation
+        
+        root = self.search(build_simulator(state), [action])
+        child = next((c for c in root.children if c.action is action), None)
+        if child is None:  # Out of time before the action was searched
+            return evaluation
+        return ActionEvaluation(
+            action=action,
+            score=child.mean_value,
+            components={'mcts_value': child.mean_value, 'visits': float(child.visits)},
+            is_valid=True,
+        )
+    
+    def _candidate_actions(self, state: GameState) -> List[Action]:
+        """Valid planner actions (without waiting)"""
+        plan = StrategyPlanner(state).plan()
+        return [action for action in plan.actions
+                if not action.is_wait and self.rule_based.evaluate_action(state, action).is_valid]
+    
+    # ========================================================================
+    # Search
+    # ========================================================================
+    
+    def search(self, board: GameSimulator, candidates: List[Action],
+               root_actions: Optional[List[int]] = None,
+               rng: Optional[random.Random] = None,
+               tree: Optional[SearchTree] = None,
+               start: Optional[float] = None) -> MCTSNode:
+        """
+        Run UCT from a board until the budget runs out
+        
+        Args:
+            board: Root board (not modified)
+            candidates: Actions to consider besides waiting
+            root_actions: Indices of the root actions to search, where
+                len(candidates) stands for waiting (default: all of them);
+                deeper nodes still offer every unused candidate
+            rng: Shuffles the order nodes try their actions in (default:
+                highest priority first, waiting last at the root; planner
+                order, waiting first, below it)
+            tree: Re-rooted tree of an earlier search (see _reroot) to grow
+                instead of starting afresh; root_actions is then ignored
+            start: time.perf_counter() the budget counts from (default: now)
+            
+        Returns:
+            Root node; its children hold visit counts and values
+        """
+        start = time.perf_counter() if start is None else start
+        deadline = start + self.time_budget
+        sim = board.clone()
+        
+        if tree is not None:
+            zombie_hp, plant_hp = tree.zombie_hp, tree.plant_hp
+            root = tree.root
+            nodes = 0
+        else:
+            zombie_hp, plant_hp = board_scale(board)
+            root = MCTSNode(sim.snapshot(), None, 0, candidates)
+            if root_actions is not None:
+                root.untried = [root.untried[i] for i in root_actions]
+            root.untried = _by_priority(root.untried)
+            if rng is not None:
+                rng.shuffle(root.untried)
+            nodes = 1
+        
+        # Longest expansion so far; the root rollout (a whole horizon) is the first guess
+        expansion_time = 0.0
+        now = time.perf_counter()
+        if tree is None and now < deadline:
+            sim.tick_n(self.horizon_frames, skip_ahead=True)
+            root.rollout_value = evaluate_board(sim, zombie_hp, plant_hp)
+            expansion_time = time.perf_counter() - now
+            now += expansion_time
+        reused = root.visits
+        simulations = 0
+        expanding = now
+        
+        while ((root.untried or simulations < self.simulations)
+               and now + expansion_time < deadline):
+            # Selection
+            node = root
+            while not node.untried and node.children:
+                node = node.select_child(self.exploration)
+            
+            # Expansion and rollout (leaves at the horizon or lost keep their value)
+            if node.untried and not node.state.is_game_over and self._frames_left(node.depth) > 0:
+                sim.restore(node.state)
+                node = self._expand(sim, node, node.untried.pop(), rng)
+                node.rollout_value = self._rollout(sim, node, zombie_hp, plant_hp)
+                nodes += 1
+            else:
+                node.untried = []
+            value = node.rollout_value
+            simulations += 1
+            
+            # Backpropagation
+            while node is not None:
+                node.visits += 1
+                node.value_sum += value
+                node = node.parent
+            
+            now = time.perf_counter()
+            if simulations == 1:
+                expansion_time = 0.0  # Measured expansions replace the guess
+            expansion_time = max(expansion_time, now - expanding)
+            expanding = now
+        
+        self.last_stats = MCTSStats(simulations, time.perf_counter() - start, nodes, reused,
+                                    self.time_budget, len(root.untried))
+        return root
+    
+    def _frames_left(self, depth: int) -> int:
+        """Frames from a node at this depth to the horizon"""
+        return self.horizon_frames - depth * self.decision_frames
+    
+    def _expand(self, sim: GameSimulator, node: MCTSNode, action: Action,
+                rng: Optional[random.Random] = None) -> MCTSNode:
+        """Play an action on the node's (restored) board and add the child"""
+        if action.is_wait:
+            candidates = node.candidates
+        else:
+            apply_action(sim, action)
+            candidates = [c for c in node.candidates if c is not action]
+        sim.tick_n(min(self.decision_frames, self._frames_left(node.depth)), skip_ahead=True)
+        
+        child = MCTSNode(sim.snapshot(), action, node.depth + 1, candidates, node)
+        if rng is not None:
+            rng.shuffle(child.untried)
+        node.children.append(child)
+        return child
+    
+    def _rollout(self, sim: GameSimulator, node: MCTSNode, zombie_hp: int,
+                 plant_hp: int) -> float:
+        """Play the default policy (wait) from the node's board to the horizon"""
+        sim.tick_n(self._frames_left(node.depth), skip_ahead=True)
+        return evaluate_board(sim, zombie_hp, plant_hp)
+    
+    # ========================================================================
+    # Tree Reuse
+    # ========================================================================
+    
+    def _reroot(self, board: GameSimulator, candidates: List[Action]) -> Optional[SearchTree]:
+        """
+        Re-root the last decision's tree at the observed board
+        
+        The game has moved on from the old root by playing the returned
+        action (or nothing, if it was not carried out) and then waiting. Of
+        the nodes on those two paths, the one closest in frames to the board
+        becomes the new root if boards_agree with it; otherwise the tree is
+        dropped. Its board is replaced by the observed one, and children
+        whose action is no longer a candidate (seed recharging, cell taken,
+        not affordable) are pruned along with their subtrees. Deeper nodes
+        keep their predicted boards and values, which makes the carried
+        statistics an approximation of a few frames.
+        
+        Args:
+            board: Observed board (not modified)
+            candidates: Current candidate actions
+        
+        Returns:
+            Tree to grow, or None to search afresh
+        """
+        tree, self._tree = self._tree, None
+        if tree is None:
+            return None
+        node = self._matching_node(tree, board)
+        if node is None:
+            return None
+        
+        # Detach the subtree and make its depths relative to the new root
+        node.parent = None
+        node.action = None
+        node.state = board.snapshot()
+        offset = node.depth
+        if offset:
+            stack = [node]
+            while stack:
+                current = stack.pop()
+                current.depth -= offset
+                stack.extend(current.children)
+        
+        # Prune children whose action is gone; match the rest to the new candidates
+        current_by_key = {_action_key(action): action for action in candidates}
+        kept = []
+        for child in node.children:
+            if child.action.is_wait:
+                kept.append(child)
+                continue
+            action = current_by_key.pop(_action_key(child.action), None)
+            if action is not None:
+                child.action = action
+                kept.append(child)
+        node.children = kept
+        node.candidates = candidates
+        node.untried = list(current_by_key.values())
+        if not any(child.action.is_wait for child in kept):
+            node.untried.append(Action.wait("Search: wait"))
+        node.untried = _by_priority(node.untried)
+        node.visits = sum(child.visits for child in kept)
+        node.value_sum = sum(child.value_sum for child in kept)
+        return SearchTree(node, tree.zombie_hp, tree.plant_hp)
+    
+    def _matching_node(self, tree: SearchTree, board: GameSimulator) -> Optional[MCTSNode]:
+        """Find the node of a kept tree that the observed board has reached"""
+        root = tree.root
+        starts = [child for child in root.children if child.action is tree.action]
+        starts += [child for child in root.children if child.action.is_wait and child not in starts]
+        path = [root]
+        for node in starts:
+            while node is not None:
+                path.append(node)
+                node = next((child for child in node.children if child.action.is_wait), None)
+        
+        path = [node for node in path if node.state is not None
+                and abs(node.state.frame - board.frame) <= self.decision_frames]
+        path.sort(key=lambda node: abs(node.state.frame - board.frame))
+        return next((node for node in path if boards_agree(node.state, board)), None)
+
+
+def _by_priority(actions: List[Action]) -> List[Action]:
+    """Root actions ordered to be popped from the end: waiting first, then rising priority"""
+    return sorted(actions, key=lambda action: (not action.is_wait, action.priority))
 
 
 class RLOptimizer(BaseOptimizer):
@@ -0,0 +1,206 @@
+"""
+Root-Parallel MCTS
+Spreads MCTSOptimizer's search over a persistent pool of worker processes
+
+Each decision deals the root actions (planner candidates plus waiting)
+round-robin to the workers. A worker searches its share of the root, with
+every candidate still offered below it, on its own GameSimulator until the
+deadline; the parent then adds up visit counts and value sums per root
+action and picks the best mean value, like the serial search.
+
+Rollouts are deterministic, so two workers given the same root action would
+grow the same tree. Workers beyond the number of root actions share actions
+with the first ones and shuffle the order they try actions in instead.
+
+Boards are sent as encode_state() bytes; only the candidate actions are
+pickled.
+"""
+
+from __future__ import annotations
+import multiprocessing
+import random
+import time
+from typing import List, Optional
+
+from engine.action import Action
+from engine.optimizer import MCTSOptimizer, MCTSNode, MCTSStats, SearchTree
+from engine.simulator import GameSimulator, encode_state, decode_state
+
+
+# ============================================================================
+# Worker Process
+# ============================================================================
+
+def _worker_main(conn, simulations: int, exploration: float, decision_frames: int,
+                 horizon_frames: int) -> None:
+    """
+    Search boards received on conn until None arrives
+    
+    A task is (encoded board, scene, candidates, root action indices, budget,
+    seed); the reply is ([(root action index, visits, value sum), ...],
+    simulations, nodes).
+    """
+    search = MCTSOptimizer(simulations, exploration, 0.0, decision_frames, horizon_frames)
+    boards = {}  # One simulator per scene, reused for every decision
+    while True:
+        task = conn.recv()
+        if task is None:
+            break
+        data, scene, candidates, root_actions, budget, seed = task
+        board = boards.get(scene)
+        if board is None:
+            board = boards[scene] = GameSimulator(scene=scene)
+        board.restore(decode_state(data))
+        
+        search.time_budget = budget
+        root = search.search(board, candidates, root_actions, random.Random(seed))
+        index = {id(action): i for i, action in enumerate(candidates)}
+        children = [(index.get(id(child.action), len(candidates)), child.visits, child.value_sum)
+                    for child in root.children]
+        conn.send((children, search.last_stats.simulations, search.last_stats.nodes))
+    conn.close()
+
+
+# ============================================================================
+# Parallel Optimizer
+# ============================================================================
+
+class ParallelMCTSOptimizer(MCTSOptimizer):
+    """
+    MCTSOptimizer whose search runs in worker processes
+    
+    Workers start with warm_up() and run until close(); use the optimizer
+    as a context manager or close it when done. A search without them
+    starts them itself, at the cost of its own budget. The root returned
+    by search() holds merged statistics only: its children have no board,
+    so the tree is not reused between decisions.
+    """
+    
+    def __init__(self, workers: int = 4, simulations: int = 1000, exploration: float = 1.41,
+                 time_budget: float = 0.03, decision_frames: int = 15,
+                 horizon_frames: int = 300, merge_reserve: float = 0.003):
+        """
+        Initialize the optimizer (no process is started yet)
+        
+        Args:
+            workers: Worker processes
+            simulations: Most simulations per decision, split between workers
+            exploration: UCB1 exploration constant
+            time_budget: Wall-clock seconds per decision
+            decision_frames: Frames between decisions
+            horizon_frames: Frames simulated from the root per simulation
+            merge_reserve: Seconds of the budget kept for sending boards and
+                merging results
+        """
+        if workers <= 0:
+            raise ValueError(f"workers must be positive, got {workers}")
+        super().__init__(simulations, exploration, time_budget, decision_frames, horizon_frames,
+                         reuse_tree=False)
+        self.workers = workers
+        self.merge_reserve = merge_reserve
+        self._connections: List = []
+        self._processes: List = []
+        self._searches = 0
+    
+    def __enter__(self) -> ParallelMCTSOptimizer:
+        return self
+    
+    def __exit__(self, *exc) -> None:
+        self.close()
+    
+    # ========================================================================
+    # Worker Pool
+    # ========================================================================
+    
+    def warm_up(self) -> None:
+        """Start the worker processes if they are not running"""
+        if self._processes:
+            return
+        context = multiprocessing.get_context()
+        settings = (max(1, self.simulations // self.workers), self.exploration,
+                    self.decision_frames, self.horizon_frames)
+        for _ in range(self.workers):
+            parent_conn, child_conn = context.Pipe()
+            process = context.Process(target=_worker_main, args=(child_conn, *settings),
+                                      daemon=True)
+            process.start()
+            child_conn.close()
+            self._connections.append(parent_conn)
+            self._processes.append(process)
+    
+    def close(self) -> None:
+        """Stop the worker processes"""
+        for conn in self._connections:
+            try:
+                conn.send(None)
+            except (BrokenPipeError, OSError):
+                pass
+            conn.close()
+        for process in self._processes:
+            process.join(timeout=1.0)
+            if process.is_alive():
+                process.terminate()
+        self._connections = []
+        self._processes = []
+    
+    # ========================================================================
+    # Search
+    # ========================================================================
+    
+    def search(self, board: GameSimulator, candidates: List[Action],
+               root_actions: Optional[List[int]] = None,
+               rng: Optional[random.Random] = None,
+               tree: Optional[SearchTree] = None,
+               start: Optional[float] = None) -> MCTSNode:
+        """
+        Search a board in the workers and merge their root statistics
+        
+        Args:
+            board: Root board (not modified)
+            candidates: Actions to consider besides waiting
+            root_actions: Indices of the root actions to search, where
+                len(candidates) stands for waiting (default: all of them)
+            rng: Seeds the workers' shuffles (default: a per-search counter)
+            tree: Ignored; the workers' trees are not kept between searches
+            start: time.perf_counter() the budget counts from (default: now)
+        
+        Returns:
+            Root node whose children hold the merged visit counts and values
+        """
+        start = time.perf_counter() if start is None else start
+        self.warm_up()
+        
+        state = board.snapshot()
+        data = encode_state(state)
+        if root_actions is None:
+            root_actions = list(range(len(candidates) + 1))
+        budget = max(0.0, start + self.time_budget - self.merge_reserve - time.perf_counter())
+        seed = rng.getrandbits(32) if rng is not None else self._searches * self.workers
+        self._searches += 1
+        
+        for worker, conn in enumerate(self._connections):
+            share = root_actions[worker::self.workers] or [root_actions[worker % len(root_actions)]]
+            conn.send((data, board.scene, candidates, share, budget, seed + worker))
+        
+        root = MCTSNode(state, None, 0, candidates)
+        options, root.untried = root.untried, []
+        merged = {}
+        simulations = nodes = 0
+        for conn in self._connections:
+            children, worker_simulations, worker_nodes = conn.recv()
+            simulations += worker_simulations
+            nodes += worker_nodes
+            for index, visits, value_sum in children:
+                child = merged.get(index)
+                if child is None:
+                    child = merged[index] = MCTSNode(None, options[index], 1, [], root)
+                    root.children.append(child)
+                child.visits += visits
+                child.value_sum += value_sum
+                root.visits += visits
+                root.value_sum += value_sum
+        
+        self.last_stats = MCTSStats(simulations, time.perf_counter() - start, nodes,
+                                    budget=self.time_budget,
+                                    untried=len(root_actions) - len(root.children))
+        return root
@@ -19,10 +19,14 @@ Time unit: 1 frame = 1 centisecond (cs) = 10 milliseconds
 """
 
 from __future__ import annotations
-from dataclasses import dataclass, field
+from bisect import bisect_left, bisect_right
+from dataclasses import dataclass, fields
+from itertools import starmap
+from operator import attrgetter
 from typing import List, Optional, Dict, Tuple
 from enum import IntEnum
-import copy
+import math
+import struct
 
 from data.plants import (
     PlantType,
@@ -64,6 +68,30 @@ from data.constants import (
 )
 
 
+# ============================================================================
+# Plant Firing Data
+# ============================================================================
+
+# Projectile fired by each attacking plant (plants missing here never fire)
+PLANT_PROJECTILE_TYPE: Dict[PlantType, ProjectileType] = {
+    PlantType.PEASHOOTER: ProjectileType.PEA,
+    PlantType.SNOW_PEA: ProjectileType.SNOW_PEA,
+    PlantType.REPEATER: ProjectileType.PEA,
+    PlantType.THREEPEATER: ProjectileType.PEA,
+    PlantType.SPLITPEA: ProjectileType.PEA,
+    PlantType.GATLINGPEA: ProjectileType.PEA,
+    PlantType.PUFFSHROOM: ProjectileType.PUFF,
+    PlantType.FUMESHROOM: ProjectileType.FUME,
+    PlantType.SEASHROOM: ProjectileType.PUFF,
+    PlantType.SCAREDYSHROOM: ProjectileType.PUFF,
+    PlantType.CACTUS: ProjectileType.CACTUS,
+    PlantType.CABBAGEPULT: ProjectileType.CABBAGE,
+    PlantType.KERNELPULT: ProjectileType.KERNEL,
+    PlantType.MELONPULT: ProjectileType.MELON,
+    PlantType.WINTERMELON: ProjectileType.WINTERMELON,
+}
+
+
 # ============================================================================
 # Simulator Entity Classes
 # ============================================================================
@@ -197,32 +225,349 @@ class Projectile:
         )
 
 
+# ============================================================================
+# Packed Snapshots
+# ============================================================================
+
+# Entity fields in constructor order; a packed entity is the tuple of its values
+_RECORD_GETTERS = {
+    cls: attrgetter(*(f.name for f in fields(cls)))
+    for cls in (Plant, Zombie, Projectile)
+}
+
+
+def pack_entities(cls: type, entities: List) -> Tuple[tuple, ...]:
+    """
+    Pack entities into immutable records
+    
+    Every entity field is an immutable value, so the records share nothing
+    with the entities and can be unpacked any number of times.
+    
+    Args:
+        cls: Plant, Zombie or Projectile
+        entities: Entities of that class
+    """
+    return tuple(map(_RECORD_GETTERS[cls], entities))
+
+
+def unpack_entities(cls: type, records: Tuple[tuple, ...]) -> List:
+    """Build fresh entities from records made by pack_entities"""
+    return list(starmap(cls, records))
+
+
 @dataclass
 class GameState:
-    """Complete game state snapshot for MCTS"""
+    """
+    Complete game state snapshot for MCTS
+    
+    Entities are stored packed (see pack_entities) rather than as objects,
+    so a snapshot never changes after it is taken: it can be shared between
+    search nodes and restored any number of times.
+    """
     frame: int = 0
     sun: int = 50
-    plants: List[Plant] = field(default_factory=list)
-    zombies: List[Zombie] = field(default_factory=list)
-    projectiles: List[Projectile] = field(default_factory=list)
+    plants: Tuple[tuple, ...] = ()
+    zombies: Tuple[tuple, ...] = ()
+    projectiles: Tuple[tuple, ...] = ()
     wave: int = 0
     is_game_over: bool = False
     is_win: bool = False
     
+    # ((row, col), plant_id) pairs of the plant grid
+    plant_grid: Tuple[Tuple[Tuple[int, int], int], ...] = ()
+    
+    # Next plant, zombie and projectile IDs
+    next_ids: Tuple[int, int, int] = (0, 0, 0)
+    
+    # Entity part of the state hash, if it was up to date
+    entity_hash: Optional[int] = None
+    
     @property
     def alive_plants(self) -> List[Plant]:
         """Get all alive plants"""
-        return [p for p in self.plants if p.is_alive]
+        return [p for p in unpack_entities(Plant, self.plants) if p.is_alive]
     
     @property
     def alive_zombies(self) -> List[Zombie]:
         """Get all alive zombies"""
-        return [z for z in self.zombies if z.is_alive]
+        return [z for z in unpack_entities(Zombie, self.zombies) if z.is_alive]
     
     @property
     def alive_projectiles(self) -> List[Projectile]:
         """Get all alive projectiles"""
-        return [p for p in self.projectiles if p.is_alive]
+        return [p for p in unpack_entities(Projectile, self.projectiles) if p.is_alive]
+
+
+# ============================================================================
+# Binary Snapshots
+# ============================================================================
+
+# Little-endian layout of each packed record: fields in constructor order,
+# the entity type as one byte, positions as doubles
+_PLANT_RECORD = struct.Struct('<Bbbii?i')
+_ZOMBIE_RECORD = struct.Struct('<Bbdiii??i?i?iii')
+_PROJECTILE_RECORD = struct.Struct('<Bbddi?ii')
+_GRID_RECORD = struct.Struct('<bbi')
+
+# frame, sun, wave, flags, plant/zombie/projectile/grid counts, next IDs, entity hash
+_STATE_HEADER = struct.Struct('<qiiBIIIIiiiQ')
+
+_FLAG_GAME_OVER = 1
+_FLAG_WIN = 2
+_FLAG_HASHED = 4
+
+_PLANT_TYPE_BY_VALUE = {t.value: t for t in PlantType}
+_ZOMBIE_TYPE_BY_VALUE = {t.value: t for t in ZombieType}
+_PROJECTILE_TYPE_BY_VALUE = {t.value: t for t in ProjectileType}
+
+
+def encode_state(state: GameState) -> bytes:
+    """
+    Encode a snapshot into a compact byte string
+    
+    Used to ship boards to other processes: a record takes 15-40 bytes and
+    needs no per-object pickling. Positions are kept as doubles, so a
+    decoded board plays on exactly like the original.
+    
+    Args:
+        state: Snapshot from GameSimulator.snapshot()
+    """
+    flags = ((_FLAG_GAME_OVER if state.is_game_over else 0)
+             | (_FLAG_WIN if state.is_win else 0)
+             | (_FLAG_HASHED if state.entity_hash is not None else 0))
+    # The entity hash is a running sum only ever read modulo 2**64
+    entity_hash = (state.entity_hash or 0) & _HASH_MASK
+    parts = [_STATE_HEADER.pack(state.frame, state.sun, state.wave, flags,
+                                len(state.plants), len(state.zombies), len(state.projectiles),
+                                len(state.plant_grid), *state.next_ids, entity_hash)]
+    parts.extend(starmap(_PLANT_RECORD.pack, state.plants))
+    parts.extend(starmap(_ZOMBIE_RECORD.pack, state.zombies))
+    parts.extend(starmap(_PROJECTILE_RECORD.pack, state.projectiles))
+    parts.extend(_GRID_RECORD.pack(row, col, plant_id) for (row, col), plant_id in state.plant_grid)
+    return b''.join(parts)
+
+
+def _decode_records(record: struct.Struct, types: Dict[int, IntEnum], data: memoryview,
+                    offset: int, count: int) -> Tuple[Tuple[tuple, ...], int]:
+    """Decode count records at offset; returns the records and the offset after them"""
+    end = offset + record.size * count
+    records = tuple((types[values[0]],) + values[1:]
+                    for values in record.iter_unpack(data[offset:end]))
+    return records, end
+
+
+def decode_state(data: bytes) -> GameState:
+    """
+    Decode a snapshot made by encode_state
+    
+    Args:
+        data: Encoded snapshot
+        
+    Returns:
+        GameState equal to the encoded one
+    """
+    view = memoryview(data)
+    (frame, sun, wave, flags, plant_count, zombie_count, projectile_count, grid_count,
+     next_plant_id, next_zombie_id, next_projectile_id, entity_hash) = _STATE_HEADER.unpack_from(view)
+    offset = _STATE_HEADER.size
+    plants, offset = _decode_records(_PLANT_RECORD, _PLANT_TYPE_BY_VALUE, view, offset, plant_count)
+    zombies, offset = _decode_records(_ZOMBIE_RECORD, _ZOMBIE_TYPE_BY_VALUE, view, offset, zombie_count)
+    projectiles, offset = _decode_records(_PROJECTILE_RECORD, _PROJECTILE_TYPE_BY_VALUE, view,
+                                          offset, projectile_count)
+    end = offset + _GRID_RECORD.size * grid_count
+    plant_grid = tuple(((row, col), plant_id)
+                       for row, col, plant_id in _GRID_RECORD.iter_unpack(view[offset:end]))
+    return GameState(
+        frame=frame,
+        sun=sun,
+        plants=plants,
+        zombies=zombies,
+        projectiles=projectiles,
+        wave=wave,
+        is_game_over=bool(flags & _FLAG_GAME_OVER),
+        is_win=bool(flags & _FLAG_WIN),
+        plant_grid=plant_grid,
+        next_ids=(next_plant_id, next_zombie_id, next_projectile_id),
+        entity_hash=entity_hash if flags & _FLAG_HASHED else None,
+    )
+
+
+# ============================================================================
+# Event Prediction
+# ============================================================================
+
+# Slack on predicted event distances; float rounding of per-frame position
+# updates is far smaller, so a predicted event frame is never late
+_EVENT_MARGIN = 1e-6
+
+# Most plain ticks run between look-aheads that found no quiet frames
+_EVENT_BACKOFF_LIMIT = 15
+
+
+def _killing_bite_frame(health: int, first_bites: List[int], limit: int) -> int:
+    """
+    Frame of the bite that kills a plant, or limit if it is later
+    
+    Args:
+        health: Plant HP
+        first_bites: Frame of each eating zombie's next bite (they then bite
+            every ZOMBIE_BITE_INTERVAL frames)
+        limit: Last frame of interest
+    """
+    damage = int(ZOMBIE_BITE_DAMAGE)
+    if damage <= 0:
+        return limit
+    needed = max(-(-health // damage), 1)
+    
+    def bites_by(frame: int) -> int:
+        return sum((frame - first) // ZOMBIE_BITE_INTERVAL + 1
+                   for first in first_bites if first <= frame)
+    
+    if bites_by(limit) < needed:
+        return limit
+    low, high = 1, limit
+    while low < high:
+        mid = (low + high) // 2
+        if bites_by(mid) >= needed:
+            high = mid
+        else:
+            low = mid + 1
+    return low
+
+
+# ============================================================================
+# State Hashing
+# ============================================================================
+
+# A board's hash is the sum (mod 2^64) of one key per alive entity plus a key
+# for the board scalars, so a single entity can be added, removed or changed
+# in O(1). Keys are summed rather than XORed so that two identical entities
+# (e.g. peas in the same bucket) do not cancel out.
+#
+# Positions are quantized, so boards whose entities differ by less than a
+# bucket hash alike; every other hashed field is exact. Plant attack and
+# zombie bite countdowns are hashed, which pins down the firing and eating
+# phase of the board without hashing the frame number itself.
+
+_HASH_MASK = (1 << 64) - 1
+
+# Bucket widths of hashed x positions in pixels (a pea moves 3.7 px per frame)
+HASH_ZOMBIE_X_QUANTUM = 1.0
+HASH_PROJECTILE_X_QUANTUM = 4.0
+
+
+def _hash_key(feature: tuple) -> int:
+    """
+    64-bit key of a tuple of ints
+    
+    Int tuple hashes are not salted per process (unlike str hashes), so keys
+    and board hashes agree between processes.
+    """
+    key = (hash(feature) * 0x9E3779B97F4A7C15) & _HASH_MASK
+    return key ^ (key >> 29)
+
+
+def _plant_hash(plant: Plant) -> int:
+    """Hash key of a plant (0 once dead)"""
+    if not plant.is_alive:
+        return 0
+    return _hash_key((1, plant.type, plant.row, plant.col, plant.health, plant.attack_countdown))
+
+
+def _zombie_hash(zombie: Zombie) -> int:
+    """Hash key of a zombie (0 once dead)"""
+    if not zombie.is_alive:
+        return 0
+    return _hash_key((2, zombie.type, zombie.row, int(zombie.x // HASH_ZOMBIE_X_QUANTUM),
+                      zombie.body_health, zombie.armor_health, zombie.shield_health,
+                      zombie.is_slowed, zombie.is_frozen, zombie.is_eating, zombie.eat_countdown))
+
+
+def _projectile_hash(proj: Projectile) -> int:
+    """Hash key of a projectile (0 once dead)"""
+    if not proj.is_alive:
+        return 0
+    return _hash_key((3, proj.type, proj.row, int(proj.x // HASH_PROJECTILE_X_QUANTUM)))
+
+
+# ============================================================================
+# Spatial Index
+# ============================================================================
+
+# Search margin around exact hitbox tests (candidates are re-checked exactly)
+_HIT_SEARCH_MARGIN = 1.0
+
+
+class ZombieRowIndex:
+    """
+    Alive zombies of each row ordered by x
+    
+    Turns projectile hit tests and "zombie ahead" checks into binary
+    searches instead of scans over every zombie. Entries are
+    (x, list position, zombie); the list position keeps the "first zombie
+    in list order" rule of the scans exact.
+    
+    refresh() is called after zombies move: rows are nearly sorted already,
+    so re-sorting is linear. It also drops dead zombies and picks up new
+    ones; a replaced zombie list is indexed from scratch.
+    """
+    
+    def __init__(self):
+        self._rows: Dict[int, List[Tuple[float, int, Zombie]]] = {}
+        self._xs: Dict[int, List[float]] = {}
+        self._source: Optional[List[Zombie]] = None
+        self._indexed_count: int = 0
+    
+    def refresh(self, zombies: List[Zombie]) -> None:
+        """
+        Bring the index up to date with a zombie list
+        
+        Args:
+            zombies: GameSimulator.zombies
+        """
+        if zombies is not self._source or len(zombies) < self._indexed_count:
+            self._rows = {}
+            self._source = zombies
+            self._indexed_count = 0
+        
+        rows = self._rows
+        for order in range(self._indexed_count, len(zombies)):
+            zombie = zombies[order]
+            if zombie.is_alive:
+                rows.setdefault(zombie.row, []).append((zombie.x, order, zombie))
+        self._indexed_count = len(zombies)
+        
+        xs = {}
+        for row, entries in rows.items():
+            entries = [(z.x, order, z) for _, order, z in entries if z.is_alive]
+            entries.sort()
+            rows[row] = entries
+            xs[row] = [entry[0] for entry in entries]
+        self._xs = xs
+    
+    def in_range(self, row: int, x_min: float, x_max: float) -> List[Tuple[float, int, Zombie]]:
+        """
+        Get entries of a row with x_min <= x <= x_max
+        
+        Zombies killed since the last refresh are still included.
+        """
+        xs = self._xs.get(row)
+        if not xs:
+            return []
+        return self._rows[row][bisect_left(xs, x_min):bisect_right(xs, x_max)]
+    
+    def any_ahead(self, rows: List[int], x: float) -> bool:
+        """Check if any alive zombie in the given rows has zombie.x > x"""
+        for row in rows:
+            xs = self._xs.get(row)
+            if not xs:
+                continue
+            entries = self._rows[row]
+            # Walk left from the rightmost zombie past any killed this frame
+            for i in range(len(xs) - 1, bisect_right(xs, x) - 1, -1):
+                if entries[i][2].is_alive:
+                    return True
+        return False
 
 
 # ============================================================================
@@ -256,14 +601,23 @@ class GameSimulator:
         self.is_game_over: bool = False
         self.is_win: bool = False
         
-        # Entity lists
-        self.plants: List[Plant] = []
-        self.zombies: List[Zombie] = []
-        self.projectiles: List[Projectile] = []
+        # Entity lists (see the plants/zombies/projectiles properties)
+        self._plants: List[Plant] = []
+        self._zombies: List[Zombie] = []
+        self._projectiles: List[Projectile] = []
+        
+        # Restored snapshot whose entities are not unpacked yet
+        self._pending_state: Optional[GameState] = None
+        
+        # Sum of entity hash keys, or None if stale (see state_hash)
+        self._entity_hash: Optional[int] = None
         
         # Grid for quick plant lookup (row, col) -> plant_id
         self._plant_grid: Dict[Tuple[int, int], int] = {}
         
+        # Alive zombies per row ordered by x (refreshed after movement)
+        self._zombie_index = ZombieRowIndex()
+        
         # ID counters for entities
         self._next_plant_id: int = 0
         self._next_zombie_id: int = 0
@@ -272,6 +626,65 @@ class GameSimulator:
         # Number of rows (5 for day/night, 6 for pool/fog)
         self._row_count = 6 if scene in [2, 3] else 5
     
+    # ========================================================================
+    # Entity Lists
+    # ========================================================================
+    
+    # restore() only records the snapshot; the entity lists are unpacked
+    # from it the first time any of them is used. Restoring is then constant
+    # time, and a search that restores a node and immediately restores
+    # another never builds entities at all.
+    
+    @property
+    def plants(self) -> List[Plant]:
+        """All plants, including dead ones not yet cleaned up"""
+        if self._pending_state is not None:
+            self._unpack_pending_state()
+        return self._plants
+    
+    @plants.setter
+    def plants(self, plants: List[Plant]) -> None:
+        if self._pending_state is not None:
+            self._unpack_pending_state()
+        self._plants = plants
+        self._entity_hash = None
+    
+    @property
+    def zombies(self) -> List[Zombie]:
+        """All zombies, including dead ones"""
+        if self._pending_state is not None:
+            self._unpack_pending_state()
+        return self._zombies
+    
+    @zombies.setter
+    def zombies(self, zombies: List[Zombie]) -> None:
+        if self._pending_state is not None:
+            self._unpack_pending_state()
+        self._zombies = zombies
+        self._entity_hash = None
+    
+    @property
+    def projectiles(self) -> List[Projectile]:
+        """All projectiles"""
+        if self._pending_state is not None:
+            self._unpack_pending_state()
+        return self._projectiles
+    
+    @projectiles.setter
+    def projectiles(self, projectiles: List[Projectile]) -> None:
+        if self._pending_state is not None:
+            self._unpack_pending_state()
+        self._projectiles = projectiles
+        self._entity_hash = None
+    
+    def _unpack_pending_state(self) -> None:
+        """Build the entity lists of the last restored snapshot"""
+        state = self._pending_state
+        self._pending_state = None
+        self._plants = unpack_entities(Plant, state.plants)
+        self._zombies = unpack_entities(Zombie, state.zombies)
+        self._projectiles = unpack_entities(Projectile, state.projectiles)
+    
     # ========================================================================
     # Main Simulation Loop
     # ========================================================================
@@ -291,6 +704,7 @@ class GameSimulator:
             return
         
         self.frame += 1
+        self._entity_hash = None
         
         # 1. Update projectiles (position and collision)
         self._update_projectiles()
@@ -307,19 +721,261 @@ class GameSimulator:
         # 5. Check game over conditions
         self._check_game_over()
     
-    def tick_n(self, n: int) -> None:
-        """Advance simulation by n frames"""
+    def tick_n(self, n: int, skip_ahead: bool = False) -> None:
+        """
+        Advance simulation by n frames
+        
+        Args:
+            n: Number of frames
+            skip_ahead: Jump over frames without events (advance_to_next_event);
+                the result is identical either way
+        """
+        if skip_ahead:
+            # On boards with an event every frame, look ahead less often
+            backoff = 0
+            while n > 0 and not self.is_game_over:
+                advanced = self.advance_to_next_event(n)
+                n -= advanced
+                if advanced > 1:
+                    backoff = 0
+                    continue
+                backoff = min(2 * backoff + 1, _EVENT_BACKOFF_LIMIT)
+                for _ in range(min(backoff, n)):
+                    if self.is_game_over:
+                        break
+                    self.tick()
+                    n -= 1
+            return
         for _ in range(n):
             if self.is_game_over:
                 break
             self.tick()
     
+    # ========================================================================
+    # Event Skip-Ahead
+    # ========================================================================
+    
+    def advance_to_next_event(self, max_frames: int = 10000) -> int:
+        """
+        Advance through the next frame where something discrete happens
+        
+        Until the next event (a hit, a plant firing, a bite that kills or
+        finds no plant, a slow/freeze ending, a zombie reaching a plant or
+        x < 0) frames only move entities, count down timers, take bites out
+        of plants that survive them and drop projectiles leaving the lawn.
+        Those frames are replayed directly; the event frame then runs
+        through tick().
+        The result is identical to calling tick() frame by frame.
+        
+        Args:
+            max_frames: Most frames to advance
+        
+        Returns:
+            Number of frames advanced
+        """
+        if self.is_game_over or max_frames <= 0:
+            return 0
+        quiet = self._next_event_horizon(max_frames) - 1
+        if quiet > 0:
+            self._advance_quiet_frames(quiet)
+        self.tick()
+        return quiet + 1
+    
+    def _next_event_horizon(self, limit: int) -> int:
+        """
+        Lower bound on the number of ticks up to and including the next event
+        
+        Positions are extrapolated linearly, with every distance shrunk by
+        _EVENT_MARGIN, and each bound errs early (e.g. the fastest zombie of
+        a row stands in for all of them), so ticks before the returned one
+        are guaranteed quiet.
+        
+        Args:
+            limit: Largest value to return
+        
+        Returns:
+            Tick count k in 1..limit; ticks 1..k-1 from now have no events
+        """
+        horizon = limit
+        
+        # Plant hitbox right edge per row (zombies start eating at it)
+        plant_right: Dict[int, float] = {}
+        for plant in self.plants:
+            if plant.is_alive:
+                right = plant.x + 40
+                if right > plant_right.get(plant.row, 0.0):
+                    plant_right[plant.row] = right
+        
+        # Alive zombies per row: x positions and fastest speed
+        row_xs: Dict[int, List[float]] = {}
+        row_speed: Dict[int, float] = {}
+        
+        # First bite frame of the zombies eating each plant
+        first_bites: Dict[int, List[int]] = {}
+        for zombie in self.zombies:
+            if not zombie.is_alive:
+                continue
+            if 0 < zombie.slow_countdown < horizon:
+                horizon = zombie.slow_countdown
+            if 0 < zombie.freeze_countdown < horizon:
+                horizon = zombie.freeze_countdown
+            
+            row = zombie.row
+            speed = 0.0
+            if zombie.is_eating:
+                first_bites.setdefault(zombie.target_plant_id, []).append(
+                    max(zombie.eat_countdown, 1))
+            else:
+                # Reaching a plant, or x < 0 in a row without plants
+                speed = zombie.effective_speed
+                gap = zombie.x - plant_right.get(row, 0.0) - _EVENT_MARGIN
+                if gap <= 0:
+                    return 1
+                if speed > 0 and gap < horizon * speed:
+                    horizon = math.ceil(gap / speed)
+            if horizon <= 1:
+                return 1
+            
+            xs = row_xs.get(row)
+            if xs is None:
+                row_xs[row] = [zombie.x]
+                row_speed[row] = speed
+            else:
+                xs.append(zombie.x)
+                if speed > row_speed[row]:
+                    row_speed[row] = speed
+        
+        # Bites are quiet until one kills its plant (or finds it gone)
+        if first_bites:
+            plants_by_id: Dict[int, Plant] = {}
+            for plant in self.plants:
+                plants_by_id.setdefault(plant.id, plant)
+            for plant_id, firsts in first_bites.items():
+                plant = plants_by_id.get(plant_id)
+                if plant is None or not plant.is_alive:
+                    horizon = min(horizon, min(firsts))
+                else:
+                    horizon = min(horizon, _killing_bite_frame(plant.health, firsts, horizon))
+                if horizon <= 1:
+                    return 1
+        
+        # Rightmost zombie per row
+        row_front: Dict[int, float] = {}
+        for row, xs in row_xs.items():
+            xs.sort()
+            row_front[row] = xs[-1]
+        
+        # Plants fire when the countdown runs out with a zombie ahead; zombies
+        # only move left, so a plant with none ahead now stays quiet
+        for plant in self.plants:
+            if not plant.is_alive or plant.type not in ATTACKING_PLANTS:
+                continue
+            if plant.attack_countdown >= horizon:
+                continue
+            x = plant.x
+            row = plant.row
+            if plant.type == PlantType.THREEPEATER:
+                ahead = (row_front.get(row - 1, x) > x or row_front.get(row, x) > x
+                         or row_front.get(row + 1, x) > x)
+            else:
+                ahead = row_front.get(row, x) > x
+            if ahead:
+                horizon = plant.attack_countdown
+                if horizon <= 1:
+                    return 1
+        
+        # Projectiles closing in on the nearest zombie not yet passed (the hit
+        # test runs against zombies not yet moved that frame)
+        for proj in self.projectiles:
+            if not proj.is_alive:
+                continue
+            x = proj.x
+            speed = proj.speed
+            if proj.type in SPLASH_PROJECTILES:
+                reach = PROJECTILE_SPLASH_RADIUS.get(proj.type, 80) + _EVENT_MARGIN
+                target_rows = (proj.row - 1, proj.row, proj.row + 1)
+            else:
+                reach = 20 + _EVENT_MARGIN
+                target_rows = (proj.row,)
+            for row in target_rows:
+                xs = row_xs.get(row)
+                if xs is None:
+                    continue
+                i = bisect_left(xs, x + speed - reach)
+                if i == len(xs):
+                    continue
+                gap = xs[i] - x - reach
+                if gap <= 0:
+                    return 1
+                closing = speed + row_speed[row]
+                if closing > 0 and gap < horizon * closing:
+                    horizon = math.ceil(gap / closing)
+                    if horizon <= 1:
+                        return 1
+        
+        return horizon
+    
+    def _advance_quiet_frames(self, frames: int) -> None:
+        """
+        Apply frames that have no events (see _next_event_horizon)
+        
+        Positions are stepped one frame at a time, as tick() does, so the
+        float results are bit-identical. Projectiles leaving the lawn stop
+        there and are cleaned up, which nothing else in these frames sees;
+        bites are all survived, so their order does not matter.
+        """
+        self.frame += frames
+        self._entity_hash = None
+        
+        right_edge = LAWN_RIGHT_X + 50
+        for proj in self.projectiles:
+            if not proj.is_alive:
+                continue
+            x = proj.x
+            speed = proj.speed
+            for _ in range(frames):
+                x += speed
+                if x > right_edge:
+                    proj.is_alive = False
+                    break
+            proj.x = x
+        
+        for zombie in self.zombies:
+            if not zombie.is_alive:
+                continue
+            if zombie.slow_countdown > 0:
+                zombie.slow_countdown -= frames
+            if zombie.freeze_countdown > 0:
+                zombie.freeze_countdown -= frames
+            if zombie.is_eating:
+                countdown = zombie.eat_countdown - frames
+                if countdown <= 0:
+                    bites = -countdown // ZOMBIE_BITE_INTERVAL + 1
+                    plant = self._get_plant_by_id(zombie.target_plant_id)
+                    plant.health -= bites * int(ZOMBIE_BITE_DAMAGE)
+                    countdown += bites * ZOMBIE_BITE_INTERVAL
+                zombie.eat_countdown = countdown
+                continue
+            speed = zombie.effective_speed
+            if speed:
+                x = zombie.x
+                for _ in range(frames):
+                    x -= speed
+                zombie.x = x
+        
+        for plant in self.plants:
+            if plant.is_alive and plant.type in ATTACKING_PLANTS and plant.attack_countdown > 0:
+                plant.attack_countdown -= min(frames, plant.attack_countdown)
+        
+        self._cleanup_dead_entities()
+    
     # ========================================================================
     # Projectile Update
     # ========================================================================
     
     def _update_projectiles(self) -> None:
         """Update all projectiles (position and collision)"""
+        self._zombie_index.refresh(self.zombies)
         for proj in self.projectiles:
             if not proj.is_alive:
                 continue
@@ -340,39 +996,39 @@ class GameSimulator:
         if not proj.is_alive:
             return
         
-        # Get zombies in the same row (or adjacent rows for splash)
-        if is_splash_projectile(proj.type):
-            target_rows = [proj.row - 1, proj.row, proj.row + 1]
-        else:
-            target_rows = [proj.row]
+        index = self._zombie_index
         
-        hit_any = False
-        for zombie in self.zombies:
-            if not zombie.is_alive:
-                continue
-            if zombie.row not in target_rows:
-                continue
-            
-            # Simple collision check: projectile x overlaps with zombie
-            # Zombie hitbox is approximately 20 pixels wide centered at x
-            zombie_left = zombie.x - 20
-            zombie_right = zombie.x + 20
+        if is_splash_projectile(proj.type):
+            # Splash projectiles use radius and hit all zombies in range
+            # in the same and adjacent rows, in list order
+            splash_radius = PROJECTILE_SPLASH_RADIUS.get(proj.type, 80)
+            reach = splash_radius + _HIT_SEARCH_MARGIN
+            targets = []
+            for row in (proj.row - 1, proj.row, proj.row + 1):
+                for _, order, zombie in index.in_range(row, proj.x - reach, proj.x + reach):
+                    if zombie.is_alive and abs(proj.x - zombie.x) <= splash_radius:
+                        targets.append((order, zombie))
+            targets.sort(key=lambda target: target[0])
+            for _, zombie in targets:
+                self._apply_projectile_damage(proj, zombie)
             
-            if is_splash_projectile(proj.type):
-                # Splash projectiles use radius and hit all zombies in range
-                splash_radius = PROJECTILE_SPLASH_RADIUS.get(proj.type, 80)
-                if abs(proj.x - zombie.x) <= splash_radius:
-                    self._apply_projectile_damage(proj, zombie)
-                    hit_any = True
-            else:
-                # Direct hit check
-                if zombie_left <= proj.x <= zombie_right:
-                    self._apply_projectile_damage(proj, zombie)
-                    proj.is_alive = False
-                    return
+            # Mark splash projectile as dead after hitting at least one zombie
+            if targets:
+                proj.is_alive = False
+            return
         
-        # Mark splash projectile as dead after hitting at least one zombie
-        if is_splash_projectile(proj.type) and hit_any:
+        # Direct hit on the first zombie in list order whose hitbox overlaps
+        # Zombie hitbox is approximately 20 pixels wide centered at x
+        reach = 20 + _HIT_SEARCH_MARGIN
+        hit_order = -1
+        hit_zombie = None
+        for _, order, zombie in index.in_range(proj.row, proj.x - reach, proj.x + reach):
+            if (zombie.is_alive and zombie.x - 20 <= proj.x <= zombie.x + 20
+                    and (hit_zombie is None or order < hit_order)):
+                hit_order = order
+                hit_zombie = zombie
+        if hit_zombie is not None:
+            self._apply_projectile_damage(proj, hit_zombie)
             proj.is_alive = False
     
     def _apply_projectile_damage(self, proj: Projectile, zombie: Zombie) -> None:
@@ -467,6 +1123,7 @@ class GameSimulator:
     
     def _update_plants(self) -> None:
         """Update all plants (state and attacks)"""
+        self._zombie_index.refresh(self.zombies)
         for plant in self.plants:
             if not plant.is_alive:
                 continue
@@ -493,15 +1150,8 @@ class GameSimulator:
         else:
             target_rows = [plant.row]
         
-        for zombie in self.zombies:
-            if not zombie.is_alive:
-                continue
-            if zombie.row not in target_rows:
-                continue
-            # Check if zombie is ahead of plant
-            if zombie.x > plant.x:
-                return True
-        return False
+        # Check if any zombie is ahead of plant
+        return self._zombie_index.any_ahead(target_rows, plant.x)
     
     def _plant_fire(self, plant: Plant) -> None:
         """Fire projectile(s) from plant based on plant type"""
@@ -559,24 +1209,7 @@ class GameSimulator:
     
     def _get_projectile_type_for_plant(self, plant_type: PlantType) -> Optional[ProjectileType]:
         """Get projectile type for attacking plant"""
-        plant_to_proj = {
-            PlantType.PEASHOOTER: ProjectileType.PEA,
-            PlantType.SNOW_PEA: ProjectileType.SNOW_PEA,
-            PlantType.REPEATER: ProjectileType.PEA,
-            PlantType.THREEPEATER: ProjectileType.PEA,
-            PlantType.SPLITPEA: ProjectileType.PEA,
-            PlantType.GATLINGPEA: ProjectileType.PEA,
-            PlantType.PUFFSHROOM: ProjectileType.PUFF,
-            PlantType.FUMESHROOM: ProjectileType.FUME,
-            PlantType.SEASHROOM: ProjectileType.PUFF,
-            PlantType.SCAREDYSHROOM: ProjectileType.PUFF,
-            PlantType.CACTUS: ProjectileType.CACTUS,
-            PlantType.CABBAGEPULT: ProjectileType.CABBAGE,
-            PlantType.KERNELPULT: ProjectileType.KERNEL,
-            PlantType.MELONPULT: ProjectileType.MELON,
-            PlantType.WINTERMELON: ProjectileType.WINTERMELON,
-        }
-        return plant_to_proj.get(plant_type)
+        return PLANT_PROJECTILE_TYPE.get(plant_type)
     
     # ========================================================================
     # Damage Calculation
@@ -680,53 +1313,57 @@ class GameSimulator:
         """
         Create a complete state snapshot for MCTS
         
+        Entities are packed into immutable records (one tuple per entity).
+        A simulator whose restored entities have not been unpacked yet hands
+        back the restored records without packing anything.
+        
         Returns:
-            GameState with deep copies of all entities
+            GameState sharing nothing mutable with the simulator
         """
+        pending = self._pending_state
+        if pending is not None:
+            plants, zombies, projectiles = pending.plants, pending.zombies, pending.projectiles
+        else:
+            plants = pack_entities(Plant, self._plants)
+            zombies = pack_entities(Zombie, self._zombies)
+            projectiles = pack_entities(Projectile, self._projectiles)
         return GameState(
             frame=self.frame,
             sun=self.sun,
-            plants=[copy.deepcopy(p) for p in self.plants],
-            zombies=[copy.deepcopy(z) for z in self.zombies],
-            projectiles=[copy.deepcopy(p) for p in self.projectiles],
+            plants=plants,
+            zombies=zombies,
+            projectiles=projectiles,
             wave=self.wave,
             is_game_over=self.is_game_over,
             is_win=self.is_win,
+            plant_grid=tuple(self._plant_grid.items()),
+            next_ids=(self._next_plant_id, self._next_zombie_id, self._next_projectile_id),
+            entity_hash=self._entity_hash,
         )
     
     def restore(self, state: GameState) -> None:
         """
         Restore simulator state from snapshot
         
+        Entities are unpacked from the snapshot when first used, and the
+        snapshot itself is never modified, so it can be restored again.
+        
         Args:
             state: GameState snapshot to restore
         """
         self.frame = state.frame
         self.sun = state.sun
-        self.plants = [copy.deepcopy(p) for p in state.plants]
-        self.zombies = [copy.deepcopy(z) for z in state.zombies]
-        self.projectiles = [copy.deepcopy(p) for p in state.projectiles]
         self.wave = state.wave
         self.is_game_over = state.is_game_over
         self.is_win = state.is_win
-        
-        # Rebuild plant grid
-        self._plant_grid = {}
-        for plant in self.plants:
-            if plant.is_alive:
-                self._plant_grid[(plant.row, plant.col)] = plant.id
-        
-        # Update ID counters
-        if self.plants:
-            self._next_plant_id = max(p.id for p in self.plants) + 1
-        if self.zombies:
-            self._next_zombie_id = max(z.id for z in self.zombies) + 1
-        if self.projectiles:
-            self._next_projectile_id = max(p.id for p in self.projectiles) + 1
+        self._pending_state = state
+        self._plant_grid = dict(state.plant_grid)
+        self._next_plant_id, self._next_zombie_id, self._next_projectile_id = state.next_ids
+        self._entity_hash = state.entity_hash
     
     def clone(self) -> GameSimulator:
         """
-        Create a deep copy of the simulator
+        Create an independent copy of the simulator
         
         Returns:
             New GameSimulator instance with identical state
@@ -734,11 +1371,41 @@ class GameSimulator:
         new_sim = GameSimulator(sun=self.sun, scene=self.scene)
         new_sim.restore(self.snapshot())
         new_sim._row_count = self._row_count
-        new_sim._next_plant_id = self._next_plant_id
-        new_sim._next_zombie_id = self._next_zombie_id
-        new_sim._next_projectile_id = self._next_projectile_id
         return new_sim
     
+    # ========================================================================
+    # State Hash
+    # ========================================================================
+    
+    @property
+    def state_hash(self) -> int:
+        """
+        64-bit hash of the board for transposition tables
+        
+        Covers alive plants (cell, type, HP, attack countdown), alive zombies
+        (type, row, quantized x, HP, status, bite countdown), alive projectiles
+        (type, row, x bucket), sun and the game over flag; see State Hashing.
+        
+        Ticks change nearly every entity key, so a tick only marks the hash
+        stale and the next read sums every entity once. place_plant,
+        remove_plant and spawn_zombie update it in O(1), and snapshots and
+        clones carry it along, so the children of a search node hash
+        without a full pass. Code that edits entity fields
+        directly must call invalidate_hash().
+        """
+        if self._entity_hash is None:
+            self._entity_hash = self._sum_entity_hashes()
+        return (self._entity_hash + _hash_key((0, self.sun, self.is_game_over))) & _HASH_MASK
+    
+    def invalidate_hash(self) -> None:
+        """Recompute the state hash from scratch on its next read"""
+        self._entity_hash = None
+    
+    def _sum_entity_hashes(self) -> int:
+        """Sum of the hash keys of every entity"""
+        return (sum(map(_plant_hash, self.plants)) + sum(map(_zombie_hash, self.zombies))
+                + sum(map(_projectile_hash, self.projectiles)))
+    
     # ========================================================================
     # Operation Interface
     # ========================================================================
@@ -774,6 +1441,8 @@ class GameSimulator:
         plant = Plant.create(plant_type, row, col, self._next_plant_id)
         self._next_plant_id += 1
         self.plants.append(plant)
+        if self._entity_hash is not None:
+            self._entity_hash += _plant_hash(plant)
         self._plant_grid[(row, col)] = plant.id
         self.sun -= cost
         
@@ -797,6 +1466,8 @@ class GameSimulator:
         plant_id = self._plant_grid[key]
         plant = self._get_plant_by_id(plant_id)
         if plant:
+            if self._entity_hash is not None:
+                self._entity_hash -= _plant_hash(plant)
             plant.is_alive = False
             del self._plant_grid[key]
             return True
@@ -815,6 +1486,34 @@ class GameSimulator:
         zombie = Zombie.create(zombie_type, row, x, self._next_zombie_id)
         self._next_zombie_id += 1
         self.zombies.append(zombie)
+        if self._entity_hash is not None:
+            self._entity_hash += _zombie_hash(zombie)
+    
+    def damage_zombies_in_area(self, rows: List[int], x_min: float, x_max: float,
+                               damage: int) -> int:
+        """
+        Damage every alive zombie in an area (ash plants, cob cannon)
+        
+        Args:
+            rows: Rows hit
+            x_min: Left edge of the area
+            x_max: Right edge of the area
+            damage: Damage dealt to each zombie (shield, then armor, then body)
+        
+        Returns:
+            Number of zombies hit
+        """
+        hit = 0
+        for zombie in self.zombies:
+            if not zombie.is_alive or zombie.row not in rows or not x_min <= zombie.x <= x_max:
+                continue
+            if self._entity_hash is not None:
+                self._entity_hash -= _zombie_hash(zombie)
+            self._apply_damage_to_zombie(zombie, damage)
+            if self._entity_hash is not None:
+                self._entity_hash += _zombie_hash(zombie)
+            hit += 1
+        return hit
     
     def get_plant_at(self, row: int, col: int) -> Optional[Plant]:
         """
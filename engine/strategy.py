@@ -46,6 +46,7 @@ class StrategyPlanner:
     
     def __init__(self, state: GameState):
         self.state = state
+        self.grid = state.grid  # Candidate cells come from its occupancy bitboard
         self.threat_analyzer = ThreatAnalyzer(state)
         self.resource_analyzer = ResourceAnalyzer(state)
         self.defense_analyzer = DefenseAnalyzer(state)
@@ -222,15 +223,15 @@ class StrategyPlanner:
             return None
         
         # Find empty spot in back columns
-        for col in [1, 0, 2]:
-            for row in range(self.row_count):
-                if self.state.is_cell_empty(row, col):
-                    return Action.plant(
-                        row=row, col=col,
-                        plant_type=PlantType.SUNFLOWER,
-                        priority=50.0,
-                        reason="Economy development"
-                    )
+        cell = self.grid.first_empty_in_cols((1, 0, 2), self.row_count)
+        if cell:
+            row, col = cell
+            return Action.plant(
+                row=row, col=col,
+                plant_type=PlantType.SUNFLOWER,
+                priority=50.0,
+                reason="Economy development"
+            )
         return None
     
     def _plan_basic_defense(self) -> Optional[Action]:
@@ -245,14 +246,14 @@ class StrategyPlanner:
         # Find row with zombies but no attacker
         for row in range(self.row_count):
             if self.state.get_row_threat(row) > 0:
-                for col in [3, 2, 4]:
-                    if self.state.is_cell_empty(row, col):
-                        return Action.plant(
-                            row=row, col=col,
-                            plant_type=PlantType.PEASHOOTER,
-                            priority=35.0,
-                            reason=f"Basic defense for row {row}"
-                        )
+                col = self.grid.first_empty_in_row(row, (3, 2, 4))
+                if col is not None:
+                    return Action.plant(
+                        row=row, col=col,
+                        plant_type=PlantType.PEASHOOTER,
+                        priority=35.0,
+                        reason=f"Basic defense for row {row}"
+                    )
         return None
     
     def _plan_row_defense(self, row: int) -> Optional[Action]:
@@ -260,26 +261,27 @@ class StrategyPlanner:
         # Try wall-nut
         seed = self.state.get_seed_by_type(PlantType.WALLNUT)
         if seed and seed.usable and self.state.sun >= PLANT_COST[PlantType.WALLNUT]:
-            for col in [self.defense_column, self.defense_column + 1, self.defense_column - 1]:
-                if 0 <= col < 9 and self.state.is_cell_empty(row, col):
-                    return Action.plant(
-                        row=row, col=col,
-                        plant_type=PlantType.WALLNUT,
-                        priority=40.0,
-                        reason=f"Row {row} defense"
-                    )
+            col = self.grid.first_empty_in_row(
+                row, (self.defense_column, self.defense_column + 1, self.defense_column - 1))
+            if col is not None:
+                return Action.plant(
+                    row=row, col=col,
+                    plant_type=PlantType.WALLNUT,
+                    priority=40.0,
+                    reason=f"Row {row} defense"
+                )
         
         # Fallback to peashooter
         seed = self.state.get_seed_by_type(PlantType.PEASHOOTER)
         if seed and seed.usable and self.state.sun >= PLANT_COST[PlantType.PEASHOOTER]:
-            for col in [3, 2, 4]:
-                if self.state.is_cell_empty(row, col):
-                    return Action.plant(
-                        row=row, col=col,
-                        plant_type=PlantType.PEASHOOTER,
-                        priority=35.0,
-                        reason=f"Row {row} attacker"
-                    )
+            col = self.grid.first_empty_in_row(row, (3, 2, 4))
+            if col is not None:
+                return Action.plant(
+                    row=row, col=col,
+                    plant_type=PlantType.PEASHOOTER,
+                    priority=35.0,
+                    reason=f"Row {row} attacker"
+                )
         return None
     
     def _plan_attacker(self, row: int) -> Optional[Action]:
@@ -290,14 +292,14 @@ class StrategyPlanner:
         if self.state.sun < PLANT_COST[PlantType.PEASHOOTER]:
             return None
         
-        for col in [3, 2, 4, 5]:
-            if self.state.is_cell_empty(row, col):
-                return Action.plant(
-                    row=row, col=col,
-                    plant_type=PlantType.PEASHOOTER,
-                    priority=30.0,
-                    reason=f"Attacker for row {row}"
-                )
+        col = self.grid.first_empty_in_row(row, (3, 2, 4, 5))
+        if col is not None:
+            return Action.plant(
+                row=row, col=col,
+                plant_type=PlantType.PEASHOOTER,
+                priority=30.0,
+                reason=f"Attacker for row {row}"
+            )
         return None
     
     def _plan_gargantuar_response(self) -> Optional[Action]:
@@ -0,0 +1,93 @@
+"""
+Transposition Table for Search
+Shares evaluations between search paths that reach the same board
+
+Keys are GameSimulator.state_hash values. Boards are only compared by hash,
+so two boards that differ by less than a hash bucket (see State Hashing in
+engine.simulator) share an entry, as do the rare 64-bit collisions; values
+stored here should be evaluations that tolerate that.
+"""
+
+from __future__ import annotations
+from collections import OrderedDict
+from typing import Any, Optional
+
+
+class TranspositionTable:
+    """
+    Bounded map from board hash to a search value
+
+    Holds at most capacity entries; storing into a full table evicts the
+    least recently used one, so long searches keep the boards they revisit.
+    """
+
+    def __init__(self, capacity: int = 1 << 16):
+        """
+        Initialize an empty table
+
+        Args:
+            capacity: Most entries held
+        """
+        if capacity <= 0:
+            raise ValueError(f"capacity must be positive, got {capacity}")
+        self.capacity: int = capacity
+        self._entries: OrderedDict[int, Any] = OrderedDict()
+
+        # Lookup statistics
+        self.hits: int = 0
+        self.misses: int = 0
+
+    def lookup(self, key: int) -> Optional[Any]:
+        """
+        Get the value stored for a board
+
+        Args:
+            key: Board hash
+
+        Returns:
+            Stored value, or None if the board is not in the table
+        """
+        entries = self._entries
+        value = entries.get(key)
+        if value is None:
+            self.misses += 1
+            return None
+        entries.move_to_end(key)
+        self.hits += 1
+        return value
+
+    def store(self, key: int, value: Any) -> None:
+        """
+        Store (or replace) the value of a board
+
+        Args:
+            key: Board hash
+            value: Value to share; None, which lookup() returns for a miss,
+                raises ValueError
+        """
+        if value is None:
+            raise ValueError("None cannot be stored: lookup() returns it for a miss")
+        entries = self._entries
+        if key in entries:
+            entries.move_to_end(key)
+        elif len(entries) >= self.capacity:
+            entries.popitem(last=False)
+        entries[key] = value
+
+    def clear(self) -> None:
+        """Remove every entry and reset the statistics"""
+        self._entries.clear()
+        self.hits = 0
+        self.misses = 0
+
+    @property
+    def hit_rate(self) -> float:
+        """Get fraction of lookups that found an entry"""
+        lookups = self.hits + self.misses
+        return self.hits / lookups if lookups else 0.0
+
+    def __len__(self) -> int:
+        return len(self._entries)
+
+    def __contains__(self, key: int) -> bool:
+        return key in self._entries
@@ -0,0 +1,314 @@
+"""
+Batched Multi-Board Simulator for PVZ
+Steps many independent boards at once for MCTS rollouts and RL training
+
+All boards share one set of struct-of-arrays columns (engine.array_simulator):
+board b owns lanes b*LANES_PER_BOARD .. (b+1)*LANES_PER_BOARD - 1, so one
+tick is the same handful of array operations whatever the number of boards.
+Every board follows GameSimulator rules exactly and boards never interact;
+exporting a board with get_board() gives the GameSimulator the same actions
+would have produced.
+
+Actions are applied in batches of per-board arrays. A board that is lost
+(zombie past the left edge) is reset to the initial board when auto_reset
+is on, otherwise it is emptied and frozen until reset().
+
+Time unit: 1 frame = 1 centisecond (cs) = 10 milliseconds
+"""
+
+from __future__ import annotations
+from typing import List, Optional
+
+import numpy as np
+
+from data.constants import GRID_COLS, GRID_ROWS
+from engine.simulator import GameSimulator
+from engine.array_simulator import (
+    LaneSimulator,
+    ArraySimulator,
+    LANES_PER_BOARD,
+    PLANT_COST_TABLE,
+    PLANT_SCHEMA,
+    ZOMBIE_SCHEMA,
+    PROJECTILE_SCHEMA,
+    _LANE_KEY_STRIDE,
+    board_lanes,
+    board_ranks,
+)
+
+
+class VecSimulator(LaneSimulator):
+    """
+    N independent boards stepped together
+
+    Per-board state is kept in arrays of length n_envs:
+    - sun: Sun count
+    - env_frame: Board frame (the initial board's frame after each reset)
+    - is_game_over: Boards lost on the last tick. With auto_reset they are
+      already back at the initial board and the flag clears on the next
+      tick; without it they stay empty and frozen until reset().
+    """
+
+    def __init__(self, initial: GameSimulator, n_envs: int, auto_reset: bool = True):
+        """
+        Initialize every board to a copy of the initial board
+
+        Args:
+            initial: Starting board (not modified)
+            n_envs: Number of boards
+            auto_reset: Reset lost boards at the end of the tick they were lost
+        """
+        super().__init__(scene=initial.scene, board_count=n_envs)
+        self.n_envs: int = n_envs
+        self.auto_reset: bool = auto_reset
+        self._row_count = initial._row_count
+        self._initial = ArraySimulator.from_simulator(initial)
+
+        self.sun = np.zeros(n_envs, dtype=np.int64)
+        self.env_frame = np.zeros(n_envs, dtype=np.int64)
+        self.is_game_over = np.zeros(n_envs, dtype=bool)
+        self.reset()
+
+    # ========================================================================
+    # Main Simulation Loop
+    # ========================================================================
+
+    def tick(self) -> None:
+        """Advance every running board by one frame"""
+        if self.auto_reset:
+            self.is_game_over[:] = False
+
+        self.frame += 1
+        self.env_frame += ~self.is_game_over
+        self._update_entities()
+        self._check_game_over()
+
+    def tick_n(self, n: int) -> None:
+        """Advance every running board by n frames"""
+        for _ in range(n):
+            if not self.auto_reset and self.is_game_over.all():
+                break
+            self.tick()
+
+    def _check_game_over(self) -> None:
+        """Flag boards where a zombie reached the left edge, then reset or freeze them"""
+        zombies = self.zombies
+        x = zombies['x']
+        if not (x.size and x.min() < 0):
+            return
+        lost = np.unique(zombies['env'][zombies['is_alive'] & (x < 0)])
+        if lost.size == 0:
+            return
+        self.is_game_over[lost] = True
+        if self.auto_reset:
+            self._reset_boards(lost)
+        else:
+            self._clear_boards(lost)
+
+    # ========================================================================
+    # Reset
+    # ========================================================================
+
+    def reset(self, envs: Optional[np.ndarray] = None) -> None:
+        """
+        Reset boards to the initial board
+
+        Args:
+            envs: Boards to reset (default: all)
+        """
+        if envs is None:
+            envs = np.arange(self.n_envs)
+        envs = np.unique(np.asarray(envs, dtype=np.int64))
+        self._reset_boards(envs)
+        self.is_game_over[envs] = False
+
+    def _reset_boards(self, envs: np.ndarray) -> None:
+        """Replace the entities and state of boards with the initial board"""
+        initial = self._initial
+        self._clear_boards(envs)
+        self._load_initial(envs)
+        self.sun[envs] = initial.sun
+        self.env_frame[envs] = initial.frame
+        self._next_plant_ids[envs] = initial._next_plant_ids[0]
+        self._next_zombie_ids[envs] = initial._next_zombie_ids[0]
+        self._next_projectile_ids[envs] = initial._next_projectile_ids[0]
+
+    def _load_initial(self, envs: np.ndarray) -> None:
+        """Append a copy of the initial board's entities to each of the (empty) boards"""
+        initial = self._initial
+        k = len(envs)
+        lane_shift = envs * LANES_PER_BOARD
+
+        # Plants, their volleys and grid cells
+        src = initial.plants
+        plant_count = src.count
+        plant_base = self.plants.count
+        if plant_count:
+            values = {name: np.tile(src[name], k) for name in PLANT_SCHEMA}
+            values['env'] = np.repeat(envs, plant_count)
+            values['lane'] += np.repeat(lane_shift, plant_count)
+            self._sync_plant_countdowns(self.frame)
+            self._wake_plants_by(src['attack_countdown'][src['attacks'] & src['is_alive']])
+            self.plants.append(k * plant_count, **values)
+            self._volleys.extend(initial._volleys * k)
+
+            lanes, cols = np.nonzero(initial._plant_grid >= 0)
+            slots = initial._plant_grid[lanes, cols]
+            copies = np.arange(k)[:, None]
+            self._plant_grid[(lanes + lane_shift[:, None]).ravel(), np.tile(cols, k)] = (
+                slots + plant_base + copies * plant_count).ravel()
+            self._contact_table = None
+
+        # Zombies, with eaten plants pointing at the copies
+        src = initial.zombies
+        if src.count:
+            values = {name: np.tile(src[name], k) for name in ZOMBIE_SCHEMA}
+            values['env'] = np.repeat(envs, src.count)
+            values['lane'] += np.repeat(lane_shift, src.count)
+            values['lane_key'] = values['lane'] * _LANE_KEY_STRIDE
+            target = values['target_plant']
+            targeting = target >= 0
+            target[targeting] += (plant_base + plant_count * np.repeat(np.arange(k), src.count))[targeting]
+            self.zombies.append(k * src.count, **values)
+
+        src = initial.projectiles
+        if src.count:
+            values = {name: np.tile(src[name], k) for name in PROJECTILE_SCHEMA}
+            values['env'] = np.repeat(envs, src.count)
+            values['window_offset'] += np.repeat(lane_shift * _LANE_KEY_STRIDE, src.count)
+            self.projectiles.append(k * src.count, **values)
+
+    # ========================================================================
+    # Batched Operation Interface
+    # ========================================================================
+
+    def place_plants(self, envs, plant_types, rows, cols) -> np.ndarray:
+        """
+        Place plants, like GameSimulator.place_plant on each board
+
+        Entries are applied in order, so a later entry for an occupied cell
+        or a board out of sun fails just as it would one call at a time.
+        Entries for frozen boards fail.
+
+        Args:
+            envs, plant_types, rows, cols: Equal-length arrays, one plant per entry
+
+        Returns:
+            Bool array, True where the plant was placed
+        """
+        envs, plant_types, rows, cols = _as_int_arrays(envs, plant_types, rows, cols)
+        placed = np.zeros(len(envs), dtype=bool)
+        for batch in _rounds(envs):
+            e, t, r, c = envs[batch], plant_types[batch], rows[batch], cols[batch]
+            ok = self._running(e) & (r >= 0) & (r < self._row_count) & (c >= 0) & (c < GRID_COLS)
+            lanes = board_lanes(e, np.clip(r, 0, GRID_ROWS - 1))
+            ok &= self._plant_grid[lanes, np.clip(c, 0, GRID_COLS - 1)] < 0
+            cost = PLANT_COST_TABLE[t]
+            ok &= self.sun[e] >= cost
+            if not np.count_nonzero(ok):
+                continue
+
+            e, t, r, c, lanes, cost = e[ok], t[ok], r[ok], c[ok], lanes[ok], cost[ok]
+            slots = self._add_plants(e, t, r, c)
+            self._plant_grid[lanes, c] = np.arange(slots.start, slots.stop)
+            self.sun[e] -= cost
+            placed[batch[ok]] = True
+        return placed
+
+    def remove_plants(self, envs, rows, cols) -> np.ndarray:
+        """
+        Remove (shovel) plants, like GameSimulator.remove_plant on each board
+
+        Args:
+            envs, rows, cols: Equal-length arrays, one cell per entry
+
+        Returns:
+            Bool array, True where a plant was removed
+        """
+        envs, rows, cols = _as_int_arrays(envs, rows, cols)
+        removed = np.zeros(len(envs), dtype=bool)
+        self._sync_plant_countdowns(self.frame)
+        for batch in _rounds(envs):
+            e, r, c = envs[batch], rows[batch], cols[batch]
+            ok = self._running(e) & (r >= 0) & (r < self._row_count) & (c >= 0) & (c < GRID_COLS)
+            lanes = board_lanes(e, np.clip(r, 0, GRID_ROWS - 1))
+            c = np.clip(c, 0, GRID_COLS - 1)
+            slots = self._plant_grid[lanes, c]
+            ok &= slots >= 0
+            if not np.count_nonzero(ok):
+                continue
+
+            self.plants['is_alive'][slots[ok]] = False
+            self._plant_grid[lanes[ok], c[ok]] = -1
+            self._contact_table = None
+            removed[batch[ok]] = True
+        return removed
+
+    def spawn_zombies(self, envs, zombie_types, rows, xs=800.0) -> None:
+        """
+        Spawn zombies, like GameSimulator.spawn_zombie on each board
+
+        Entries for frozen boards or rows off the board are ignored: a
+        board's lanes border the next board's, so a row past the last one
+        would walk into another board.
+
+        Args:
+            envs, zombie_types, rows: Equal-length arrays, one zombie per entry
+            xs: Starting x positions (array or one value for all)
+        """
+        envs, zombie_types, rows = _as_int_arrays(envs, zombie_types, rows)
+        xs = np.broadcast_to(np.asarray(xs, dtype=np.float64), envs.shape)
+        ok = self._running(envs) & (rows >= 0) & (rows < self._row_count)
+        if np.count_nonzero(ok):
+            self._add_zombies(envs[ok], zombie_types[ok], rows[ok], xs[ok].copy())
+
+    def _running(self, envs: np.ndarray) -> np.ndarray:
+        """Boards that accept actions (not frozen after a loss)"""
+        if self.auto_reset:
+            return np.ones(len(envs), dtype=bool)
+        return ~self.is_game_over[envs]
+
+    # ========================================================================
+    # Queries
+    # ========================================================================
+
+    @property
+    def alive_zombie_counts(self) -> np.ndarray:
+        """Get count of alive zombies per board"""
+        zombies = self.zombies
+        return np.bincount(zombies['env'][zombies['is_alive']], minlength=self.n_envs)
+
+    def get_board(self, env: int) -> GameSimulator:
+        """
+        Build a GameSimulator holding one board
+
+        Args:
+            env: Board index
+        """
+        sim = GameSimulator(sun=int(self.sun[env]), scene=self.scene)
+        sim.frame = int(self.env_frame[env])
+        sim.wave = self._initial.wave
+        sim.is_game_over = bool(self.is_game_over[env]) and not self.auto_reset
+        sim._row_count = self._row_count
+        return self._export_board(env, sim)
+
+
+def _as_int_arrays(*values) -> List[np.ndarray]:
+    """Convert action arguments to equal-length int64 arrays"""
+    arrays = [np.atleast_1d(np.asarray(v, dtype=np.int64)) for v in values]
+    return list(np.broadcast_arrays(*arrays))
+
+
+def _rounds(envs: np.ndarray) -> List[np.ndarray]:
+    """
+    Split batch entries into rounds holding each board at most once
+
+    Round k holds the k-th entry of every board, in batch order, so applying
+    the rounds in turn is equivalent to applying the entries one by one.
+    """
+    if len(envs) == 0:
+        return []
+    ranks = board_ranks(envs)
+    if not ranks.any():
+        return [np.arange(len(envs))]
+    return [(ranks == k).nonzero()[0] for k in range(int(ranks.max()) + 1)]
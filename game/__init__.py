@@ -3,7 +3,7 @@ Game State Module
 Contains game state classes for zombies, plants, and overall game state
 """
 
-from game.state import GameState, SeedInfo
+from game.state import GameState, SeedInfo, StateDelta, EntityDelta
 from game.zombie import ZombieInfo
 from game.plant import PlantInfo
 from game.grid import Grid
@@ -11,3 +11,5 @@ from game.projectile import ProjectileInfo, ProjectileType
 from game.lawnmower import LawnmowerInfo
 from game.place_item import PlaceItemInfo, PlaceItemType
 from game.reader import GameReader
+from game.schedule import ReadSchedule, SectionPolicy
+from game.snapshot import StateSnapshot, StateDiff, ZombieSnapshot, PlantSnapshot, diff
@@ -3,10 +3,24 @@ Grid Class
 Represents the game grid for quick plant lookup
 """
 
-from typing import Optional, List, Dict, Tuple
+from typing import Optional, List, Dict, Collection, Iterable, Iterator, Tuple
 from dataclasses import dataclass, field
 
 
+# Column bitboards and cell positions of each grid shape, shared by its grids
+_LAYOUTS: Dict[Tuple[int, int], Tuple[List[int], List[Tuple[int, int]]]] = {}
+
+
+def _layout(rows: int, cols: int) -> Tuple[List[int], List[Tuple[int, int]]]:
+    """Column bitboards and (row, col) of every cell number of a grid shape"""
+    layout = _LAYOUTS.get((rows, cols))
+    if layout is None:
+        col_masks = [sum(1 << (row * cols + col) for row in range(rows)) for col in range(cols)]
+        positions = [divmod(cell, cols) for cell in range(rows * cols)]
+        layout = _LAYOUTS[(rows, cols)] = (col_masks, positions)
+    return layout
+
+
 @dataclass
 class Grid:
     """
@@ -14,25 +28,74 @@ class Grid:
     
     Standard PVZ grid is 9 columns x 6 rows (pool levels)
     or 9 columns x 5 rows (day/night/roof levels)
+    
+    Cells are a fixed row-major array, one plant per cell (the last one
+    set). Occupancy is kept as a bitboard, bit row * cols + col (54 bits
+    for 6x9), next to one bitboard per plant type and the plant count of
+    each row, all updated on set() and clear(). Empty cells, rows with a
+    plant type and walled columns are then mask operations.
     """
     
     rows: int = 6
     cols: int = 9
-    _grid: Dict[Tuple[int, int], any] = field(default_factory=dict)
+    _cells: List[any] = field(default_factory=list, init=False, repr=False)
+    occupied: int = field(default=0, init=False, repr=False)  # Occupancy bitboard
+    _type_bits: Dict[int, int] = field(default_factory=dict, init=False, repr=False)
+    _row_counts: List[int] = field(default_factory=list, init=False, repr=False)
+    _col_masks: List[int] = field(default_factory=list, init=False, repr=False, compare=False)
+    _positions: List[Tuple[int, int]] = field(default_factory=list, init=False, repr=False,
+                                              compare=False)
+    
+    def __post_init__(self):
+        self._cells = [None] * (self.rows * self.cols)
+        self._row_counts = [0] * self.rows
+        self._col_masks, self._positions = _layout(self.rows, self.cols)
+    
+    # ========================================================================
+    # Cells
+    # ========================================================================
     
     def set(self, row: int, col: int, plant) -> None:
         """Set a plant at a grid position"""
         if 0 <= row < self.rows and 0 <= col < self.cols:
-            self._grid[(row, col)] = plant
+            cell = row * self.cols + col
+            bit = 1 << cell
+            old = self._cells[cell]
+            if old is not None:
+                self._untype(old, bit)
+            else:
+                self.occupied |= bit
+                self._row_counts[row] += 1
+            self._cells[cell] = plant
+            plant_type = getattr(plant, 'type', None)
+            self._type_bits[plant_type] = self._type_bits.get(plant_type, 0) | bit
     
     def get(self, row: int, col: int) -> Optional[any]:
         """Get plant at a grid position"""
-        return self._grid.get((row, col), None)
+        if 0 <= row < self.rows and 0 <= col < self.cols:
+            return self._cells[row * self.cols + col]
+        return None
     
     def clear(self, row: int, col: int) -> None:
         """Clear a grid position"""
-        if (row, col) in self._grid:
-            del self._grid[(row, col)]
+        if 0 <= row < self.rows and 0 <= col < self.cols:
+            cell = row * self.cols + col
+            old = self._cells[cell]
+            if old is not None:
+                bit = 1 << cell
+                self._untype(old, bit)
+                self.occupied &= ~bit
+                self._row_counts[row] -= 1
+                self._cells[cell] = None
+    
+    def _untype(self, plant, bit: int) -> None:
+        """Drop a cell's bit from its plant's type bitboard"""
+        plant_type = getattr(plant, 'type', None)
+        bits = self._type_bits[plant_type] & ~bit
+        if bits:
+            self._type_bits[plant_type] = bits
+        else:
+            del self._type_bits[plant_type]
     
     def is_empty(self, row: int, col: int) -> bool:
         """Check if a grid position is empty"""
@@ -40,49 +103,140 @@ class Grid:
     
     def get_row(self, row: int) -> List[any]:
         """Get all plants in a row"""
-        return [self._grid[(row, col)] for col in range(self.cols) 
-                if (row, col) in self._grid]
+        return [self._cells[cell] for cell in self.cells_of(self.occupied & self.row_mask(row))]
     
     def get_col(self, col: int) -> List[any]:
         """Get all plants in a column"""
-        return [self._grid[(row, col)] for row in range(self.rows) 
-                if (row, col) in self._grid]
+        return [self._cells[cell] for cell in self.cells_of(self.occupied & self.col_mask(col))]
     
     def get_all_plants(self) -> List[any]:
         """Get all plants in the grid"""
-        return list(self._grid.values())
+        return [self._cells[cell] for cell in self.cells_of(self.occupied)]
     
     def get_empty_positions(self) -> List[Tuple[int, int]]:
         """Get all empty grid positions"""
-        return [(row, col) for row in range(self.rows) for col in range(self.cols)
-                if (row, col) not in self._grid]
+        return self._positions_of(self.empty_mask())
     
     def get_occupied_positions(self) -> List[Tuple[int, int]]:
         """Get all occupied grid positions"""
-        return list(self._grid.keys())
+        return self._positions_of(self.occupied)
+    
+    def _positions_of(self, mask: int) -> List[Tuple[int, int]]:
+        """(row, col) of a bitboard's set bits, in order"""
+        positions = []
+        while mask:
+            low = mask & -mask
+            positions.append(self._positions[low.bit_length() - 1])
+            mask ^= low
+        return positions
     
     def count(self) -> int:
         """Get total number of plants in grid"""
-        return len(self._grid)
+        return self.occupied.bit_count()
     
     def count_in_row(self, row: int) -> int:
         """Count plants in a specific row"""
-        return sum(1 for r, c in self._grid.keys() if r == row)
+        return self._row_counts[row] if 0 <= row < self.rows else 0
     
     def count_in_col(self, col: int) -> int:
         """Count plants in a specific column"""
-        return sum(1 for r, c in self._grid.keys() if c == col)
+        return (self.occupied & self.col_mask(col)).bit_count()
     
     def clear_all(self) -> None:
         """Clear the entire grid"""
-        self._grid.clear()
+        self._cells = [None] * (self.rows * self.cols)
+        self.occupied = 0
+        self._type_bits = {}
+        self._row_counts = [0] * self.rows
     
     def copy(self) -> 'Grid':
         """Create a copy of the grid"""
         new_grid = Grid(self.rows, self.cols)
-        new_grid._grid = self._grid.copy()
+        new_grid._cells = list(self._cells)
+        new_grid.occupied = self.occupied
+        new_grid._type_bits = dict(self._type_bits)
+        new_grid._row_counts = list(self._row_counts)
         return new_grid
     
+    # ========================================================================
+    # Bitboards
+    # ========================================================================
+    
+    def row_mask(self, row: int) -> int:
+        """Bitboard of a row's cells (0 outside the grid)"""
+        if not 0 <= row < self.rows:
+            return 0
+        return ((1 << self.cols) - 1) << (row * self.cols)
+    
+    def col_mask(self, col: int, row_count: Optional[int] = None) -> int:
+        """Bitboard of a column's cells in the first row_count rows (all by default)"""
+        if not 0 <= col < self.cols:
+            return 0
+        if row_count is None:
+            return self._col_masks[col]
+        return self._col_masks[col] & self.rows_mask(row_count)
+    
+    def rows_mask(self, row_count: int) -> int:
+        """Bitboard of every cell in the first row_count rows"""
+        return (1 << (min(max(row_count, 0), self.rows) * self.cols)) - 1
+    
+    def empty_mask(self, row_count: Optional[int] = None) -> int:
+        """Bitboard of the empty cells in the first row_count rows (all by default)"""
+        return self.rows_mask(self.rows if row_count is None else row_count) & ~self.occupied
+    
+    def type_mask(self, plant_types: Collection[int]) -> int:
+        """Bitboard of the cells holding a plant of one of the types"""
+        mask = 0
+        for plant_type, bits in self._type_bits.items():  # The types on the grid only
+            if plant_type in plant_types:
+                mask |= bits
+        return mask
+    
+    def cells_of(self, mask: int) -> Iterator[int]:
+        """Cell numbers (row * cols + col) of a bitboard's set bits, in order"""
+        while mask:
+            low = mask & -mask
+            yield low.bit_length() - 1
+            mask ^= low
+    
+    def row_has(self, row: int, plant_types: Collection[int]) -> bool:
+        """Check if a row holds a plant of one of the types"""
+        return bool(self.type_mask(plant_types) & self.row_mask(row))
+    
+    def col_is_walled(self, col: int, plant_types: Collection[int], row_count: int) -> bool:
+        """Check if every one of the first row_count rows holds one of the types at col"""
+        wall = self.col_mask(col, row_count)
+        return wall != 0 and self.type_mask(plant_types) & wall == wall
+    
+    # ========================================================================
+    # Candidate Cells
+    # ========================================================================
+    
+    def first_empty_in_row(self, row: int, cols: Iterable[int]) -> Optional[int]:
+        """First of the columns whose cell in the row is empty (None when all are taken)"""
+        if not 0 <= row < self.rows:
+            return None
+        taken = self.occupied >> (row * self.cols)
+        for col in cols:
+            if 0 <= col < self.cols and not taken >> col & 1:
+                return col
+        return None
+    
+    def first_empty_in_cols(self, cols: Iterable[int], row_count: int) -> Optional[Tuple[int, int]]:
+        """
+        First empty cell of the columns in the first row_count rows
+        
+        Columns are searched in the order given, rows from the top.
+        """
+        free = self.empty_mask(row_count)
+        if not free:
+            return None
+        for col in cols:
+            column = free & self._col_masks[col] if 0 <= col < self.cols else 0
+            if column:
+                return self._positions[(column & -column).bit_length() - 1]
+        return None
+    
     def __repr__(self) -> str:
         return f"Grid({self.rows}x{self.cols}, {self.count()} plants)"
     
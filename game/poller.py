@@ -0,0 +1,228 @@
+"""
+State Poller Module
+Reads the game state on a background thread and publishes the latest one
+"""
+
+import bisect
+import threading
+import time
+from typing import Callable, List, NamedTuple, Optional
+
+from game.state import GameState
+
+
+class PublishedState(NamedTuple):
+    """
+    One state read by the poller
+    
+    The state is shared between threads, and every consumer sees the
+    index and board analysis memoized on it, so it is published frozen
+    (GameState.freeze()): its entity lists are tuples and setting a field
+    raises. The entity infos are shared with later reads and must not be
+    modified either; a consumer that needs a changed state copies it.
+    """
+    sequence: int  # Increases with every read
+    game_clock: int  # Game clock of the state (-1 when not in game)
+    read_time: float  # time.perf_counter() when the read finished
+    state: Optional[GameState]  # None when not in game
+
+
+class LatestState:
+    """
+    Single-slot mailbox holding the most recent PublishedState
+    
+    Publishing replaces the slot with one reference assignment, which is
+    atomic in CPython, so neither side takes a lock: a reader always gets
+    a whole PublishedState and a newer one simply overwrites an unread
+    one. An Event lets an idle consumer sleep until the next publish, and
+    another lets a lockstep publisher wait until the consumer is done with
+    its value (done(), called once the consumer has acted on it).
+    """
+    
+    def __init__(self):
+        self._value: Optional[PublishedState] = None
+        self._published = threading.Event()
+        self._done = threading.Event()
+    
+    def publish(self, value: PublishedState) -> None:
+        """Replace the slot's value"""
+        self._done.clear()
+        self._value = value
+        self._published.set()
+    
+    def latest(self) -> Optional[PublishedState]:
+        """The most recent value, without waiting (None before the first)"""
+        return self._value
+    
+    def done(self) -> None:
+        """Mark the value published last as decided on by the consumer"""
+        self._done.set()
+    
+    def wait_done(self, timeout: float) -> bool:
+        """Wait until the consumer is done with the value published last"""
+        return self._done.wait(timeout)
+    
+    def wait_newer(self, sequence: int, timeout: float) -> Optional[PublishedState]:
+        """
+        Wait for a value newer than sequence
+        
+        Returns:
+            The latest value if newer than sequence, else None on timeout
+        """
+        deadline = time.monotonic() + timeout
+        while True:
+            self._published.clear()
+            value = self._value
+            if value is not None and value.sequence > sequence:
+                return value
+            remaining = deadline - time.monotonic()
+            if remaining <= 0 or not self._published.wait(remaining):
+                return None
+
+
+class LatencyHistogram:
+    """
+    Histogram of latencies in power-of-two millisecond buckets
+    
+    Bucket i counts latencies up to 2**i ms (bucket 0: up to 1 ms); the
+    last bucket takes everything above. Percentiles are bucket bounds.
+    """
+    
+    def __init__(self, buckets: int = 12):
+        self.bounds: List[float] = [2.0 ** i for i in range(buckets - 1)] + [float('inf')]
+        self.counts: List[int] = [0] * buckets
+        self.count = 0
+        self.total = 0.0
+        self.max = 0.0
+    
+    def record(self, seconds: float) -> None:
+        """Add one latency"""
+        ms = seconds * 1000.0
+        self.counts[bisect.bisect_left(self.bounds, ms)] += 1
+        self.count += 1
+        self.total += ms
+        self.max = max(self.max, ms)
+    
+    @property
+    def mean(self) -> float:
+        """Mean latency in ms"""
+        return self.total / self.count if self.count else 0.0
+    
+    def percentile(self, p: float) -> float:
+        """Upper bound in ms of the bucket holding the p-th percentile (0-100)"""
+        if not self.count:
+            return 0.0
+        target = self.count * p / 100.0
+        seen = 0
+        for bound, count in zip(self.bounds, self.counts):
+            seen += count
+            if seen >= target:
+                return min(bound, self.max)
+        return self.max
+    
+    def summary(self) -> str:
+        """One-line summary"""
+        return (f"n={self.count} mean={self.mean:.1f}ms p50<={self.percentile(50):.0f}ms "
+                f"p99<={self.percentile(99):.0f}ms max={self.max:.1f}ms")
+    
+    def lines(self) -> List[str]:
+        """One line per non-empty bucket, with a bar"""
+        lines = []
+        peak = max(self.counts) or 1
+        low = 0.0
+        for bound, count in zip(self.bounds, self.counts):
+            if count:
+                label = f"{low:g}-{bound:g} ms" if bound != float('inf') else f">{low:g} ms"
+                lines.append(f"{label:>14s} {count:7d} {'#' * max(1, 40 * count // peak)}")
+            low = bound
+        return lines
+
+
+class StatePoller:
+    """
+    Background thread that reads the game state at a fixed rate
+    
+    Each read is published to a LatestState slot, tagged with the game
+    clock and when it was read, so a decider takes the freshest state
+    without waiting for a read, however long its last decision took.
+    The read function runs only on the poller thread; it may share the
+    memory reader with actions on other threads, whose pointer lookups
+    fall back to reading memory when a refresh drops the cache.
+    
+    In lockstep the next read waits until the consumer is done deciding
+    on the last state (done()), for a game that advances on every read (a
+    free-running HeadlessInterface): the game then stands still while a
+    decision is made, and runs as fast as decisions are made instead of
+    as fast as the poller thread reads.
+    """
+    
+    def __init__(self, read_state: Callable[[], Optional[GameState]], rate: float,
+                 lockstep: bool = False):
+        """
+        Initialize the poller
+        
+        Args:
+            read_state: Reads one state (None when not in game)
+            rate: Seconds between the starts of two reads
+            lockstep: Read again only once the consumer is done with the last state
+        """
+        self.read_state = read_state
+        self.rate = rate
+        self.lockstep = lockstep
+        self.slot = LatestState()
+        self.read_latency = LatencyHistogram()  # Duration of each read
+        self.error: Optional[BaseException] = None
+        self._sequence = 0
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+    
+    def start(self) -> None:
+        """Start polling"""
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run, name='state-poller', daemon=True)
+        self._thread.start()
+    
+    def stop(self) -> None:
+        """Stop polling and wait for the thread"""
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join()
+            self._thread = None
+    
+    @property
+    def running(self) -> bool:
+        """Whether the thread is polling"""
+        return self._thread is not None and self._thread.is_alive()
+    
+    def latest(self) -> Optional[PublishedState]:
+        """The most recent read, without waiting"""
+        return self.slot.latest()
+    
+    def wait_newer(self, sequence: int, timeout: float) -> Optional[PublishedState]:
+        """Wait for a read newer than sequence (None on timeout)"""
+        return self.slot.wait_newer(sequence, timeout)
+    
+    def done(self) -> None:
+        """Report the last read as decided on (lets a lockstep poller read again)"""
+        self.slot.done()
+    
+    def _run(self) -> None:
+        next_read = time.perf_counter()
+        while not self._stop.is_set():
+            start = time.perf_counter()
+            try:
+                state = self.read_state()
+            except Exception as e:  # Reported to the consumer, which decides
+                self.error = e
+                break
+            end = time.perf_counter()
+            self.read_latency.record(end - start)
+            self._sequence += 1
+            self.slot.publish(PublishedState(self._sequence, state.game_clock if state else -1,
+                                             end, state.freeze() if state else None))
+            
+            # Fixed rate; a read that overran starts the next one at once
+            next_read = max(next_read + self.rate, end)
+            self._stop.wait(next_read - end)
+            while self.lockstep and not self._stop.is_set() and not self.slot.wait_done(0.1):
+                pass
@@ -3,7 +3,10 @@ Game Reader Module
 Factory class for reading game objects from memory
 """
 
-from typing import List
+import dataclasses
+import struct
+from operator import itemgetter
+from typing import List, Optional, Sequence, Tuple
 
 from data.offsets import Offset
 from memory.reader import MemoryReader
@@ -12,8 +15,269 @@ from game.plant import PlantInfo
 from game.projectile import ProjectileInfo, ProjectileType
 from game.lawnmower import LawnmowerInfo
 from game.place_item import PlaceItemInfo
-from game.state import GameState, SeedInfo
+from game.state import GameState, SeedInfo, StateDelta, EntityDelta
 from game.grid import Grid
+from game.schedule import ReadSchedule
+
+
+# ============================================================================
+# Record Layouts
+# ============================================================================
+
+# Array lengths above this are taken as a board that is being torn down
+_MAX_RECORDS = 0x4000
+
+
+class RecordLayout:
+    """
+    Byte layout of one game structure, decoded with a single struct
+    
+    Fields are (name, offset, struct code) in constructor order. They are
+    packed into one struct in offset order with padding between them, so a
+    record decodes with one unpack_from() instead of a read per field, and
+    a whole array with one iter_unpack(). Fields that share an offset and
+    code (aliases in the Offset table) are decoded once. The struct starts
+    at the lowest field offset (start).
+    """
+    
+    def __init__(self, size: int, fields: Sequence[Tuple[str, int, str]],
+                 dead_offset: Optional[int] = None, cls=None, flags: Sequence[str] = ()):
+        """
+        Compile a layout
+        
+        Args:
+            size: Record size (array stride)
+            fields: (name, offset, struct code) of each decoded field
+            dead_offset: Offset of the is-dead byte, if records can be dead
+            cls: Dataclass built from (index, *fields); its fields after
+                index must match the names
+            flags: Names of int fields turned into bools (value != 0)
+        """
+        slots = set((offset, code) for _, offset, code in fields)
+        if dead_offset is not None:
+            slots.add((dead_offset, '?'))
+        slots = sorted(slots)
+        self.start = slots[0][0]
+        fmt, end = '<', self.start
+        for offset, code in slots:
+            if offset < end:
+                raise ValueError(f"Field at 0x{offset:X} overlaps the field before it")
+            if offset > end:
+                fmt += f'{offset - end}x'
+            fmt += code
+            end = offset + struct.calcsize(code)
+        
+        self.struct = struct.Struct(fmt)
+        self.size = size
+        self.dead_offset = dead_offset
+        self.cls = cls
+        self.fields = tuple(fields)
+        self.names = tuple(name for name, _, _ in fields)
+        self.flags = tuple(flags)
+        slot_index = {slot: i for i, slot in enumerate(slots)}
+        self._order = itemgetter(*(slot_index[(offset, code)] for _, offset, code in fields))
+        self._flags = tuple(self.names.index(name) for name in flags)
+        self._dead = slot_index[(dead_offset, '?')] if dead_offset is not None else None
+        # Bytes needed from a record's start; LM_DEAD lies past LAWNMOWER_SIZE
+        self.span = max(size, end)
+        
+        # One whole record per unpack, for arrays whose fields all lie inside a record
+        self._record = None
+        if 0 < end <= size:
+            self._record = struct.Struct(f'<{self.start}x{fmt[1:]}{size - end}x')
+        
+        if cls is not None:
+            expected = tuple(field.name for field in dataclasses.fields(cls)[1:])
+            if expected != self.names:
+                raise ValueError(f"{cls.__name__} layout fields {self.names} != {expected}")
+    
+    def unpack(self, data: bytes, base: int = 0) -> tuple:
+        """Decode the record starting at data[base] into field values"""
+        values = self._order(self.struct.unpack_from(data, base + self.start))
+        if self._flags:
+            values = list(values)
+            for i in self._flags:
+                values[i] = values[i] != 0
+        return values
+    
+    def build(self, data: bytes, base: int, index: int):
+        """Decode the record starting at data[base] into a cls instance"""
+        return self.cls(index, *self.unpack(data, base))
+    
+    def rows(self, data: bytes, count: int):
+        """
+        Raw struct values of each slot of an array of count records
+        
+        Rows compare equal exactly when the decoded fields and the dead
+        flag are equal, so they tell which slots changed between reads.
+        """
+        if self._record is not None:
+            return self._record.iter_unpack(memoryview(data)[:count * self.size])
+        return [self.struct.unpack_from(data, i * self.size + self.start) for i in range(count)]
+    
+    def from_row(self, index: int, row: tuple):
+        """Build the cls instance of a slot from its row"""
+        values = self._order(row)
+        if self._flags:
+            values = list(values)
+            for j in self._flags:
+                values[j] = values[j] != 0
+        return self.cls(index, *values)
+    
+    def build_all(self, data: bytes, count: int) -> list:
+        """Decode the live records of an array of count records"""
+        records = []
+        cls, order, dead, flags = self.cls, self._order, self._dead, self._flags
+        for i, row in enumerate(self.rows(data, count)):
+            if dead is not None and row[dead]:
+                continue
+            values = order(row)
+            if flags:
+                values = list(values)
+                for j in flags:
+                    values[j] = values[j] != 0
+            records.append(cls(i, *values))
+        return records
+    
+    def array_bytes(self, count: int) -> int:
+        """Bytes to read for an array of count records"""
+        return (count - 1) * self.size + self.span if count > 0 else 0
+
+
+ZOMBIE_LAYOUT = RecordLayout(Offset.ZOMBIE_SIZE, [
+    ('row', Offset.Z_ROW, 'i'),
+    ('x', Offset.Z_X, 'f'),
+    ('y', Offset.Z_Y, 'f'),
+    ('type', Offset.Z_TYPE, 'i'),
+    ('hp', Offset.Z_HP, 'i'),
+    ('hp_max', Offset.Z_HP_MAX, 'i'),
+    ('accessory_hp', Offset.Z_ACCESSORY_HP_1, 'i'),
+    ('state', Offset.Z_STATE, 'i'),
+    ('speed', Offset.Z_SPEED, 'f'),
+    ('slow_countdown', Offset.Z_SLOW_COUNTDOWN, 'i'),
+    ('freeze_countdown', Offset.Z_FREEZE_COUNTDOWN, 'i'),
+    ('butter_countdown', Offset.Z_BUTTER_COUNTDOWN, 'i'),
+    ('at_wave', Offset.Z_AT_WAVE, 'i'),
+    ('height', Offset.Z_HEIGHT, 'f'),
+    ('exist_time', Offset.Z_EXIST_TIME, 'i'),
+    ('state_countdown', Offset.Z_STATE_COUNTDOWN, 'i'),
+    ('is_eating', Offset.Z_IS_EAT, '?'),
+    ('hurt_width', Offset.Z_HURT_WIDTH, 'i'),
+    ('hurt_height', Offset.Z_HURT_HEIGHT, 'i'),
+    ('bullet_x', Offset.Z_BULLET_X, 'i'),
+    ('bullet_y', Offset.Z_BULLET_Y, 'i'),
+    ('attack_x', Offset.Z_ATTACK_X, 'i'),
+    ('attack_y', Offset.Z_ATTACK_Y, 'i'),
+], Offset.Z_DEAD, ZombieInfo)
+
+PLANT_LAYOUT = RecordLayout(Offset.PLANT_SIZE, [
+    ('row', Offset.P_ROW, 'i'),
+    ('col', Offset.P_COL, 'i'),
+    ('type', Offset.P_TYPE, 'i'),
+    ('hp', Offset.P_HP, 'i'),
+    ('hp_max', Offset.P_HP_MAX, 'i'),
+    ('state', Offset.P_STATE, 'i'),
+    ('shoot_countdown', Offset.P_SHOOT_COUNTDOWN, 'i'),
+    ('effective', Offset.P_EFFECTIVE, 'i'),
+    ('pumpkin_hp', Offset.P_PUMPKIN_HP, 'i'),
+    ('cob_countdown', Offset.P_COB_COUNTDOWN, 'i'),
+    ('cob_ready', Offset.P_COB_READY, '?'),
+    ('visible', Offset.P_VISIBLE, '?'),
+    ('explode_countdown', Offset.P_EXPLODE_COUNTDOWN, 'i'),
+    ('blover_countdown', Offset.P_BLOVER_COUNTDOWN, 'i'),
+    ('mushroom_countdown', Offset.P_MUSHROOM_COUNTDOWN, 'i'),
+    ('bungee_state', Offset.P_BUNGEE_STATE, 'i'),
+    ('hurt_width', Offset.P_HURT_WIDTH, 'i'),
+    ('hurt_height', Offset.P_HURT_HEIGHT, 'i'),
+], Offset.P_DEAD, PlantInfo, flags=('effective',))
+
+PROJECTILE_LAYOUT = RecordLayout(Offset.PROJECTILE_SIZE, [
+    ('x', Offset.PR_X, 'f'),
+    ('y', Offset.PR_Y, 'f'),
+    ('row', Offset.PR_ROW, 'i'),
+    ('type', Offset.PR_TYPE, 'i'),
+    ('exist_time', Offset.PR_EXIST_TIME, 'i'),
+    ('is_dead', Offset.PR_DEAD, '?'),
+    ('cob_target_x', Offset.PR_COB_TARGET_X, 'f'),
+    ('cob_target_row', Offset.PR_COB_TARGET_ROW, 'i'),
+], Offset.PR_DEAD, ProjectileInfo)
+
+LAWNMOWER_LAYOUT = RecordLayout(Offset.LAWNMOWER_SIZE, [
+    ('row', Offset.LM_ROW, 'i'),
+    ('x', Offset.LM_X, 'f'),
+    ('state', Offset.LM_STATE, 'i'),
+    ('is_dead', Offset.LM_DEAD, '?'),
+], Offset.LM_DEAD, LawnmowerInfo)
+
+PLACE_ITEM_LAYOUT = RecordLayout(Offset.PLACE_ITEM_SIZE, [
+    ('row', Offset.PI_ROW, 'i'),
+    ('col', Offset.PI_COL, 'i'),
+    ('type', Offset.PI_TYPE, 'i'),
+    ('value', Offset.PI_VALUE, 'i'),
+    ('is_dead', Offset.PI_DEAD, '?'),
+], Offset.PI_DEAD, PlaceItemInfo)
+
+SEED_LAYOUT = RecordLayout(Offset.SEED_SIZE, [
+    ('type', Offset.S_TYPE, 'i'),
+    ('recharge_countdown', Offset.S_RECHARGE_COUNTDOWN, 'i'),
+    ('recharge_time', Offset.S_RECHARGE_TIME, 'i'),
+    ('usable', Offset.S_USABLE, '?'),
+    ('imitator_type', Offset.S_IMITATOR_TYPE, 'i'),
+], None, SeedInfo)
+
+# Board fields from ZOMBIE_ARRAY to SEED_ARRAY: the array pointers and lengths
+BOARD_ARRAYS_LAYOUT = RecordLayout(0, [
+    ('zombie_array', Offset.ZOMBIE_ARRAY, 'I'),
+    ('zombie_count_max', Offset.ZOMBIE_COUNT_MAX, 'i'),
+    ('plant_array', Offset.PLANT_ARRAY, 'I'),
+    ('plant_count_max', Offset.PLANT_COUNT_MAX, 'i'),
+    ('projectile_array', Offset.PROJECTILE_ARRAY, 'I'),
+    ('projectile_count_max', Offset.PROJECTILE_COUNT_MAX, 'i'),
+    ('lawnmower_array', Offset.LAWNMOWER_ARRAY, 'I'),
+    ('lawnmower_count_max', Offset.LAWNMOWER_COUNT_MAX, 'i'),
+    ('place_item_array', Offset.PLACE_ITEM_ARRAY, 'I'),
+    ('place_item_count_max', Offset.PLACE_ITEM_COUNT_MAX, 'i'),
+    ('seed_array', Offset.SEED_ARRAY, 'I'),
+])
+
+# Board scalars from SCENE to CLICK_PAO_COUNTDOWN, named as GameState fields
+BOARD_SCALARS_LAYOUT = RecordLayout(0, [
+    ('sun', Offset.SUN, 'i'),
+    ('wave', Offset.WAVE, 'i'),
+    ('total_waves', Offset.TOTAL_WAVE, 'i'),
+    ('refresh_countdown', Offset.REFRESH_COUNTDOWN, 'i'),
+    ('huge_wave_countdown', Offset.HUGE_WAVE_COUNTDOWN, 'i'),
+    ('game_clock', Offset.GAME_CLOCK, 'i'),
+    ('global_clock', Offset.GLOBAL_CLOCK, 'i'),
+    ('initial_countdown', Offset.INITIAL_COUNTDOWN, 'i'),
+    ('click_pao_countdown', Offset.CLICK_PAO_COUNTDOWN, 'i'),
+    ('zombie_refresh_hp', Offset.ZOMBIE_REFRESH_HP, 'i'),
+    ('scene', Offset.SCENE, 'i'),
+])
+
+
+# Entity sections of the state: name, layout, BOARD_ARRAYS_LAYOUT field prefix
+_SECTION_ARRAYS = (
+    ('zombies', ZOMBIE_LAYOUT, 'zombie'),
+    ('plants', PLANT_LAYOUT, 'plant'),
+    ('projectiles', PROJECTILE_LAYOUT, 'projectile'),
+    ('lawnmowers', LAWNMOWER_LAYOUT, 'lawnmower'),
+    ('place_items', PLACE_ITEM_LAYOUT, 'place_item'),
+    ('seeds', SEED_LAYOUT, 'seed'),
+)
+
+
+class _ArrayCache:
+    """One entity array as of the previous incremental read"""
+    
+    __slots__ = ('array', 'data', 'rows', 'records', 'live')
+    
+    def __init__(self, array: int, data: bytes, rows: list, records: list, live: list):
+        self.array = array
+        self.data = data
+        self.rows = rows  # Raw struct values per slot
+        self.records = records  # Info object per slot, None where dead
+        self.live = live
 
 
 class GameReader:
@@ -21,16 +285,37 @@ class GameReader:
     Factory class for reading game entities from memory
     
     Converts raw memory addresses into structured Python objects.
+    
+    In incremental mode read_game_state() keeps each array's previous
+    bytes and rows: an array whose bytes did not change is not decoded
+    again, and only slots whose decoded fields changed get new info
+    objects. The state's delta field lists the slots that were added,
+    removed or changed.
+    
+    With a ReadSchedule, read_game_state() reads only the sections the
+    schedule says are due and serves the others as last read; the
+    state's ages field tells how old each section is.
     """
     
-    def __init__(self, reader: MemoryReader):
+    def __init__(self, reader: MemoryReader, incremental: bool = False,
+                 schedule: Optional[ReadSchedule] = None):
         """
         Initialize GameReader
         
         Args:
             reader: MemoryReader instance for reading memory
+            incremental: Reuse unchanged entities between read_game_state()
+                calls and report a StateDelta
+            schedule: Read each entity section only when it is due
         """
         self.reader = reader
+        self.incremental = incremental
+        self.schedule = schedule
+        self._arrays = {}
+        self._sections = {}  # Section name -> records as last read
+        self._scalars = None
+        self._board = 0
+        self._generation = -1
     
     # ========================================================================
     # Single Entity Readers
@@ -43,36 +328,11 @@ class GameReader:
         Args:
             addr: Base address of zombie structure
             index: Index in zombie array
-            
+        
         Returns:
             ZombieInfo instance
         """
-        return ZombieInfo(
-            index=index,
-            row=self.reader.read_int(addr + Offset.Z_ROW),
-            x=self.reader.read_float(addr + Offset.Z_X),
-            y=self.reader.read_float(addr + Offset.Z_Y),
-            type=self.reader.read_int(addr + Offset.Z_TYPE),
-            hp=self.reader.read_int(addr + Offset.Z_HP),
-            hp_max=self.reader.read_int(addr + Offset.Z_HP_MAX),
-            accessory_hp=self.reader.read_int(addr + Offset.Z_ACCESSORY_HP_1),
-            state=self.reader.read_int(addr + Offset.Z_STATE),
-            speed=self.reader.read_float(addr + Offset.Z_SPEED),
-            slow_countdown=self.reader.read_int(addr + Offset.Z_SLOW_COUNTDOWN),
-            freeze_countdown=self.reader.read_int(addr + Offset.Z_FREEZE_COUNTDOWN),
-            butter_countdown=self.reader.read_int(addr + Offset.Z_BUTTER_COUNTDOWN),
-            at_wave=self.reader.read_int(addr + Offset.Z_AT_WAVE),
-            height=self.reader.read_float(addr + Offset.Z_HEIGHT),
-            exist_time=self.reader.read_int(addr + Offset.Z_EXIST_TIME),
-            state_countdown=self.reader.read_int(addr + Offset.Z_STATE_COUNTDOWN),
-            is_eating=self.reader.read_bool(addr + Offset.Z_IS_EAT),
-            hurt_width=self.reader.read_int(addr + Offset.Z_HURT_WIDTH),
-            hurt_height=self.reader.read_int(addr + Offset.Z_HURT_HEIGHT),
-            bullet_x=self.reader.read_int(addr + Offset.Z_BULLET_X),
-            bullet_y=self.reader.read_int(addr + Offset.Z_BULLET_Y),
-            attack_x=self.reader.read_int(addr + Offset.Z_ATTACK_X),
-            attack_y=self.reader.read_int(addr + Offset.Z_ATTACK_Y),
-        )
+        return ZOMBIE_LAYOUT.build(self.reader.read_bytes(addr, ZOMBIE_LAYOUT.span), 0, index)
     
     def read_plant(self, addr: int, index: int) -> PlantInfo:
         """
@@ -81,31 +341,11 @@ class GameReader:
         Args:
             addr: Base address of plant structure
             index: Index in plant array
-            
+        
         Returns:
             PlantInfo instance
         """
-        return PlantInfo(
-            index=index,
-            row=self.reader.read_int(addr + Offset.P_ROW),
-            col=self.reader.read_int(addr + Offset.P_COL),
-            type=self.reader.read_int(addr + Offset.P_TYPE),
-            hp=self.reader.read_int(addr + Offset.P_HP),
-            hp_max=self.reader.read_int(addr + Offset.P_HP_MAX),
-            state=self.reader.read_int(addr + Offset.P_STATE),
-            shoot_countdown=self.reader.read_int(addr + Offset.P_SHOOT_COUNTDOWN),
-            effective=self.reader.read_int(addr + Offset.P_EFFECTIVE) != 0,
-            pumpkin_hp=self.reader.read_int(addr + Offset.P_PUMPKIN_HP),
-            cob_countdown=self.reader.read_int(addr + Offset.P_COB_COUNTDOWN),
-            cob_ready=self.reader.read_bool(addr + Offset.P_COB_READY),
-            visible=self.reader.read_bool(addr + Offset.P_VISIBLE),
-            explode_countdown=self.reader.read_int(addr + Offset.P_EXPLODE_COUNTDOWN),
-            blover_countdown=self.reader.read_int(addr + Offset.P_BLOVER_COUNTDOWN),
-            mushroom_countdown=self.reader.read_int(addr + Offset.P_MUSHROOM_COUNTDOWN),
-            bungee_state=self.reader.read_int(addr + Offset.P_BUNGEE_STATE),
-            hurt_width=self.reader.read_int(addr + Offset.P_HURT_WIDTH),
-            hurt_height=self.reader.read_int(addr + Offset.P_HURT_HEIGHT),
-        )
+        return PLANT_LAYOUT.build(self.reader.read_bytes(addr, PLANT_LAYOUT.span), 0, index)
     
     def read_projectile(self, addr: int, index: int) -> ProjectileInfo:
         """
@@ -114,21 +354,11 @@ class GameReader:
         Args:
             addr: Base address of projectile structure
             index: Index in projectile array
-            
+        
         Returns:
             ProjectileInfo instance
         """
-        return ProjectileInfo(
-            index=index,
-            x=self.reader.read_float(addr + Offset.PR_X),
-            y=self.reader.read_float(addr + Offset.PR_Y),
-            row=self.reader.read_int(addr + Offset.PR_ROW),
-            type=self.reader.read_int(addr + Offset.PR_TYPE),
-            exist_time=self.reader.read_int(addr + Offset.PR_EXIST_TIME),
-            is_dead=self.reader.read_bool(addr + Offset.PR_DEAD),
-            cob_target_x=self.reader.read_float(addr + Offset.PR_COB_TARGET_X),
-            cob_target_row=self.reader.read_int(addr + Offset.PR_COB_TARGET_ROW),
-        )
+        return PROJECTILE_LAYOUT.build(self.reader.read_bytes(addr, PROJECTILE_LAYOUT.span), 0, index)
     
     def read_lawnmower(self, addr: int, index: int) -> LawnmowerInfo:
         """
@@ -137,17 +367,11 @@ class GameReader:
         Args:
             addr: Base address of lawnmower structure
             index: Index in lawnmower array
-            
+        
         Returns:
             LawnmowerInfo instance
         """
-        return LawnmowerInfo(
-            index=index,
-            row=self.reader.read_int(addr + Offset.LM_ROW),
-            x=self.reader.read_float(addr + Offset.LM_X),
-            state=self.reader.read_int(addr + Offset.LM_STATE),
-            is_dead=self.reader.read_bool(addr + Offset.LM_DEAD),
-        )
+        return LAWNMOWER_LAYOUT.build(self.reader.read_bytes(addr, LAWNMOWER_LAYOUT.span), 0, index)
     
     def read_place_item(self, addr: int, index: int) -> PlaceItemInfo:
         """
@@ -156,18 +380,11 @@ class GameReader:
         Args:
             addr: Base address of place item structure
             index: Index in place item array
-            
+        
         Returns:
             PlaceItemInfo instance
         """
-        return PlaceItemInfo(
-            index=index,
-            row=self.reader.read_int(addr + Offset.PI_ROW),
-            col=self.reader.read_int(addr + Offset.PI_COL),
-            type=self.reader.read_int(addr + Offset.PI_TYPE),
-            value=self.reader.read_int(addr + Offset.PI_VALUE),
-            is_dead=self.reader.read_bool(addr + Offset.PI_DEAD),
-        )
+        return PLACE_ITEM_LAYOUT.build(self.reader.read_bytes(addr, PLACE_ITEM_LAYOUT.span), 0, index)
     
     def read_seed(self, addr: int, index: int) -> SeedInfo:
         """
@@ -176,23 +393,38 @@ class GameReader:
         Args:
             addr: Base address of seed structure
             index: Index in seed array
-            
+        
         Returns:
             SeedInfo instance
         """
-        return SeedInfo(
-            index=index,
-            type=self.reader.read_int(addr + Offset.S_TYPE),
-            recharge_countdown=self.reader.read_int(addr + Offset.S_RECHARGE_COUNTDOWN),
-            recharge_time=self.reader.read_int(addr + Offset.S_RECHARGE_TIME),
-            usable=self.reader.read_bool(addr + Offset.S_USABLE),
-            imitator_type=self.reader.read_int(addr + Offset.S_IMITATOR_TYPE),
-        )
+        return SEED_LAYOUT.build(self.reader.read_bytes(addr, SEED_LAYOUT.span), 0, index)
     
     # ========================================================================
     # Array Readers
     # ========================================================================
     
+    def _read_records(self, layout: RecordLayout, array: int, count: int) -> list:
+        """
+        Read a whole entity array with one read and decode its live records
+        
+        Args:
+            layout: Record layout of the array
+            array: Array base address
+            count: Number of records in the array
+        
+        Returns:
+            Decoded records, dead ones skipped
+        """
+        if array == 0 or count <= 0 or count > _MAX_RECORDS:
+            return []
+        data = self.reader.read_bytes(array, layout.array_bytes(count))
+        return layout.build_all(data, count)
+    
+    def _read_board_block(self, layout: RecordLayout, board: int) -> dict:
+        """Read the board fields of a layout with one read, by name"""
+        data = self.reader.read_bytes(board + layout.start, layout.span - layout.start)
+        return dict(zip(layout.names, layout.unpack(data, -layout.start)))
+    
     def read_all_zombies(self) -> List[ZombieInfo]:
         """
         Read all zombies from memory
@@ -200,20 +432,13 @@ class GameReader:
         Returns:
             List of ZombieInfo instances (alive zombies only)
         """
-        zombies = []
-        zombie_array = self.reader.get_zombie_array()
-        if zombie_array == 0:
-            return zombies
-        
-        zombie_count_max = self.reader.get_zombie_count_max()
-        
-        for i in range(zombie_count_max):
-            addr = zombie_array + i * Offset.ZOMBIE_SIZE
-            is_dead = self.reader.read_bool(addr + Offset.Z_DEAD)
-            if not is_dead:
-                zombies.append(self.read_zombie(addr, i))
+        board = self.reader.get_board()
+        if board == 0:
+            return []
         
-        return zombies
+        array = self.reader.get_board_pointer(Offset.ZOMBIE_ARRAY, board)
+        count = self.reader.read_int(board + Offset.ZOMBIE_COUNT_MAX)
+        return self._read_records(ZOMBIE_LAYOUT, array, count)
     
     def read_all_plants(self) -> List[PlantInfo]:
         """
@@ -222,20 +447,13 @@ class GameReader:
         Returns:
             List of PlantInfo instances (alive plants only)
         """
-        plants = []
-        plant_array = self.reader.get_plant_array()
-        if plant_array == 0:
-            return plants
-        
-        plant_count_max = self.reader.get_plant_count_max()
-        
-        for i in range(plant_count_max):
-            addr = plant_array + i * Offset.PLANT_SIZE
-            is_dead = self.reader.read_bool(addr + Offset.P_DEAD)
-            if not is_dead:
-                plants.append(self.read_plant(addr, i))
+        board = self.reader.get_board()
+        if board == 0:
+            return []
         
-        return plants
+        array = self.reader.get_board_pointer(Offset.PLANT_ARRAY, board)
+        count = self.reader.read_int(board + Offset.PLANT_COUNT_MAX)
+        return self._read_records(PLANT_LAYOUT, array, count)
     
     def read_all_projectiles(self) -> List[ProjectileInfo]:
         """
@@ -244,24 +462,13 @@ class GameReader:
         Returns:
             List of ProjectileInfo instances (alive projectiles only)
         """
-        projectiles = []
         board = self.reader.get_board()
         if board == 0:
-            return projectiles
+            return []
         
-        projectile_array = self.reader.read_int(board + Offset.PROJECTILE_ARRAY)
-        if projectile_array == 0:
-            return projectiles
-        
-        projectile_count_max = self.reader.read_int(board + Offset.PROJECTILE_COUNT_MAX)
-        
-        for i in range(projectile_count_max):
-            addr = projectile_array + i * Offset.PROJECTILE_SIZE
-            is_dead = self.reader.read_bool(addr + Offset.PR_DEAD)
-            if not is_dead:
-                projectiles.append(self.read_projectile(addr, i))
-        
-        return projectiles
+        array = self.reader.get_board_pointer(Offset.PROJECTILE_ARRAY, board)
+        count = self.reader.read_int(board + Offset.PROJECTILE_COUNT_MAX)
+        return self._read_records(PROJECTILE_LAYOUT, array, count)
     
     def read_all_lawnmowers(self) -> List[LawnmowerInfo]:
         """
@@ -270,24 +477,13 @@ class GameReader:
         Returns:
             List of LawnmowerInfo instances (alive lawnmowers only)
         """
-        lawnmowers = []
         board = self.reader.get_board()
         if board == 0:
-            return lawnmowers
-        
-        lawnmower_array = self.reader.read_int(board + Offset.LAWNMOWER_ARRAY)
-        if lawnmower_array == 0:
-            return lawnmowers
-        
-        lawnmower_count_max = self.reader.read_int(board + Offset.LAWNMOWER_COUNT_MAX)
-        
-        for i in range(lawnmower_count_max):
-            addr = lawnmower_array + i * Offset.LAWNMOWER_SIZE
-            is_dead = self.reader.read_bool(addr + Offset.LM_DEAD)
-            if not is_dead:
-                lawnmowers.append(self.read_lawnmower(addr, i))
+            return []
         
-        return lawnmowers
+        array = self.reader.get_board_pointer(Offset.LAWNMOWER_ARRAY, board)
+        count = self.reader.read_int(board + Offset.LAWNMOWER_COUNT_MAX)
+        return self._read_records(LAWNMOWER_LAYOUT, array, count)
     
     def read_all_place_items(self) -> List[PlaceItemInfo]:
         """
@@ -296,24 +492,13 @@ class GameReader:
         Returns:
             List of PlaceItemInfo instances (alive items only)
         """
-        items = []
         board = self.reader.get_board()
         if board == 0:
-            return items
+            return []
         
-        place_item_array = self.reader.read_int(board + Offset.PLACE_ITEM_ARRAY)
-        if place_item_array == 0:
-            return items
-        
-        place_item_count_max = self.reader.read_int(board + Offset.PLACE_ITEM_COUNT_MAX)
-        
-        for i in range(place_item_count_max):
-            addr = place_item_array + i * Offset.PLACE_ITEM_SIZE
-            is_dead = self.reader.read_bool(addr + Offset.PI_DEAD)
-            if not is_dead:
-                items.append(self.read_place_item(addr, i))
-        
-        return items
+        array = self.reader.get_board_pointer(Offset.PLACE_ITEM_ARRAY, board)
+        count = self.reader.read_int(board + Offset.PLACE_ITEM_COUNT_MAX)
+        return self._read_records(PLACE_ITEM_LAYOUT, array, count)
     
     def read_all_seeds(self, seed_count: int = 10) -> List[SeedInfo]:
         """
@@ -321,20 +506,11 @@ class GameReader:
         
         Args:
             seed_count: Number of seed cards to read (default 10)
-            
+        
         Returns:
             List of SeedInfo instances
         """
-        seeds = []
-        seed_array = self.reader.get_seed_array()
-        if seed_array == 0:
-            return seeds
-        
-        for i in range(seed_count):
-            addr = seed_array + i * Offset.SEED_SIZE
-            seeds.append(self.read_seed(addr, i))
-        
-        return seeds
+        return self._read_records(SEED_LAYOUT, self.reader.get_seed_array(), seed_count)
     
     # ========================================================================
     # Full State Reader
@@ -344,6 +520,10 @@ class GameReader:
         """
         Read complete game state from memory
         
+        The board's scalars, its array pointers and each entity array are
+        read in one block apiece; with a schedule, entity arrays that are
+        not due keep their previous records.
+        
         Returns:
             GameState instance with all game data
         """
@@ -351,36 +531,141 @@ class GameReader:
         if board == 0:
             return GameState()
         
-        # Read all entities
-        zombies = self.read_all_zombies()
-        plants = self.read_all_plants()
-        projectiles = self.read_all_projectiles()
-        lawnmowers = self.read_all_lawnmowers()
-        place_items = self.read_all_place_items()
-        seeds = self.read_all_seeds()
+        # A new board (or a dropped pointer cache) starts over
+        full = board != self._board or self.reader.generation != self._generation
+        if full:
+            self._arrays, self._sections, self._scalars = {}, {}, None
+            self._board, self._generation = board, self.reader.generation
+            if self.schedule is not None:
+                self.schedule.reset()
+        delta = StateDelta(full=full) if self.incremental else None
+        
+        scalars = self._read_board_block(BOARD_SCALARS_LAYOUT, board)
+        if delta is not None:
+            delta.scalars_changed = scalars != self._scalars
+            self._scalars = scalars
+        game_clock = scalars['game_clock']
+        due = self.schedule.plan(game_clock) if self.schedule is not None else None
+        
+        # Read the entities that are due
+        arrays = self._read_board_block(BOARD_ARRAYS_LAYOUT, board)
+        sections = {}
+        for name, layout, prefix in _SECTION_ARRAYS:
+            if due is not None and name not in due and name in self._sections:
+                sections[name] = list(self._sections[name])
+                continue
+            count = arrays[f'{prefix}_count_max'] if prefix != 'seed' else 10
+            sections[name] = self._read_array(name, layout, arrays[f'{prefix}_array'],
+                                              count, delta)
+            if due is not None:
+                self._sections[name] = sections[name]
+        
+        ages = {}
+        if due is not None:
+            self.schedule.mark_read(due, game_clock)
+            ages = self.schedule.ages(game_clock)
         
         # Build plant grid
         plant_grid = Grid()
-        for plant in plants:
+        for plant in sections['plants']:
             plant_grid.set(plant.row, plant.col, plant)
         
         return GameState(
-            sun=self.reader.read_int(board + Offset.SUN),
-            wave=self.reader.read_int(board + Offset.WAVE),
-            total_waves=self.reader.read_int(board + Offset.TOTAL_WAVE),
-            refresh_countdown=self.reader.read_int(board + Offset.REFRESH_COUNTDOWN),
-            huge_wave_countdown=self.reader.read_int(board + Offset.HUGE_WAVE_COUNTDOWN),
-            game_clock=self.reader.read_int(board + Offset.GAME_CLOCK),
-            global_clock=self.reader.read_int(board + Offset.GLOBAL_CLOCK),
-            initial_countdown=self.reader.read_int(board + Offset.INITIAL_COUNTDOWN),
-            click_pao_countdown=self.reader.read_int(board + Offset.CLICK_PAO_COUNTDOWN),
-            zombie_refresh_hp=self.reader.read_int(board + Offset.ZOMBIE_REFRESH_HP),
-            scene=self.reader.read_int(board + Offset.SCENE),
-            zombies=zombies,
-            plants=plants,
-            seeds=seeds,
-            projectiles=projectiles,
-            lawnmowers=lawnmowers,
-            place_items=place_items,
             plant_grid=plant_grid,
+            delta=delta,
+            ages=ages,
+            **sections,
+            **scalars,
         )
+    
+    def _read_array(self, name: str, layout: RecordLayout, array: int, count: int,
+                    delta: Optional[StateDelta]) -> list:
+        """
+        Read an entity array, incrementally when a delta is being built
+        
+        Args:
+            name: Array name (the StateDelta field)
+            layout: Record layout of the array
+            array: Array base address
+            count: Number of records in the array
+            delta: Delta to record the changes in (None: plain read)
+        
+        Returns:
+            Live records; unchanged ones are the previous read's objects
+        """
+        if delta is None:
+            return self._read_records(layout, array, count)
+        
+        if array == 0 or count <= 0 or count > _MAX_RECORDS:
+            array, count, data = 0, 0, b''
+        else:
+            data = self.reader.read_bytes(array, layout.array_bytes(count))
+        
+        part = getattr(delta, name)
+        previous = self._arrays.get(name)
+        if previous is not None and previous.array != array:
+            # The array moved: everything in it is new
+            part.removed.extend(i for i, record in enumerate(previous.records) if record)
+            previous = None
+        if previous is not None and previous.data == data:
+            return list(previous.live)
+        
+        old_rows = previous.rows if previous else []
+        old_records = previous.records if previous else []
+        rows = list(layout.rows(data, count))
+        known = min(len(old_records), count)
+        records = old_records[:count] + [None] * (count - known)
+        dead, build = layout._dead, layout.from_row
+        
+        # Only slots whose row differs (or is new) need looking at
+        dirty = [i for i, (row, old) in enumerate(zip(rows, old_rows)) if row != old]
+        dirty.extend(range(known, count))
+        for i in dirty:
+            row, old = rows[i], records[i]
+            if dead is not None and row[dead]:
+                if old is not None:
+                    part.removed.append(i)
+                    records[i] = None
+                continue
+            records[i] = build(i, row)
+            (part.changed if old is not None else part.added).append(i)
+        part.removed.extend(i for i in range(count, len(old_records)) if old_records[i])
+        live = [record for record in records if record is not None]
+        
+        self._arrays[name] = _ArrayCache(array, data, rows, records, live)
+        return list(live)
+    
+    # ========================================================================
+    # Memory Regions
+    # ========================================================================
+    
+    def state_regions(self) -> List[Tuple[int, int]]:
+        """
+        Memory that reading the game state touches, for capturing an image
+        
+        Returns:
+            (address, size) of the base pointer, the PvzBase and Board
+            objects and every entity array (empty when not in a board)
+        """
+        base = self.reader.get_pvz_base()
+        board = self.reader.get_board()
+        if board == 0:
+            return []
+        
+        regions = [(Offset.BASE, 4), (base, Offset.GAME_UI + 4),
+                   (board, Offset.CLICK_PAO_COUNTDOWN + 4)]
+        arrays = self._read_board_block(BOARD_ARRAYS_LAYOUT, board)
+        for layout, name in ((ZOMBIE_LAYOUT, 'zombie'), (PLANT_LAYOUT, 'plant'),
+                             (PROJECTILE_LAYOUT, 'projectile'), (LAWNMOWER_LAYOUT, 'lawnmower'),
+                             (PLACE_ITEM_LAYOUT, 'place_item')):
+            count = arrays[f'{name}_count_max']
+            if arrays[f'{name}_array'] and 0 < count <= _MAX_RECORDS:
+                regions.append((arrays[f'{name}_array'], layout.array_bytes(count)))
+        regions.append((arrays['seed_array'], SEED_LAYOUT.array_bytes(10)))
+        
+        # Collectible items, which collect_all_items() walks
+        items = self.reader.get_item_array()
+        item_count = self.reader.get_item_count_max()
+        if items and 0 < item_count <= _MAX_RECORDS:
+            regions.append((items, item_count * Offset.ITEM_SIZE))
+        return [(address, size) for address, size in regions if address]
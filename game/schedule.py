@@ -0,0 +1,111 @@
+"""
+Read Schedule Module
+Per-section refresh periods and staleness budgets for state reads
+"""
+
+import threading
+from typing import Dict, Iterable, NamedTuple, Optional, Set
+
+
+class SectionPolicy(NamedTuple):
+    """How often one section of the state is read, in game centiseconds"""
+    period: int  # Age at which the section is read again
+    budget: int  # Most age the section may reach while it is served (>= period)
+
+
+# Entity sections of a GameState, each one array of the game
+SECTIONS = ('zombies', 'plants', 'projectiles', 'lawnmowers', 'place_items', 'seeds')
+
+# Zombies move every frame; projectiles only seed MCTS rollouts; plants and
+# seed cards change on actions, eating and recharges; lawnmowers and grave
+# stones hardly ever change
+DEFAULT_POLICIES: Dict[str, SectionPolicy] = {
+    'zombies': SectionPolicy(0, 0),
+    'projectiles': SectionPolicy(10, 15),
+    'plants': SectionPolicy(20, 30),
+    'seeds': SectionPolicy(20, 30),
+    'lawnmowers': SectionPolicy(100, 200),
+    'place_items': SectionPolicy(100, 200),
+}
+
+
+class ReadSchedule:
+    """
+    Decides which sections of the state each poll reads
+    
+    A section is read again once it is period old, or earlier when it
+    would pass its budget before the next poll: the gap between the
+    last two polls is taken as the next one. Ages are in game clock
+    centiseconds, so a paused game does not go stale. Consumers mark
+    sections required fresh for a decision with require_fresh(); the
+    next poll reads them whatever their age.
+    
+    The board scalars (sun, clocks, wave) are read on every poll and are
+    not scheduled.
+    """
+    
+    def __init__(self, policies: Optional[Dict[str, SectionPolicy]] = None):
+        """
+        Initialize the schedule
+        
+        Args:
+            policies: Policies replacing the defaults of their sections
+        """
+        self.policies = dict(DEFAULT_POLICIES)
+        self.policies.update(policies or {})
+        for name, policy in self.policies.items():
+            if policy.budget < policy.period:
+                raise ValueError(f"Section {name}: budget below its period")
+        self._read_at: Dict[str, int] = {}  # Game clock of each section's last read
+        self._last_clock: Optional[int] = None
+        self._gap = 0  # Game clock between the last two polls
+        self._required: Set[str] = set()
+        self._lock = threading.Lock()  # Polls and require_fresh() come from different threads
+    
+    def require_fresh(self, *sections: str) -> None:
+        """Have the next poll read these sections (all when none are given)"""
+        with self._lock:
+            self._required.update(sections or SECTIONS)
+    
+    def reset(self) -> None:
+        """Forget every read (a new board): the next poll reads everything"""
+        with self._lock:
+            self._read_at = {}
+            self._last_clock = None
+            self._gap = 0
+    
+    def plan(self, game_clock: int) -> Set[str]:
+        """
+        Sections the poll at game_clock reads
+        
+        The caller reads them and reports it with mark_read().
+        """
+        with self._lock:
+            if self._last_clock is not None and game_clock >= self._last_clock:
+                self._gap = game_clock - self._last_clock
+            elif self._last_clock is not None:
+                self._read_at = {}  # The clock went back: a new game on the same board
+            self._last_clock = game_clock
+            
+            due, self._required = self._required, set()
+            for name in SECTIONS:
+                read_at = self._read_at.get(name)
+                if read_at is None:
+                    due.add(name)
+                    continue
+                policy = self.policies[name]
+                age = game_clock - read_at
+                if age >= policy.period or age + self._gap > policy.budget:
+                    due.add(name)
+            return due
+    
+    def mark_read(self, sections: Iterable[str], game_clock: int) -> None:
+        """Record that sections were read at game_clock"""
+        with self._lock:
+            for name in sections:
+                self._read_at[name] = game_clock
+    
+    def ages(self, game_clock: int) -> Dict[str, int]:
+        """Game centiseconds since each section was read"""
+        with self._lock:
+            return {name: game_clock - read_at for name, read_at in self._read_at.items()}
@@ -0,0 +1,213 @@
+"""
+State Snapshot Module
+Immutable, compact snapshots of game states and the differences between them
+"""
+
+import struct
+from dataclasses import dataclass
+from typing import Tuple
+
+from game.state import GameState
+
+
+# Little-endian layout of each packed record, field for field as the
+# snapshot classes below; positions and speeds are float32 as in the game
+_ZOMBIE_RECORD = struct.Struct('<HBBffiiiifiiih?')
+_PLANT_RECORD = struct.Struct('<HBBBiiii?ii?')
+
+# Pixels a zombie may move between two snapshots beyond its walking speed
+# before the move counts as a jump (pole vaults, dolphins, bungees, ...)
+JUMP_SLACK = 10.0
+
+
+@dataclass(frozen=True, slots=True)
+class ZombieSnapshot:
+    """A zombie as it was when its state was snapshotted"""
+    index: int  # Index in zombie array
+    type: int
+    row: int
+    x: float
+    y: float
+    hp: int
+    hp_max: int
+    accessory_hp: int
+    state: int
+    speed: float  # Pixels per cs
+    slow_countdown: int
+    freeze_countdown: int
+    butter_countdown: int
+    at_wave: int
+    is_eating: bool
+    
+    @property
+    def total_hp(self) -> int:
+        """Get total HP including accessory"""
+        return self.hp + self.accessory_hp
+
+
+@dataclass(frozen=True, slots=True)
+class PlantSnapshot:
+    """A plant as it was when its state was snapshotted"""
+    index: int  # Index in plant array
+    row: int
+    col: int
+    type: int
+    hp: int
+    hp_max: int
+    state: int
+    shoot_countdown: int
+    effective: bool
+    pumpkin_hp: int
+    cob_countdown: int
+    cob_ready: bool
+
+
+@dataclass(frozen=True, slots=True)
+class StateSnapshot:
+    """
+    Immutable snapshot of a GameState for histories
+    
+    The alive zombies and plants are kept packed, one fixed-size record
+    each (47 and 31 bytes), and unpacked into ZombieSnapshot and
+    PlantSnapshot objects only when asked for. Projectiles, place items,
+    seed cards and lawnmowers are not kept.
+    """
+    game_clock: int
+    sun: int
+    wave: int
+    total_waves: int
+    scene: int
+    zombie_data: bytes
+    plant_data: bytes
+    
+    @classmethod
+    def of(cls, state: GameState) -> 'StateSnapshot':
+        """Snapshot a game state"""
+        zombies = b''.join([_ZOMBIE_RECORD.pack(
+            z.index, z.type, z.row, z.x, z.y, z.hp, z.hp_max, z.accessory_hp, z.state, z.speed,
+            z.slow_countdown, z.freeze_countdown, z.butter_countdown, z.at_wave, z.is_eating)
+            for z in state.alive_zombies])
+        plants = b''.join([_PLANT_RECORD.pack(
+            p.index, p.row, p.col, p.type, p.hp, p.hp_max, p.state, p.shoot_countdown,
+            p.effective, p.pumpkin_hp, p.cob_countdown, p.cob_ready)
+            for p in state.alive_plants])
+        return cls(state.game_clock, state.sun, state.wave, state.total_waves, state.scene,
+                   zombies, plants)
+    
+    @property
+    def zombies(self) -> Tuple[ZombieSnapshot, ...]:
+        """Alive zombies, in array order"""
+        return tuple(ZombieSnapshot(*r) for r in _ZOMBIE_RECORD.iter_unpack(self.zombie_data))
+    
+    @property
+    def plants(self) -> Tuple[PlantSnapshot, ...]:
+        """Alive plants, in array order"""
+        return tuple(PlantSnapshot(*r) for r in _PLANT_RECORD.iter_unpack(self.plant_data))
+    
+    @property
+    def zombie_count(self) -> int:
+        """Get number of alive zombies"""
+        return len(self.zombie_data) // _ZOMBIE_RECORD.size
+    
+    @property
+    def plant_count(self) -> int:
+        """Get number of alive plants"""
+        return len(self.plant_data) // _PLANT_RECORD.size
+
+
+@dataclass(frozen=True, slots=True)
+class HpChange:
+    """An entity whose HP changed between two snapshots"""
+    kind: str  # 'zombie' or 'plant'
+    index: int
+    type: int
+    before: int  # Total HP (zombies: body and accessory)
+    after: int
+
+
+@dataclass(frozen=True, slots=True)
+class PositionJump:
+    """A zombie that moved further than it walks, or changed rows"""
+    index: int
+    type: int
+    row_before: int
+    x_before: float
+    row: int
+    x: float
+
+
+@dataclass(frozen=True, slots=True)
+class StateDiff:
+    """What changed from one snapshot to a later one"""
+    elapsed: int  # Game clock cs between the snapshots
+    sun: int  # Sun gained (negative: spent)
+    zombies_appeared: Tuple[ZombieSnapshot, ...]
+    zombies_died: Tuple[ZombieSnapshot, ...]
+    plants_appeared: Tuple[PlantSnapshot, ...]
+    plants_died: Tuple[PlantSnapshot, ...]
+    hp_changes: Tuple[HpChange, ...]
+    jumps: Tuple[PositionJump, ...]
+    
+    @property
+    def is_empty(self) -> bool:
+        """Check if no entity appeared, died, was hurt or jumped"""
+        return not (self.zombies_appeared or self.zombies_died or self.plants_appeared
+                    or self.plants_died or self.hp_changes or self.jumps)
+
+
+def diff(prev: StateSnapshot, cur: StateSnapshot) -> StateDiff:
+    """
+    Compare two snapshots of a game
+    
+    Entities are matched by array slot and type; a plant that is in
+    another cell is another plant. Records are unpacked to tuples and
+    only the entities that are reported become objects. Between close
+    snapshots the entities are mostly the same ones in the same slots,
+    so the records are paired in order, without matching them by key,
+    whenever both snapshots hold the same entities.
+    
+    Args:
+        prev: Earlier snapshot
+        cur: Later snapshot
+    
+    Returns:
+        StateDiff from prev to cur
+    """
+    elapsed = max(cur.game_clock - prev.game_clock, 0)
+    
+    # Zombie fields: 0 index, 1 type, 2 row, 3 x, 5 hp, 7 accessory_hp, 9 speed
+    zombies_appeared, zombies_died, kept = _match(
+        list(_ZOMBIE_RECORD.iter_unpack(prev.zombie_data)),
+        list(_ZOMBIE_RECORD.iter_unpack(cur.zombie_data)), 2, ZombieSnapshot)
+    hp_changes = [HpChange('zombie', z[0], z[1], o[5] + o[7], z[5] + z[7])
+                  for o, z in kept if o[5] + o[7] != z[5] + z[7]]
+    jumps = tuple(PositionJump(z[0], z[1], o[2], o[3], z[2], z[3]) for o, z in kept
+                  if o[2] != z[2] or abs(z[3] - o[3]) > abs(o[9]) * elapsed + JUMP_SLACK)
+    
+    # Plant fields: 0 index, 1 row, 2 col, 3 type, 4 hp
+    plants_appeared, plants_died, kept = _match(
+        list(_PLANT_RECORD.iter_unpack(prev.plant_data)),
+        list(_PLANT_RECORD.iter_unpack(cur.plant_data)), 4, PlantSnapshot)
+    hp_changes.extend(HpChange('plant', p[0], p[3], o[4], p[4]) for o, p in kept if o[4] != p[4])
+    
+    return StateDiff(cur.game_clock - prev.game_clock, cur.sun - prev.sun, zombies_appeared,
+                     zombies_died, plants_appeared, plants_died, tuple(hp_changes), jumps)
+
+
+def _match(old: list, new: list, key_fields: int, cls: type) -> tuple:
+    """
+    Match the unpacked records of two snapshots by their first key_fields fields
+    
+    Returns:
+        (appeared, died, kept): snapshots of the records only in new and
+        only in old, and the (old, new) pairs of records in both
+    """
+    old_keys = [record[:key_fields] for record in old]
+    new_keys = [record[:key_fields] for record in new]
+    if old_keys == new_keys:
+        return (), (), list(zip(old, new))
+    before = dict(zip(old_keys, old))
+    after = dict(zip(new_keys, new))
+    return (tuple(cls(*record) for key, record in after.items() if key not in before),
+            tuple(cls(*record) for key, record in before.items() if key not in after),
+            [(before[key], record) for key, record in after.items() if key in before])
@@ -4,7 +4,7 @@ Represents the complete state of a PVZ game at a point in time
 """
 
 from dataclasses import dataclass, field
-from typing import List, Optional
+from typing import Dict, List, Optional, Tuple
 
 from game.zombie import ZombieInfo
 from game.plant import PlantInfo
@@ -37,6 +37,92 @@ class SeedInfo:
         return max(0, min(100, 100 * (1 - self.recharge_countdown / self.recharge_time)))
 
 
+@dataclass
+class EntityDelta:
+    """Slots of one entity array that changed since the previous read"""
+    added: List[int] = field(default_factory=list)  # Slot indices now alive
+    removed: List[int] = field(default_factory=list)  # Slot indices no longer alive
+    changed: List[int] = field(default_factory=list)  # Live slots whose fields changed
+    
+    @property
+    def is_empty(self) -> bool:
+        """Check if nothing changed"""
+        return not (self.added or self.removed or self.changed)
+
+
+@dataclass
+class StateDelta:
+    """
+    What changed between two incremental state reads
+    
+    Entities are identified by their slot index in the game's arrays
+    (the index field of the info objects). Unchanged entities are the same
+    objects as in the previous state. A full delta (first read, or a new
+    board) lists every live entity as added.
+    """
+    zombies: EntityDelta = field(default_factory=EntityDelta)
+    plants: EntityDelta = field(default_factory=EntityDelta)
+    projectiles: EntityDelta = field(default_factory=EntityDelta)
+    lawnmowers: EntityDelta = field(default_factory=EntityDelta)
+    place_items: EntityDelta = field(default_factory=EntityDelta)
+    seeds: EntityDelta = field(default_factory=EntityDelta)
+    scalars_changed: bool = False  # Sun, wave, clocks, ...
+    full: bool = False
+    
+    @property
+    def is_empty(self) -> bool:
+        """Check if nothing changed"""
+        return (not self.full and not self.scalars_changed
+                and all(part.is_empty for part in (self.zombies, self.plants, self.projectiles,
+                                                   self.lawnmowers, self.place_items, self.seeds)))
+
+
+class StateIndex:
+    """
+    Alive zombies and plants of a GameState, bucketed for its queries
+    
+    Zombies of a row are sorted by x (the closest to the house first);
+    plants keep their array order. The lists are shared by every query
+    and must not be modified. Row threats and the plant grid (for states
+    without one) are built on first use.
+    """
+    
+    def __init__(self, zombies: List[ZombieInfo], plants: List[PlantInfo]):
+        from data.zombies import is_dangerous_zombie
+        self.alive_zombies = [z for z in zombies if z.hp > 0]
+        self.alive_plants = [p for p in plants if p.hp > 0]
+        self.zombies_by_row: Dict[int, List[ZombieInfo]] = {}
+        self.zombies_by_type: Dict[int, List[ZombieInfo]] = {}
+        for zombie in sorted(self.alive_zombies, key=lambda z: z.x):
+            self.zombies_by_row.setdefault(zombie.row, []).append(zombie)
+        for zombie in self.alive_zombies:
+            self.zombies_by_type.setdefault(zombie.type, []).append(zombie)
+        self.dangerous_zombies = [z for z in self.alive_zombies if is_dangerous_zombie(z.type)]
+        self.plants_by_row: Dict[int, List[PlantInfo]] = {}
+        self.plants_by_type: Dict[int, List[PlantInfo]] = {}
+        for plant in self.alive_plants:
+            self.plants_by_row.setdefault(plant.row, []).append(plant)
+            self.plants_by_type.setdefault(plant.type, []).append(plant)
+        self.ready_cobs = [p for p in self.alive_plants if p.is_cob_cannon and p.cob_ready]
+        self.row_threats: Dict[int, float] = {}
+        self._grid: Optional[Grid] = None
+    
+    @property
+    def grid(self) -> Grid:
+        """Grid of the alive plants, built on first use (the first plant of a cell wins)"""
+        if self._grid is None:
+            self._grid = Grid()
+            for plant in reversed(self.alive_plants):
+                self._grid.set(plant.row, plant.col, plant)
+        return self._grid
+
+
+_NO_ENTITIES: list = []  # Shared empty bucket
+
+# Entity lists of a GameState, tuples once it is frozen
+_ENTITY_FIELDS = ('zombies', 'plants', 'seeds', 'projectiles', 'lawnmowers', 'place_items')
+
+
 @dataclass
 class GameState:
     """
@@ -81,29 +167,88 @@ class GameState:
     # Grid representation (quick plant lookup)
     plant_grid: Optional[Grid] = None
     
+    # Changes since the previous state (incremental reads only)
+    delta: Optional[StateDelta] = None
+    
+    # Game cs since each entity section was read (scheduled reads only)
+    ages: Dict[str, int] = field(default_factory=dict)
+    
+    # Query index, built on the first query (see _indexed)
+    _index: Optional[StateIndex] = field(default=None, init=False, repr=False, compare=False)
+    _index_key: Optional[Tuple[int, int, int, int]] = field(default=None, init=False,
+                                                            repr=False, compare=False)
+    
+    # Board analysis shared by a decision's consumers (engine.analyzer.BoardAnalysis)
+    _analysis: Optional[object] = field(default=None, init=False, repr=False, compare=False)
+    _analysis_key: Optional[tuple] = field(default=None, init=False, repr=False, compare=False)
+    
+    # Set by freeze(): the fields can no longer be set
+    _frozen: bool = field(default=False, init=False, repr=False, compare=False)
+    
+    def __setattr__(self, name: str, value) -> None:
+        # The memoized index and analysis are caches, filled in on frozen states too
+        if self._frozen and not name.startswith('_'):
+            raise AttributeError(f"GameState is frozen: cannot set {name}")
+        object.__setattr__(self, name, value)
+    
+    def freeze(self) -> 'GameState':
+        """
+        Make the state read-only, to be shared between threads
+        
+        The entity lists become tuples and setting a field raises
+        AttributeError. The entity infos are not copied: an incremental
+        reader hands the unchanged ones on to its next states, so they must
+        not be modified either.
+        
+        Returns:
+            The state itself
+        """
+        for name in _ENTITY_FIELDS:
+            object.__setattr__(self, name, tuple(getattr(self, name)))
+        object.__setattr__(self, '_frozen', True)
+        return self
+    
+    @property
+    def _indexed(self) -> StateIndex:
+        """
+        The state's StateIndex
+        
+        Built once per state: a state is read whole and not changed after.
+        States assembled by hand (entities appended after construction, or
+        the lists replaced) are indexed again when a list's identity or
+        length changes.
+        """
+        key = (id(self.zombies), len(self.zombies), id(self.plants), len(self.plants))
+        if self._index is None or self._index_key != key:
+            self._index = StateIndex(self.zombies, self.plants)
+            self._index_key = key
+        return self._index
+    
     # ========================================================================
     # Utility Properties
     # ========================================================================
     
+    # Entity lists returned by the queries are the index's own: read only
+    
     @property
     def alive_zombies(self) -> List[ZombieInfo]:
         """Get all alive zombies"""
-        return [z for z in self.zombies if z.hp > 0]
+        return self._indexed.alive_zombies
     
     @property
     def alive_plants(self) -> List[PlantInfo]:
         """Get all alive plants"""
-        return [p for p in self.plants if p.hp > 0]
+        return self._indexed.alive_plants
     
     @property
     def zombie_count(self) -> int:
         """Get number of alive zombies"""
-        return len(self.alive_zombies)
+        return len(self._indexed.alive_zombies)
     
     @property
     def plant_count(self) -> int:
         """Get number of alive plants"""
-        return len(self.alive_plants)
+        return len(self._indexed.alive_plants)
     
     @property
     def is_final_wave(self) -> bool:
@@ -120,50 +265,48 @@ class GameState:
     # ========================================================================
     
     def get_zombies_in_row(self, row: int) -> List[ZombieInfo]:
-        """Get all zombies in a specific row"""
-        return [z for z in self.alive_zombies if z.row == row]
+        """Get all zombies in a specific row, closest to the house first"""
+        return self._indexed.zombies_by_row.get(row, _NO_ENTITIES)
     
     def get_closest_zombie_in_row(self, row: int) -> Optional[ZombieInfo]:
         """Get the closest zombie to the left in a row"""
-        row_zombies = self.get_zombies_in_row(row)
-        if not row_zombies:
-            return None
-        return min(row_zombies, key=lambda z: z.x)
+        row_zombies = self._indexed.zombies_by_row.get(row)
+        return row_zombies[0] if row_zombies else None
     
     def get_zombies_by_type(self, zombie_type: int) -> List[ZombieInfo]:
         """Get all zombies of a specific type"""
-        return [z for z in self.alive_zombies if z.type == zombie_type]
+        return self._indexed.zombies_by_type.get(zombie_type, _NO_ENTITIES)
     
     def get_dangerous_zombies(self) -> List[ZombieInfo]:
         """Get all zombies with high threat level"""
-        from data.zombies import is_dangerous_zombie
-        return [z for z in self.alive_zombies if is_dangerous_zombie(z.type)]
+        return self._indexed.dangerous_zombies
     
     # ========================================================================
     # Plant Queries
     # ========================================================================
     
+    @property
+    def grid(self) -> Grid:
+        """The plant grid: plant_grid when the state has one, else one of the alive plants"""
+        if self.plant_grid is not None:
+            return self.plant_grid
+        return self._indexed.grid
+    
     def get_plant_at(self, row: int, col: int) -> Optional[PlantInfo]:
         """Get plant at a specific grid position"""
-        if self.plant_grid:
-            return self.plant_grid.get(row, col)
-        # Fallback to linear search
-        for plant in self.alive_plants:
-            if plant.row == row and plant.col == col:
-                return plant
-        return None
+        return self.grid.get(row, col)
     
     def get_plants_in_row(self, row: int) -> List[PlantInfo]:
         """Get all plants in a specific row"""
-        return [p for p in self.alive_plants if p.row == row]
+        return self._indexed.plants_by_row.get(row, _NO_ENTITIES)
     
     def get_plants_by_type(self, plant_type: int) -> List[PlantInfo]:
         """Get all plants of a specific type"""
-        return [p for p in self.alive_plants if p.type == plant_type]
+        return self._indexed.plants_by_type.get(plant_type, _NO_ENTITIES)
     
     def is_cell_empty(self, row: int, col: int) -> bool:
         """Check if a grid cell is empty"""
-        return self.get_plant_at(row, col) is None
+        return self.grid.get(row, col) is None
     
     # ========================================================================
     # Seed Queries
@@ -195,7 +338,11 @@ class GameState:
     
     def get_row_threat(self, row: int) -> float:
         """Calculate total threat level for a row"""
-        return sum(z.threat_level for z in self.get_zombies_in_row(row))
+        threats = self._indexed.row_threats
+        threat = threats.get(row)
+        if threat is None:
+            threat = threats[row] = sum(z.threat_level for z in self.get_zombies_in_row(row))
+        return threat
     
     def get_most_threatened_row(self) -> int:
         """Get the row with highest threat"""
@@ -235,12 +382,12 @@ class GameState:
     # ========================================================================
     
     def get_ready_cobs(self) -> List[PlantInfo]:
-        """Get all cob cannons that are ready to fire"""
-        return [p for p in self.alive_plants if p.is_cob_cannon and p.cob_ready]
+        """Get all cob cannons that are ready to fire (a new list, for the caller to use up)"""
+        return list(self._indexed.ready_cobs)
     
     def can_fire_cob(self) -> bool:
         """Check if any cob cannon can be fired (ready and no click cooldown)"""
-        return self.click_pao_countdown <= 0 and len(self.get_ready_cobs()) > 0
+        return self.click_pao_countdown <= 0 and len(self._indexed.ready_cobs) > 0
     
     # ========================================================================
     # Lawnmower Queries
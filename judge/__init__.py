@@ -37,6 +37,8 @@ from judge.damage import (
     calculate_cherry_damage,
     calculate_gloom_dps,
     can_kill_zombie,
+    can_kill_zombie_batch,
+    calculate_overkill_batch,
 )
 from judge.prediction import (
     predict_position,
@@ -3,12 +3,12 @@ Damage Calculation Module
 Calculates damage values and determines kill conditions
 """
 
-from typing import Optional, List
+import math
+from typing import Optional, List, Sequence
+
+import numpy as np
+
 from data.constants import (
-    CHERRY_DAMAGE,
-    JALAPENO_DAMAGE,
-    DOOM_DAMAGE,
-    DOOM_DAMAGE_GARG,
     PEA_DAMAGE,
     FIRE_PEA_DAMAGE,
     MELON_DAMAGE,
@@ -17,9 +17,16 @@ from data.constants import (
 from data.zombies import (
     ZombieType,
     get_zombie_total_hp,
-    is_gargantuar,
-    GARGANTUAR_ZOMBIES,
 )
+from utils.damage import (
+    get_instant_damage_to_zombie,
+    get_instant_damage_batch,
+)
+
+
+# Damage sources judged here; their damage comes from the lookup tables of
+# utils.damage (Gargantuars take half)
+DAMAGE_SOURCES = ('cherry', 'cob', 'jalapeno', 'doom')
 
 
 # ============================================================================
@@ -38,9 +45,7 @@ def calculate_cherry_damage(zombie_type: int) -> int:
     Returns:
         Damage amount
     """
-    if is_gargantuar(zombie_type):
-        return CHERRY_DAMAGE // 2  # 900 to Gargs
-    return CHERRY_DAMAGE
+    return get_instant_damage_to_zombie('cherry', zombie_type)  # 900 to Gargs
 
 
 def calculate_jalapeno_damage(zombie_type: int) -> int:
@@ -55,9 +60,7 @@ def calculate_jalapeno_damage(zombie_type: int) -> int:
     Returns:
         Damage amount
     """
-    if is_gargantuar(zombie_type):
-        return JALAPENO_DAMAGE // 2
-    return JALAPENO_DAMAGE
+    return get_instant_damage_to_zombie('jalapeno', zombie_type)
 
 
 def calculate_doom_damage(zombie_type: int) -> int:
@@ -72,9 +75,7 @@ def calculate_doom_damage(zombie_type: int) -> int:
     Returns:
         Damage amount
     """
-    if is_gargantuar(zombie_type):
-        return DOOM_DAMAGE_GARG
-    return DOOM_DAMAGE
+    return get_instant_damage_to_zombie('doom', zombie_type)
 
 
 def calculate_cob_damage(zombie_type: int) -> int:
@@ -90,9 +91,7 @@ def calculate_cob_damage(zombie_type: int) -> int:
         Damage amount
     """
     # Cob cannon damage same as other instant kills
-    if is_gargantuar(zombie_type):
-        return 900
-    return 1800
+    return get_instant_damage_to_zombie('cob', zombie_type)
 
 
 # ============================================================================
@@ -169,18 +168,10 @@ def can_kill_zombie(zombie_hp: int, zombie_type: int,
     Returns:
         True if zombie would be killed
     """
-    damage_funcs = {
-        'cherry': calculate_cherry_damage,
-        'cob': calculate_cob_damage,
-        'jalapeno': calculate_jalapeno_damage,
-        'doom': calculate_doom_damage,
-    }
-    
-    damage_func = damage_funcs.get(damage_source)
-    if not damage_func:
+    if damage_source not in DAMAGE_SOURCES:
         return False
     
-    damage = damage_func(zombie_type)
+    damage = get_instant_damage_to_zombie(damage_source, zombie_type)
     return damage >= zombie_hp
 
 
@@ -199,7 +190,6 @@ def cobs_needed_to_kill(zombie_hp: int, zombie_type: int) -> int:
     if damage_per_cob <= 0:
         return float('inf')
     
-    import math
     return math.ceil(zombie_hp / damage_per_cob)
 
 
@@ -237,18 +227,10 @@ def calculate_overkill(zombie_hp: int, zombie_type: int,
     Returns:
         Overkill damage (negative if not killed)
     """
-    damage_funcs = {
-        'cherry': calculate_cherry_damage,
-        'cob': calculate_cob_damage,
-        'jalapeno': calculate_jalapeno_damage,
-        'doom': calculate_doom_damage,
-    }
-    
-    damage_func = damage_funcs.get(damage_source)
-    if not damage_func:
+    if damage_source not in DAMAGE_SOURCES:
         return 0
     
-    damage = damage_func(zombie_type)
+    damage = get_instant_damage_to_zombie(damage_source, zombie_type)
     return damage - zombie_hp
 
 
@@ -289,3 +271,45 @@ def calculate_cob_efficiency(zombies_hit: List[tuple]) -> float:
     # Efficiency is ratio of useful damage to total damage
     useful_damage = min(total_hp, total_damage)
     return useful_damage / 1800  # Normalize to single cob damage
+
+
+# ============================================================================
+# Batch Judgment (whole waves, one call)
+# ============================================================================
+
+def can_kill_zombie_batch(zombie_hps: Sequence[int], zombie_types: Sequence[int],
+                          damage_source: str) -> np.ndarray:
+    """
+    Check which of a list of zombies a damage source kills
+    
+    Args:
+        zombie_hps: Current HP of each zombie
+        zombie_types: Type ID of each zombie
+        damage_source: Type of damage ('cherry', 'cob', 'jalapeno', 'doom')
+        
+    Returns:
+        Boolean array, can_kill_zombie() of each zombie
+    """
+    hps = np.asarray(zombie_hps, dtype=np.int64)
+    if damage_source not in DAMAGE_SOURCES:
+        return np.zeros(len(hps), dtype=bool)
+    return get_instant_damage_batch(damage_source, zombie_types) >= hps
+
+
+def calculate_overkill_batch(zombie_hps: Sequence[int], zombie_types: Sequence[int],
+                             damage_source: str) -> np.ndarray:
+    """
+    Calculate the overkill of a damage source on each of a list of zombies
+    
+    Args:
+        zombie_hps: Current HP of each zombie
+        zombie_types: Type ID of each zombie
+        damage_source: Type of damage
+        
+    Returns:
+        Array of calculate_overkill() of each zombie
+    """
+    hps = np.asarray(zombie_hps, dtype=np.int64)
+    if damage_source not in DAMAGE_SOURCES:
+        return np.zeros(len(hps), dtype=np.int64)
+    return get_instant_damage_batch(damage_source, zombie_types) - hps
@@ -78,7 +78,7 @@ class EmergencyHandler:
             return None
         
         # Find most dangerous zombie
-        closest = min(row_zombies, key=lambda z: z.x)
+        closest = state.get_closest_zombie_in_row(row)
         
         # Check if emergency
         is_emergency = (
@@ -4,16 +4,17 @@ State Encoder
 Encodes GameState into YAML format for LLM consumption.
 """
 
-from typing import List, Dict, Any, Optional
+from typing import List, Dict, Any, Optional, Tuple
 from dataclasses import dataclass
 
 from game.state import GameState, SeedInfo
 from game.zombie import ZombieInfo
 from game.plant import PlantInfo
 from game.projectile import ProjectileInfo
-from data.plants import PlantType, PLANT_COST, ATTACKING_PLANTS
+from data.plants import PlantType, PLANT_COST
 from data.zombies import ZombieType, get_zombie_total_hp
 from data.offsets import SceneType
+from engine.analyzer import BoardAnalysis
 
 
 # Plant names mapping
@@ -126,6 +127,10 @@ class StateEncoder:
     
     def __init__(self):
         self.action_history: List[Dict[str, Any]] = []
+        # Encoded line per entity slot: index -> (entity, line). An incremental
+        # GameReader hands back the same object for an unchanged slot.
+        self._plant_lines: Dict[int, Tuple[Any, str]] = {}
+        self._zombie_lines: Dict[int, Tuple[Any, str]] = {}
     
     def encode(self, state: GameState) -> str:
         """
@@ -133,11 +138,12 @@ class StateEncoder:
         
         Args:
             state: Current game state
-            
+        
         Returns:
             YAML formatted string for LLM input
         """
         lines = []
+        self._sync_line_caches(state)
         
         # Global state
         lines.append("# ===== 全局状态 =====")
@@ -166,41 +172,14 @@ class StateEncoder:
         lines.append("# ===== 植物 =====")
         lines.append("P:")
         for plant in state.alive_plants:
-            name = PLANT_NAMES.get(plant.type, f"植物{plant.type}")
-            hp_str = f"{plant.hp}/{plant.hp_max}"
-            
-            plant_line = f"  - {{r: {plant.row}, c: {plant.col}, t: {plant.type}, hp: {hp_str}, atk_cd: {plant.shoot_countdown}"
-            
-            # Add cob cannon specific fields
-            if plant.type == PlantType.COBCANNON:
-                plant_line += f", cob_cd: {plant.cob_countdown}, cob_ready: {str(plant.cob_ready).lower()}"
-            
-            plant_line += "}"
-            
-            # Add warning for low HP defensive plants
-            if plant.hp_ratio < 0.4 and plant.is_defender:
-                plant_line += "  # ⚠️"
-            
-            lines.append(plant_line)
+            lines.append(self._cached_line(self._plant_lines, plant, self._plant_line))
         lines.append("")
         
         # Zombies
         lines.append("# ===== 僵尸 =====")
         lines.append("Z:")
         for zombie in state.alive_zombies:
-            name = ZOMBIE_NAMES.get(zombie.type, f"僵尸{zombie.type}")
-            hp_str = f"{zombie.total_hp}/{get_zombie_total_hp(zombie.type)}"
-            eta = int(zombie.time_to_reach(0)) if zombie.effective_speed > 0 else 9999
-            
-            zombie_line = (f"  - {{r: {zombie.row}, x: {int(zombie.x)}, t: {zombie.type}, "
-                          f"n: \"{name}\", hp: {hp_str}, spd: {zombie.effective_speed:.2f}, "
-                          f"slow: {zombie.slow_countdown}, freeze: {zombie.freeze_countdown}")
-            
-            if eta < 9999:
-                zombie_line += f", eta: {eta}"
-            
-            zombie_line += "}"
-            lines.append(zombie_line)
+            lines.append(self._cached_line(self._zombie_lines, zombie, self._zombie_line))
         lines.append("")
         
         # Projectiles
@@ -228,8 +207,8 @@ class StateEncoder:
         # Row analysis - scene-aware row count
         lines.append("# ===== 行分析 =====")
         lines.append("R:")
-        for row in range(row_count):
-            analysis = self._analyze_row(state, row)
+        analyses = [self._analyze_row(state, row) for row in range(row_count)]
+        for row, analysis in enumerate(analyses):
             warning = "  # ⚠️高威胁" if analysis.threat > 5.0 else ""
             lines.append(f"  - {{r: {row}, atk: {analysis.attacker_count}, "
                         f"def: {analysis.defender_count}, z_cnt: {analysis.zombie_count}, "
@@ -239,8 +218,7 @@ class StateEncoder:
         # DPS estimation
         lines.append("# ===== DPS估算 =====")
         lines.append("D:")
-        for row in range(row_count):
-            analysis = self._analyze_row(state, row)
+        for row, analysis in enumerate(analyses):
             warning = "  # ⚠️" if analysis.dps == 0 and analysis.incoming_hp > 0 else ""
             lines.append(f"  - {{r: {row}, dps: {analysis.dps:.1f}, incoming: {analysis.incoming_hp}}}{warning}")
         lines.append("")
@@ -264,37 +242,79 @@ class StateEncoder:
         
         return "\n".join(lines)
     
-    def _analyze_row(self, state: GameState, row: int) -> RowAnalysis:
-        """Analyze a single row"""
-        # Count attackers and defenders
-        row_plants = state.get_plants_in_row(row)
-        attacker_count = sum(1 for p in row_plants if p.type in ATTACKING_PLANTS)
-        defender_count = state.get_row_defense_count(row)
+    def _sync_line_caches(self, state: GameState) -> None:
+        """Drop cached lines of entities the state's delta removed"""
+        delta = state.delta
+        if delta is None or delta.full:
+            self._plant_lines.clear()
+            self._zombie_lines.clear()
+            return
+        for index in delta.plants.removed:
+            self._plant_lines.pop(index, None)
+        for index in delta.zombies.removed:
+            self._zombie_lines.pop(index, None)
+    
+    @staticmethod
+    def _cached_line(cache: Dict[int, Tuple[Any, str]], entity, build) -> str:
+        """The entity's line, encoded again only if it is a new object"""
+        cached = cache.get(entity.index)
+        if cached is not None and cached[0] is entity:
+            return cached[1]
+        line = build(entity)
+        cache[entity.index] = (entity, line)
+        return line
+    
+    @staticmethod
+    def _plant_line(plant: PlantInfo) -> str:
+        """Encode one plant"""
+        hp_str = f"{plant.hp}/{plant.hp_max}"
+        
+        plant_line = f"  - {{r: {plant.row}, c: {plant.col}, t: {plant.type}, hp: {hp_str}, atk_cd: {plant.shoot_countdown}"
         
-        # Get zombie info
-        row_zombies = state.get_zombies_in_row(row)
-        zombie_count = len(row_zombies)
-        closest = state.get_closest_zombie_in_row(row)
-        closest_x = closest.x if closest else 800.0
+        # Add cob cannon specific fields
+        if plant.type == PlantType.COBCANNON:
+            plant_line += f", cob_cd: {plant.cob_countdown}, cob_ready: {str(plant.cob_ready).lower()}"
         
-        # Calculate threat
-        threat = state.get_row_threat(row)
+        plant_line += "}"
         
-        # Calculate DPS
-        dps = sum(p.attack_value for p in row_plants)
+        # Add warning for low HP defensive plants
+        if plant.hp_ratio < 0.4 and plant.is_defender:
+            plant_line += "  # ⚠️"
         
-        # Calculate incoming HP
-        incoming_hp = sum(z.total_hp for z in row_zombies)
+        return plant_line
+    
+    @staticmethod
+    def _zombie_line(zombie: ZombieInfo) -> str:
+        """Encode one zombie"""
+        name = ZOMBIE_NAMES.get(zombie.type, f"僵尸{zombie.type}")
+        hp_str = f"{zombie.total_hp}/{get_zombie_total_hp(zombie.type)}"
+        eta = int(zombie.time_to_reach(0)) if zombie.effective_speed > 0 else 9999
+        
+        zombie_line = (f"  - {{r: {zombie.row}, x: {int(zombie.x)}, t: {zombie.type}, "
+                      f"n: \"{name}\", hp: {hp_str}, spd: {zombie.effective_speed:.2f}, "
+                      f"slow: {zombie.slow_countdown}, freeze: {zombie.freeze_countdown}")
+        
+        if eta < 9999:
+            zombie_line += f", eta: {eta}"
+        
+        zombie_line += "}"
+        return zombie_line
+    
+    def _analyze_row(self, state: GameState, row: int) -> RowAnalysis:
+        """Analyze a single row (from the state's shared BoardAnalysis)"""
+        board = BoardAnalysis.of(state)
+        threat = board.threat.row_threats[row]
+        defense = board.defenses[row]
         
         return RowAnalysis(
             row=row,
-            attacker_count=attacker_count,
-            defender_count=defender_count,
-            zombie_count=zombie_count,
-            closest_zombie_x=closest_x,
-            threat=threat,
-            dps=dps,
-            incoming_hp=incoming_hp
+            attacker_count=defense.attacker_count,
+            defender_count=defense.defender_count,
+            zombie_count=threat.zombie_count,
+            closest_zombie_x=threat.closest_zombie_x if threat.zombie_count else 800.0,
+            threat=threat.total_threat,
+            dps=defense.dps,
+            incoming_hp=threat.incoming_hp
         )
     
     def _detect_emergencies(self, state: GameState) -> List[Dict[str, Any]]:
@@ -331,7 +351,7 @@ class StateEncoder:
                     })
             
             # Check for no attacker in row with zombies
-            if row_zombies and state.get_row_attacker_count(row) == 0:
+            if row_zombies and BoardAnalysis.of(state).defenses[row].attacker_count == 0:
                 emergencies.append({
                     "type": "no_attacker",
                     "r": row
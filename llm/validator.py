@@ -236,10 +236,9 @@ class ActionValidator:
     def _find_nearby_cell(self, state: GameState, row: int, col: int) -> Optional[Tuple[int, int]]:
         """Find nearby empty cell (for position adjustment)"""
         # Check same row first
-        for offset in [1, -1, 2, -2]:
-            new_col = col + offset
-            if 0 <= new_col <= 8 and state.is_cell_empty(row, new_col):
-                return (row, new_col)
+        new_col = state.grid.first_empty_in_row(row, (col + 1, col - 1, col + 2, col - 2))
+        if new_col is not None:
+            return (row, new_col)
         
         return None
     
@@ -7,13 +7,14 @@ Entry script for running the LLM-based PVZ player.
 Usage:
     python llm_main.py --api-key sk-xxx
     python llm_main.py --api-key sk-xxx --debug
+    python llm_main.py --api-key sk-xxx --headless [--waves N] [--speed X]
 """
 
 import sys
 import time
 import asyncio
 import argparse
-from typing import Optional
+from typing import List, Optional
 
 # Import memory interface modules
 from config import BotConfig
@@ -25,16 +26,21 @@ from data.zombies import ZombieType
 from data.offsets import Offset
 
 # Import memory modules
-from memory.process import ProcessAttacher
+from memory.process import create_attacher
+from memory.backend import MemoryBackend
+from memory.recording import RecordingBackend
 from memory.reader import MemoryReader
 from memory.writer import MemoryWriter
 from memory.injector import AsmInjector
 
 # Import game state modules
-from game.state import GameState, SeedInfo
-from game.zombie import ZombieInfo
-from game.plant import PlantInfo
-from game.grid import Grid
+from game.state import GameState
+from game.reader import GameReader
+from game.schedule import ReadSchedule
+from game.poller import StatePoller, LatencyHistogram
+
+# Import engine modules
+from engine.headless import HeadlessInterface, create_level_waves
 
 # Import engine modules
 from engine.action import Action, ActionType
@@ -49,31 +55,68 @@ class PVZMemoryInterface:
     Unified memory interface for PVZ (same as main.py)
     """
     
-    def __init__(self):
-        self.attacher = ProcessAttacher()
+    def __init__(self, backend: Optional[MemoryBackend] = None, record: Optional[str] = None):
+        """
+        Initialize the interface
+        
+        Args:
+            backend: Memory to use instead of attaching to the game
+                (e.g. an ImageBackend loaded from a dump, a ReplayBackend)
+            record: Session log to record every memory read to
+        """
+        self.backend = backend
+        self.record = record
+        self.attacher = None if backend is not None else create_attacher()
         self.reader: Optional[MemoryReader] = None
+        self.game_reader: Optional[GameReader] = None
         self.writer: Optional[MemoryWriter] = None
         self.injector: Optional[AsmInjector] = None
         self.logger = get_logger()
     
-    def attach(self) -> bool:
-        """Attach to PVZ process"""
-        if not self.attacher.attach():
-            return False
-        
-        kernel32 = self.attacher.kernel32
-        handle = self.attacher.handle
-        
-        self.reader = MemoryReader(kernel32, handle)
-        self.writer = MemoryWriter(kernel32, handle)
-        self.injector = AsmInjector(kernel32, handle, self.reader)
+    def attach(self, command_loop: bool = True) -> bool:
+        """
+        Attach to PVZ process (or use the given backend)
+        
+        Args:
+            command_loop: Inject the thread that runs actions; read-only uses
+                leave the game process untouched
+        """
+        if self.attacher is not None:
+            if not self.attacher.attach():
+                return False
+            try:
+                self.backend = self.attacher.create_backend()
+            except OSError as e:
+                self.logger.error(f"Cannot open PVZ process memory: {e}")
+                return False
+        game = self.backend
+        if self.record:
+            self.backend = RecordingBackend(self.backend, self.record)
+        
+        # Initialize components
+        self.reader = MemoryReader(backend=self.backend)
+        self.game_reader = GameReader(self.reader, incremental=True, schedule=ReadSchedule())
+        self.writer = MemoryWriter(backend=self.backend)
+        # Actions and the command loop's polling are not part of a recording
+        self.injector = AsmInjector(reader=self.reader, backend=game)
+        
+        # One injected thread runs every action; without it each gets its own
+        if command_loop and self.injector.start_command_loop():
+            self.logger.debug("Injected the command loop")
         
         return True
     
     def is_attached(self) -> bool:
         """Check if attached to process"""
+        if self.attacher is None:
+            return self.backend is not None
         return self.attacher.is_attached()
     
+    @property
+    def finished(self) -> bool:
+        """Whether the backend has no more game to read (a replay played out)"""
+        return self.backend is not None and self.backend.finished
+    
     def is_in_game(self) -> bool:
         """Check if in game"""
         if not self.reader:
@@ -81,136 +124,29 @@ class PVZMemoryInterface:
         return self.reader.is_in_game()
     
     def get_game_state(self) -> Optional[GameState]:
-        """Read complete game state"""
-        if not self.reader or not self.reader.is_in_game():
-            return None
-        
-        board = self.reader.get_board()
-        if board == 0:
+        """Read complete game state (starts a refresh of the pointer cache)"""
+        if not self.reader:
             return None
         
-        # Read basic info
-        sun = self.reader.get_sun()
-        wave = self.reader.get_wave()
-        total_waves = self.reader.get_total_waves()
-        game_clock = self.reader.get_game_clock()
-        scene = self.reader.get_scene()
-        refresh_cd = self.reader.read_int(board + Offset.REFRESH_COUNTDOWN)
-        huge_wave_cd = self.reader.read_int(board + Offset.HUGE_WAVE_COUNTDOWN)
-        
-        # Read zombies
-        zombies = self._read_zombies(board)
-        
-        # Read plants and build grid
-        plants, plant_grid = self._read_plants(board)
+        state = None
+        if self.reader.refresh() and self.reader.get_board() != 0:
+            state = self.game_reader.read_game_state()
         
-        # Read seeds
-        seeds = self._read_seeds(board)
-        
-        # Read click_pao_countdown for cob cannon fire validation
-        click_pao_cd = self.reader.read_int(board + Offset.CLICK_PAO_COUNTDOWN)
-        
-        return GameState(
-            sun=sun,
-            wave=wave,
-            total_waves=total_waves,
-            game_clock=game_clock,
-            scene=scene,
-            refresh_countdown=refresh_cd,
-            huge_wave_countdown=huge_wave_cd,
-            click_pao_countdown=click_pao_cd,
-            zombies=zombies,
-            plants=plants,
-            seeds=seeds,
-            plant_grid=plant_grid,
-        )
+        # One poll per state read, for recording and replay
+        self.backend.mark_poll(state.game_clock if state else -1)
+        return state
     
-    def _read_zombies(self, board: int) -> list:
-        """Read all zombies from memory"""
-        zombies = []
-        zombie_array = self.reader.read_int(board + Offset.ZOMBIE_ARRAY)
-        zombie_max = self.reader.read_int(board + Offset.ZOMBIE_COUNT_MAX)
-        
-        for i in range(min(zombie_max, 200)):
-            addr = zombie_array + i * Offset.ZOMBIE_SIZE
-            
-            if self.reader.read_byte(addr + Offset.Z_DEAD):
-                continue
-            
-            zombies.append(ZombieInfo(
-                index=i,
-                row=self.reader.read_int(addr + Offset.Z_ROW),
-                x=self.reader.read_float(addr + Offset.Z_X),
-                y=self.reader.read_float(addr + Offset.Z_Y),
-                type=self.reader.read_int(addr + Offset.Z_TYPE),
-                hp=self.reader.read_int(addr + Offset.Z_HP),
-                hp_max=self.reader.read_int(addr + Offset.Z_HP_MAX),
-                accessory_hp=self.reader.read_int(addr + Offset.Z_ACCESSORY_HP_1),
-                state=self.reader.read_int(addr + Offset.Z_STATE),
-                speed=self.reader.read_float(addr + Offset.Z_SPEED),
-                slow_countdown=self.reader.read_int(addr + Offset.Z_SLOW_COUNTDOWN),
-                freeze_countdown=self.reader.read_int(addr + Offset.Z_FREEZE_COUNTDOWN),
-                butter_countdown=self.reader.read_int(addr + Offset.Z_BUTTER_COUNTDOWN),
-                at_wave=self.reader.read_int(addr + Offset.Z_AT_WAVE),
-            ))
-        
-        return zombies
+    def require_fresh(self, *sections: str) -> None:
+        """Have the next state read re-read these sections (all when none given)"""
+        if self.game_reader is not None and self.game_reader.schedule is not None:
+            self.game_reader.schedule.require_fresh(*sections)
     
-    def _read_plants(self, board: int) -> tuple:
-        """Read all plants and build grid"""
-        plants = []
-        grid = Grid()
-        
-        plant_array = self.reader.read_int(board + Offset.PLANT_ARRAY)
-        plant_max = self.reader.read_int(board + Offset.PLANT_COUNT_MAX)
-        
-        for i in range(min(plant_max, 200)):
-            addr = plant_array + i * Offset.PLANT_SIZE
-            
-            if self.reader.read_byte(addr + Offset.P_DEAD):
-                continue
-            
-            row = self.reader.read_int(addr + Offset.P_ROW)
-            col = self.reader.read_int(addr + Offset.P_COL)
-            plant_type = self.reader.read_int(addr + Offset.P_TYPE)
-            
-            plant = PlantInfo(
-                index=i,
-                row=row,
-                col=col,
-                type=plant_type,
-                hp=self.reader.read_int(addr + Offset.P_HP),
-                hp_max=self.reader.read_int(addr + Offset.P_HP_MAX),
-                state=self.reader.read_int(addr + Offset.P_STATE),
-                shoot_countdown=self.reader.read_int(addr + Offset.P_SHOOT_COUNTDOWN),
-                effective=self.reader.read_int(addr + Offset.P_EFFECTIVE) != 0,
-                pumpkin_hp=self.reader.read_int(addr + Offset.P_PUMPKIN_HP),
-                cob_countdown=self.reader.read_int(addr + Offset.P_COB_COUNTDOWN) if plant_type == PlantType.COBCANNON else 0,
-                cob_ready=self.reader.read_bool(addr + Offset.P_COB_READY) if plant_type == PlantType.COBCANNON else False,
-            )
-            
-            plants.append(plant)
-            grid.set(row, col, plant)
-        
-        return plants, grid
-    
-    def _read_seeds(self, board: int) -> list:
-        """Read seed cards"""
-        seeds = []
-        seed_array = self.reader.read_int(board + Offset.SEED_ARRAY)
-        
-        for i in range(10):
-            addr = seed_array + i * Offset.SEED_SIZE
-            seeds.append(SeedInfo(
-                index=i,
-                type=self.reader.read_int(addr + Offset.S_TYPE),
-                recharge_countdown=self.reader.read_int(addr + Offset.S_RECHARGE_COUNTDOWN),
-                recharge_time=self.reader.read_int(addr + Offset.S_RECHARGE_TIME),
-                usable=self.reader.read_byte(addr + Offset.S_USABLE) != 0,
-                imitator_type=self.reader.read_int(addr + Offset.S_IMITATOR_TYPE),
-            ))
-        
-        return seeds
+    def close(self):
+        """Stop the command loop and release the memory backend (finishes a recording)"""
+        if self.injector is not None:
+            self.injector.stop_command_loop()
+        if self.backend is not None:
+            self.backend.close()
     
     def plant(self, row: int, col: int, plant_type: int) -> bool:
         """Plant at position"""
@@ -224,6 +160,38 @@ class PVZMemoryInterface:
             return False
         return self.injector.shovel(row, col)
     
+    def execute_batch(self, actions: List[Action],
+                      state: Optional[GameState] = None) -> List[bool]:
+        """
+        Execute several actions with one injection (e.g. two cobs and a jalapeno)
+        
+        Args:
+            actions: Plant, shovel and cob actions, run in order
+            state: State the actions were chosen on; each cob action
+                fires one of its ready cannons
+        
+        Returns:
+            Whether each action was executed
+        """
+        if not self.injector:
+            return [False] * len(actions)
+        
+        cobs = state.get_ready_cobs() if state is not None else []
+        commands = []
+        for action in actions:
+            if action.is_plant_action:
+                commands.append(self.injector.plant_command(action.row, action.col,
+                                                            action.plant_type))
+            elif action.action_type == ActionType.SHOVEL:
+                commands.append(self.injector.shovel_command(action.row, action.col))
+            elif action.action_type == ActionType.USE_COB and cobs:
+                cob = cobs.pop(0)
+                commands.append(self.injector.fire_cob_command(cob.index, action.target_x,
+                                                               action.target_y))
+            else:
+                commands.append(None)
+        return self.injector.execute_batch(commands)
+    
     def collect_all_items(self) -> int:
         """Collect all items (sun, coins)"""
         if not self.reader or not self.writer:
@@ -234,7 +202,7 @@ class PVZMemoryInterface:
             return 0
         
         count = 0
-        item_array = self.reader.read_int(board + Offset.ITEM_ARRAY)
+        item_array = self.reader.get_board_pointer(Offset.ITEM_ARRAY, board)
         item_max = self.reader.read_int(board + Offset.ITEM_COUNT_MAX)
         
         for i in range(min(item_max, 100)):
@@ -253,7 +221,7 @@ class PVZMemoryInterface:
     @property
     def pid(self) -> Optional[int]:
         """Get process ID"""
-        return self.attacher.pid
+        return self.attacher.pid if self.attacher else None
 
 
 class LLMBot:
@@ -261,12 +229,19 @@ class LLMBot:
     LLM-based bot using async architecture.
     """
     
-    def __init__(self, api_key: str, config: Optional[BotConfig] = None):
+    def __init__(self, api_key: str, config: Optional[BotConfig] = None, memory=None):
         self.api_key = api_key
         self.config = config or BotConfig()
-        self.memory = PVZMemoryInterface()
+        # Any object with PVZMemoryInterface's methods (e.g. a HeadlessInterface)
+        self.memory = memory or PVZMemoryInterface()
         self.logger = get_logger()
         
+        # States are read on a background thread; the player takes the latest
+        self.poller = StatePoller(self._poll, self.config.refresh_rate,
+                                  self.config.lockstep_polling)
+        self._published = None  # Last state handed to the player
+        self.latency = LatencyHistogram()  # State read to action executed
+        
         # Initialize LLM config
         llm_config = LLMConfig()
         llm_config.api_key = api_key
@@ -286,11 +261,19 @@ class LLMBot:
         
         self.running = False
     
+    def _poll(self) -> Optional[GameState]:
+        """Read one state and collect items (poller thread)"""
+        state = self.memory.get_game_state()
+        if state is not None and self.config.auto_collect_sun:
+            self.memory.collect_all_items()
+        return state
+    
     def _read_state(self) -> Optional[GameState]:
-        """Read game state callback"""
-        if not self.memory.is_in_game():
-            return None
-        return self.memory.get_game_state()
+        """Read game state callback: the poller's latest state, never waits"""
+        # The player asks for a state once it is done with the one before
+        self.poller.done()
+        self._published = self.poller.latest()
+        return self._published.state if self._published else None
     
     def _execute_action(self, action: Action) -> bool:
         """Execute action callback"""
@@ -298,17 +281,26 @@ class LLMBot:
             return True
         
         if action.is_plant_action:
-            return self.memory.plant(action.row, action.col, action.plant_type)
+            success = self.memory.plant(action.row, action.col, action.plant_type)
+            self._record_latency()
+            return success
         elif action.action_type == ActionType.SHOVEL:
-            return self.memory.shovel(action.row, action.col)
+            success = self.memory.shovel(action.row, action.col)
+            self._record_latency()
+            return success
         elif action.action_type == ActionType.USE_COB:
-            # Cob cannon requires special handling via injector
-            # For now, we'd need to implement cob firing in the injector
-            self.logger.warning(f"Cob cannon firing not yet implemented")
-            return False
+            state = self._published.state if self._published else None
+            success = self.memory.execute_batch([action], state)[0]
+            self._record_latency()
+            return success
         
         return False
     
+    def _record_latency(self) -> None:
+        """Record how old the player's state was when an action was done"""
+        if self._published is not None:
+            self.latency.record(time.perf_counter() - self._published.read_time)
+    
     def _on_action(self, action: Action, success: bool) -> None:
         """Action callback"""
         if success:
@@ -344,6 +336,7 @@ class LLMBot:
         print("-" * 60)
         
         self.running = True
+        self.poller.start()
         
         # Run async event loop
         try:
@@ -352,6 +345,11 @@ class LLMBot:
             print("\n")
             self.logger.info("Bot stopped by user")
             self.running = False
+        finally:
+            self.poller.stop()
+            self.memory.close()
+            if self.latency.count:
+                self.logger.info(f"Read-to-act latency: {self.latency.summary()}")
     
     async def _run_async(self) -> None:
         """Run async main loop"""
@@ -364,10 +362,12 @@ class LLMBot:
                 if not self.memory.is_attached():
                     self.logger.error("Lost connection to PVZ")
                     break
-                
-                # Auto-collect items
-                if self.config.auto_collect_sun:
-                    self.memory.collect_all_items()
+                if self.memory.finished:
+                    self.logger.info("Game session finished")
+                    break
+                if self.poller.error is not None:
+                    self.logger.error(f"State reading failed: {self.poller.error}")
+                    break
                 
                 # Display status
                 state = self.player.state.game_state
@@ -378,7 +378,7 @@ class LLMBot:
                     status_line("[Waiting] Not in game...")
                 
                 await asyncio.sleep(0.1)
-                
+        
         except asyncio.CancelledError:
             pass
         finally:
@@ -409,6 +409,11 @@ def main():
     parser.add_argument("--api-key", required=True, help="DeepSeek API key")
     parser.add_argument("--debug", action="store_true", help="Enable debug mode")
     parser.add_argument("--no-collect", action="store_true", help="Disable auto-collecting")
+    parser.add_argument("--headless", action="store_true",
+                        help="Play a simulated level instead of the game")
+    parser.add_argument("--waves", type=int, default=20, help="Waves of the headless level")
+    parser.add_argument("--speed", type=float, default=1.0, metavar="X",
+                        help="Headless game speed (0: as fast as the bot polls)")
     args = parser.parse_args()
     
     # Create config
@@ -420,8 +425,17 @@ def main():
         config.auto_collect_sun = False
     
     # Start bot
-    bot = LLMBot(api_key=args.api_key, config=config)
+    memory = None
+    if args.headless:
+        memory = HeadlessInterface(create_level_waves(args.waves), speed=args.speed)
+        if args.speed == 0:
+            config.refresh_rate = 0.0  # Each poll advances the game
+            config.lockstep_polling = True
+    bot = LLMBot(api_key=args.api_key, config=config, memory=memory)
     bot.start()
+    if memory is not None:
+        get_logger().info(f"Headless level {'won' if memory.won else 'lost'} at wave "
+                          f"{memory.sim.wave}, game clock {memory.sim.frame}")
 
 
 if __name__ == "__main__":
@@ -7,6 +7,8 @@ Provides an extensible framework for optimal PVZ gameplay automation.
 
 Usage:
     python main.py [--debug] [--no-plant] [--no-collect]
+                   [--dump PATH | --image PATH | --record PATH | --replay PATH [--replay-speed X]
+                    | --headless [--waves N] [--speed X]]
 
 Features:
     - Modular architecture based on AVZ data
@@ -19,7 +21,7 @@ Features:
 import sys
 import time
 import argparse
-from typing import Optional
+from typing import List, Optional
 
 # Import modules
 from config import BotConfig, load_config
@@ -31,22 +33,26 @@ from data.zombies import ZombieType
 from data.offsets import Offset
 
 # Import memory modules
-from memory.process import ProcessAttacher
+from memory.process import create_attacher
+from memory.backend import MemoryBackend, ImageBackend
+from memory.recording import RecordingBackend, ReplayBackend
 from memory.reader import MemoryReader
 from memory.writer import MemoryWriter
 from memory.injector import AsmInjector
 
 # Import game state modules
-from game.state import GameState, SeedInfo
-from game.zombie import ZombieInfo
-from game.plant import PlantInfo
-from game.grid import Grid
+from game.state import GameState
+from game.reader import GameReader
+from game.schedule import ReadSchedule
+from game.poller import StatePoller, PublishedState, LatencyHistogram
 
 # Import engine modules
 from engine.action import Action, ActionType
 from engine.analyzer import ThreatAnalyzer, ResourceAnalyzer
 from engine.strategy import StrategyPlanner
-from engine.optimizer import ActionOptimizer
+from engine.optimizer import ActionOptimizer, MCTSOptimizer
+from engine.parallel_search import ParallelMCTSOptimizer
+from engine.headless import HeadlessInterface, create_level_waves
 
 
 class PVZMemoryInterface:
@@ -56,32 +62,68 @@ class PVZMemoryInterface:
     Combines process attachment, reading, writing, and ASM injection.
     """
     
-    def __init__(self):
-        self.attacher = ProcessAttacher()
+    def __init__(self, backend: Optional[MemoryBackend] = None, record: Optional[str] = None):
+        """
+        Initialize the interface
+        
+        Args:
+            backend: Memory to use instead of attaching to the game
+                (e.g. an ImageBackend loaded from a dump, a ReplayBackend)
+            record: Session log to record every memory read to
+        """
+        self.backend = backend
+        self.record = record
+        self.attacher = None if backend is not None else create_attacher()
         self.reader: Optional[MemoryReader] = None
+        self.game_reader: Optional[GameReader] = None
         self.writer: Optional[MemoryWriter] = None
         self.injector: Optional[AsmInjector] = None
         self.logger = get_logger()
     
-    def attach(self) -> bool:
-        """Attach to PVZ process"""
-        if not self.attacher.attach():
-            return False
+    def attach(self, command_loop: bool = True) -> bool:
+        """
+        Attach to PVZ process (or use the given backend)
+        
+        Args:
+            command_loop: Inject the thread that runs actions; read-only uses
+                leave the game process untouched
+        """
+        if self.attacher is not None:
+            if not self.attacher.attach():
+                return False
+            try:
+                self.backend = self.attacher.create_backend()
+            except OSError as e:
+                self.logger.error(f"Cannot open PVZ process memory: {e}")
+                return False
+        game = self.backend
+        if self.record:
+            self.backend = RecordingBackend(self.backend, self.record)
         
         # Initialize components
-        kernel32 = self.attacher.kernel32
-        handle = self.attacher.handle
+        self.reader = MemoryReader(backend=self.backend)
+        self.game_reader = GameReader(self.reader, incremental=True, schedule=ReadSchedule())
+        self.writer = MemoryWriter(backend=self.backend)
+        # Actions and the command loop's polling are not part of a recording
+        self.injector = AsmInjector(reader=self.reader, backend=game)
         
-        self.reader = MemoryReader(kernel32, handle)
-        self.writer = MemoryWriter(kernel32, handle)
-        self.injector = AsmInjector(kernel32, handle, self.reader)
+        # One injected thread runs every action; without it each gets its own
+        if command_loop and self.injector.start_command_loop():
+            self.logger.debug("Injected the command loop")
         
         return True
     
     def is_attached(self) -> bool:
         """Check if attached to process"""
+        if self.attacher is None:
+            return self.backend is not None
         return self.attacher.is_attached()
     
+    @property
+    def finished(self) -> bool:
+        """Whether the backend has no more game to read (a replay played out)"""
+        return self.backend is not None and self.backend.finished
+    
     def is_in_game(self) -> bool:
         """Check if in game"""
         if not self.reader:
@@ -89,132 +131,29 @@ class PVZMemoryInterface:
         return self.reader.is_in_game()
     
     def get_game_state(self) -> Optional[GameState]:
-        """Read complete game state"""
-        if not self.reader or not self.reader.is_in_game():
-            return None
-        
-        board = self.reader.get_board()
-        if board == 0:
+        """Read complete game state (starts a refresh of the pointer cache)"""
+        if not self.reader:
             return None
         
-        # Read basic info
-        sun = self.reader.get_sun()
-        wave = self.reader.get_wave()
-        total_waves = self.reader.get_total_waves()
-        game_clock = self.reader.get_game_clock()
-        scene = self.reader.get_scene()
-        refresh_cd = self.reader.read_int(board + Offset.REFRESH_COUNTDOWN)
-        huge_wave_cd = self.reader.read_int(board + Offset.HUGE_WAVE_COUNTDOWN)
-        
-        # Read zombies
-        zombies = self._read_zombies(board)
-        
-        # Read plants and build grid
-        plants, plant_grid = self._read_plants(board)
+        state = None
+        if self.reader.refresh() and self.reader.get_board() != 0:
+            state = self.game_reader.read_game_state()
         
-        # Read seeds
-        seeds = self._read_seeds(board)
-        
-        return GameState(
-            sun=sun,
-            wave=wave,
-            total_waves=total_waves,
-            game_clock=game_clock,
-            scene=scene,
-            refresh_countdown=refresh_cd,
-            huge_wave_countdown=huge_wave_cd,
-            zombies=zombies,
-            plants=plants,
-            seeds=seeds,
-            plant_grid=plant_grid,
-        )
+        # One poll per state read, for recording and replay
+        self.backend.mark_poll(state.game_clock if state else -1)
+        return state
     
-    def _read_zombies(self, board: int) -> list:
-        """Read all zombies from memory"""
-        zombies = []
-        zombie_array = self.reader.read_int(board + Offset.ZOMBIE_ARRAY)
-        zombie_max = self.reader.read_int(board + Offset.ZOMBIE_COUNT_MAX)
-        
-        for i in range(min(zombie_max, 200)):
-            addr = zombie_array + i * Offset.ZOMBIE_SIZE
-            
-            if self.reader.read_byte(addr + Offset.Z_DEAD):
-                continue
-            
-            zombies.append(ZombieInfo(
-                index=i,
-                row=self.reader.read_int(addr + Offset.Z_ROW),
-                x=self.reader.read_float(addr + Offset.Z_X),
-                y=self.reader.read_float(addr + Offset.Z_Y),
-                type=self.reader.read_int(addr + Offset.Z_TYPE),
-                hp=self.reader.read_int(addr + Offset.Z_HP),
-                hp_max=self.reader.read_int(addr + Offset.Z_HP_MAX),
-                accessory_hp=self.reader.read_int(addr + Offset.Z_ACCESSORY_HP_1),
-                state=self.reader.read_int(addr + Offset.Z_STATE),
-                speed=self.reader.read_float(addr + Offset.Z_SPEED),
-                slow_countdown=self.reader.read_int(addr + Offset.Z_SLOW_COUNTDOWN),
-                freeze_countdown=self.reader.read_int(addr + Offset.Z_FREEZE_COUNTDOWN),
-                butter_countdown=self.reader.read_int(addr + Offset.Z_BUTTER_COUNTDOWN),
-                at_wave=self.reader.read_int(addr + Offset.Z_AT_WAVE),
-            ))
-        
-        return zombies
+    def require_fresh(self, *sections: str) -> None:
+        """Have the next state read re-read these sections (all when none given)"""
+        if self.game_reader is not None and self.game_reader.schedule is not None:
+            self.game_reader.schedule.require_fresh(*sections)
     
-    def _read_plants(self, board: int) -> tuple:
-        """Read all plants and build grid"""
-        plants = []
-        grid = Grid()
-        
-        plant_array = self.reader.read_int(board + Offset.PLANT_ARRAY)
-        plant_max = self.reader.read_int(board + Offset.PLANT_COUNT_MAX)
-        
-        for i in range(min(plant_max, 200)):
-            addr = plant_array + i * Offset.PLANT_SIZE
-            
-            if self.reader.read_byte(addr + Offset.P_DEAD):
-                continue
-            
-            row = self.reader.read_int(addr + Offset.P_ROW)
-            col = self.reader.read_int(addr + Offset.P_COL)
-            plant_type = self.reader.read_int(addr + Offset.P_TYPE)
-            
-            plant = PlantInfo(
-                index=i,
-                row=row,
-                col=col,
-                type=plant_type,
-                hp=self.reader.read_int(addr + Offset.P_HP),
-                hp_max=self.reader.read_int(addr + Offset.P_HP_MAX),
-                state=self.reader.read_int(addr + Offset.P_STATE),
-                shoot_countdown=self.reader.read_int(addr + Offset.P_SHOOT_COUNTDOWN),
-                effective=self.reader.read_int(addr + Offset.P_EFFECTIVE) != 0,
-                pumpkin_hp=self.reader.read_int(addr + Offset.P_PUMPKIN_HP),
-                cob_countdown=self.reader.read_int(addr + Offset.P_COB_COUNTDOWN) if plant_type == PlantType.COBCANNON else 0,
-                cob_ready=self.reader.read_bool(addr + Offset.P_COB_READY) if plant_type == PlantType.COBCANNON else False,
-            )
-            
-            plants.append(plant)
-            grid.set(row, col, plant)
-        
-        return plants, grid
-    
-    def _read_seeds(self, board: int) -> list:
-        """Read seed cards"""
-        seeds = []
-        seed_array = self.reader.read_int(board + Offset.SEED_ARRAY)
-        
-        for i in range(10):  # 10 card slots
-            addr = seed_array + i * Offset.SEED_SIZE
-            seeds.append(SeedInfo(
-                index=i,
-                type=self.reader.read_int(addr + Offset.S_TYPE),
-                recharge_countdown=self.reader.read_int(addr + Offset.S_RECHARGE_COUNTDOWN),
-                recharge_time=self.reader.read_int(addr + Offset.S_RECHARGE_TIME),
-                usable=self.reader.read_byte(addr + Offset.S_USABLE) != 0,
-                imitator_type=self.reader.read_int(addr + Offset.S_IMITATOR_TYPE),
-            ))
-        
-        return seeds
+    def close(self):
+        """Stop the command loop and release the memory backend (finishes a recording)"""
+        if self.injector is not None:
+            self.injector.stop_command_loop()
+        if self.backend is not None:
+            self.backend.close()
     
     def plant(self, row: int, col: int, plant_type: int) -> bool:
         """Plant at position"""
@@ -228,6 +167,38 @@ class PVZMemoryInterface:
             return False
         return self.injector.shovel(row, col)
     
+    def execute_batch(self, actions: List[Action],
+                      state: Optional[GameState] = None) -> List[bool]:
+        """
+        Execute several actions with one injection (e.g. two cobs and a jalapeno)
+        
+        Args:
+            actions: Plant, shovel and cob actions, run in order
+            state: State the actions were chosen on; each cob action
+                fires one of its ready cannons
+        
+        Returns:
+            Whether each action was executed
+        """
+        if not self.injector:
+            return [False] * len(actions)
+        
+        cobs = state.get_ready_cobs() if state is not None else []
+        commands = []
+        for action in actions:
+            if action.is_plant_action:
+                commands.append(self.injector.plant_command(action.row, action.col,
+                                                            action.plant_type))
+            elif action.action_type == ActionType.SHOVEL:
+                commands.append(self.injector.shovel_command(action.row, action.col))
+            elif action.action_type == ActionType.USE_COB and cobs:
+                cob = cobs.pop(0)
+                commands.append(self.injector.fire_cob_command(cob.index, action.target_x,
+                                                               action.target_y))
+            else:
+                commands.append(None)
+        return self.injector.execute_batch(commands)
+    
     def collect_all_items(self) -> int:
         """Collect all items (sun, coins)"""
         if not self.reader or not self.writer:
@@ -238,7 +209,7 @@ class PVZMemoryInterface:
             return 0
         
         count = 0
-        item_array = self.reader.read_int(board + Offset.ITEM_ARRAY)
+        item_array = self.reader.get_board_pointer(Offset.ITEM_ARRAY, board)
         item_max = self.reader.read_int(board + Offset.ITEM_COUNT_MAX)
         
         for i in range(min(item_max, 100)):
@@ -258,7 +229,7 @@ class PVZMemoryInterface:
     @property
     def pid(self) -> Optional[int]:
         """Get process ID"""
-        return self.attacher.pid
+        return self.attacher.pid if self.attacher else None
 
 
 class OptimalBot:
@@ -269,14 +240,32 @@ class OptimalBot:
     and action execution.
     """
     
-    def __init__(self, config: Optional[BotConfig] = None):
+    # State sections an action is only taken on when read by the same poll
+    FRESH_FOR_ACTION = ('plants', 'seeds')
+    
+    def __init__(self, config: Optional[BotConfig] = None,
+                 backend: Optional[MemoryBackend] = None, record: Optional[str] = None,
+                 memory=None):
         self.config = config or BotConfig()
-        self.memory = PVZMemoryInterface()
-        self.optimizer = ActionOptimizer()
+        # Any object with PVZMemoryInterface's methods (e.g. a HeadlessInterface)
+        self.memory = memory or PVZMemoryInterface(backend, record)
+        if self.config.use_mcts and self.config.mcts_workers > 1:
+            self.optimizer = ParallelMCTSOptimizer(workers=self.config.mcts_workers,
+                                                   time_budget=self.config.mcts_time_budget)
+        elif self.config.use_mcts:
+            self.optimizer = MCTSOptimizer(time_budget=self.config.mcts_time_budget,
+                                           reuse_tree=self.config.mcts_reuse_tree)
+        else:
+            self.optimizer = ActionOptimizer()
         self.logger = get_logger()
         
+        # States are read on a background thread; decisions take the latest
+        self.poller = StatePoller(self._poll, self.config.refresh_rate,
+                                  self.config.lockstep_polling)
+        self.latency = LatencyHistogram()  # State read to decision acted on
+        
         self.running = False
-        self.last_action_time = 0.0
+        self.last_action_clock: Optional[int] = None  # Game clock of the last action
     
     def start(self):
         """Start the bot"""
@@ -304,34 +293,61 @@ class OptimalBot:
         print("=" * 60)
     
     def _run_loop(self):
-        """Main loop"""
+        """Main loop: decide on the freshest state the poller has read"""
+        self.optimizer.warm_up()  # Not inside the first decision's budget
+        self.poller.start()
+        sequence = 0
         try:
             while self.running:
-                # Get game state
-                state = self.memory.get_game_state()
+                if self.memory.finished:
+                    print()
+                    self.logger.info("Game session finished")
+                    break
+                if self.poller.error is not None:
+                    print()
+                    self.logger.error(f"State reading failed: {self.poller.error}")
+                    break
                 
-                if state is None:
-                    status_line("[Waiting] Not in game...")
-                    time.sleep(0.5)
+                # Wait for a state newer than the last one decided on
+                published = self.poller.wait_newer(sequence, timeout=0.5)
+                if published is None:
                     continue
+                sequence = published.sequence
+                state = published.state
                 
-                # Auto-collect items
-                if self.config.auto_collect_sun:
-                    self.memory.collect_all_items()
-                
-                # Display status
-                self._display_status(state)
-                
-                # Get and execute action
-                if self.config.auto_plant:
-                    self._process_action(state)
-                
-                time.sleep(self.config.refresh_rate)
-                
+                try:
+                    if state is None:
+                        status_line("[Waiting] Not in game...")
+                        continue
+                    
+                    # Display status
+                    self._display_status(state)
+                    
+                    # Get and execute action
+                    if self.config.auto_plant:
+                        self._process_action(published)
+                finally:
+                    self.poller.done()  # Decided on: a lockstep poller may read again
+        
         except KeyboardInterrupt:
             print("\n")
             self.logger.info("Bot stopped by user")
             self.running = False
+        finally:
+            self.poller.stop()
+            self.optimizer.close()
+            self.memory.close()
+            if self.latency.count:
+                self.logger.info(f"Read-to-act latency: {self.latency.summary()}")
+                for line in self.latency.lines():
+                    self.logger.info(line)
+    
+    def _poll(self) -> Optional[GameState]:
+        """Read one state and collect items (poller thread)"""
+        state = self.memory.get_game_state()
+        if state is not None and self.config.auto_collect_sun:
+            self.memory.collect_all_items()
+        return state
     
     def _display_status(self, state: GameState):
         """Display current game status"""
@@ -340,20 +356,35 @@ class OptimalBot:
                  f"Plants: {state.plant_count:2d} | "
                  f"Zombies: {state.zombie_count:2d} | "
                  f"Clock: {state.game_clock}")
+        if self.config.debug and self.memory.reader:
+            status += (f" | Reads: {self.memory.reader.refresh_reads}"
+                       f" | Act: p99<={self.latency.percentile(99):.0f}ms")
         status_line(status)
     
-    def _process_action(self, state: GameState):
+    def _process_action(self, published: PublishedState):
         """Process and execute actions"""
-        current_time = time.time()
-        if current_time - self.last_action_time < self.config.action_interval:
+        # Paced on the game clock, so a replay or a headless game running
+        # faster than real time gets as many actions per game second
+        state = published.state
+        if (self.last_action_clock is not None
+                and 0 <= state.game_clock - self.last_action_clock
+                < self.config.action_interval * 100):
+            return
+        
+        # Plants and seed cards may be served from earlier polls: decide on
+        # fresh ones, waiting for the next poll, which reads them, before
+        # spending a search on this one
+        stale = [name for name in self.FRESH_FOR_ACTION if state.ages.get(name, 0) > 0]
+        if stale:
+            self.memory.require_fresh(*stale)
             return
         
         # Get best action from optimizer
         action = self.optimizer.get_best_action(state)
         
-        if action and not action.is_wait:
-            if self._execute_action(action, state):
-                self.last_action_time = current_time
+        if action and not action.is_wait and self._execute_action(action, state):
+            self.last_action_clock = state.game_clock
+        self.latency.record(time.perf_counter() - published.read_time)
     
     def _execute_action(self, action: Action, state: GameState) -> bool:
         """Execute an action"""
@@ -387,14 +418,51 @@ class OptimalBot:
         return False
 
 
+def dump_image(path: str):
+    """Capture the memory that game state reading touches into an image file"""
+    logger = get_logger()
+    memory = PVZMemoryInterface()
+    if not memory.attach(command_loop=False):
+        logger.error("Failed to attach to PVZ process. Make sure the game is running!")
+        return
+    
+    try:
+        regions = memory.game_reader.state_regions()
+        if not regions:
+            logger.error("Not in a game: nothing to dump")
+            return
+        
+        image = ImageBackend.capture(memory.backend, regions)
+        image.save(path)
+        logger.info(f"Saved {sum(size for _, size in image.regions)} bytes "
+                    f"in {len(image.regions)} regions to {path}")
+    finally:
+        memory.close()
+
+
 def main():
     """Main entry point"""
     parser = argparse.ArgumentParser(description="PVZ Optimal Algorithm Bot")
     parser.add_argument("--debug", action="store_true", help="Enable debug mode")
     parser.add_argument("--no-plant", action="store_true", help="Disable auto-planting")
     parser.add_argument("--no-collect", action="store_true", help="Disable auto-collecting")
+    parser.add_argument("--dump", metavar="PATH", help="Save a memory image of the current board and exit")
+    parser.add_argument("--image", metavar="PATH", help="Read the game from a saved memory image")
+    parser.add_argument("--record", metavar="PATH", help="Record the session's memory reads to a log")
+    parser.add_argument("--replay", metavar="PATH", help="Play a recorded session log back")
+    parser.add_argument("--replay-speed", type=float, default=1.0, metavar="X",
+                        help="Replay speed (0: as fast as possible)")
+    parser.add_argument("--headless", action="store_true",
+                        help="Play a simulated level instead of the game")
+    parser.add_argument("--waves", type=int, default=20, help="Waves of the headless level")
+    parser.add_argument("--speed", type=float, default=0.0, metavar="X",
+                        help="Headless game speed (0: as fast as the bot polls)")
     args = parser.parse_args()
     
+    if args.dump:
+        dump_image(args.dump)
+        return
+    
     # Create config
     config = BotConfig()
     if args.debug:
@@ -406,8 +474,22 @@ def main():
         config.auto_collect_sun = False
     
     # Start bot
-    bot = OptimalBot(config)
+    backend = memory = None
+    if args.headless:
+        memory = HeadlessInterface(create_level_waves(args.waves), speed=args.speed)
+        if args.speed == 0:
+            config.refresh_rate = 0.0  # Each poll advances the game
+            config.lockstep_polling = True
+    elif args.image:
+        backend = ImageBackend.load(args.image)
+    elif args.replay:
+        backend = ReplayBackend(args.replay, args.replay_speed)
+        config.refresh_rate = 0.0  # The replay keeps the recorded pace
+    bot = OptimalBot(config, backend, args.record, memory)
     bot.start()
+    if memory is not None:
+        get_logger().info(f"Headless level {'won' if memory.won else 'lost'} at wave "
+                          f"{memory.sim.wave}, game clock {memory.sim.frame}")
 
 
 if __name__ == "__main__":
@@ -3,7 +3,10 @@ Memory Operations Module
 Provides process attachment, memory reading/writing, and ASM injection
 """
 
-from memory.process import ProcessAttacher
+from memory.process import ProcessAttacher, WineProcessAttacher, create_attacher
+from memory.backend import MemoryBackend, Kernel32Backend, ProcMemBackend, ImageBackend
+from memory.recording import RecordingBackend, ReplayBackend
 from memory.reader import MemoryReader
 from memory.writer import MemoryWriter
+from memory.command_queue import CommandQueue
 from memory.injector import AsmInjector
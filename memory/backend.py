@@ -0,0 +1,339 @@
+"""
+Memory Backend Module
+Byte sources that the reader, writer and injector access process memory through
+"""
+
+import ctypes
+import mmap
+import os
+import struct
+from abc import ABC, abstractmethod
+from bisect import bisect_right
+from typing import Dict, Iterable, Optional, Tuple
+
+
+# Windows API constants
+MEM_COMMIT = 0x1000
+MEM_RESERVE = 0x2000
+MEM_RELEASE = 0x8000
+PAGE_EXECUTE_READWRITE = 0x40
+
+# Memory image file: header, then one entry per region, then region data
+_IMAGE_MAGIC = b'PVZIMG1\0'
+_IMAGE_HEADER = struct.Struct('<8sI')
+_IMAGE_ENTRY = struct.Struct('<QIQ')  # address, size, file offset
+
+
+class MemoryBackend(ABC):
+    """
+    Access to the memory of a PVZ process
+    
+    A read of memory that cannot be read returns zeros, as a failed
+    ReadProcessMemory leaves its buffer zeroed. Writing and running code
+    are optional: a backend that cannot do them reports failure.
+    """
+    
+    @abstractmethod
+    def read(self, address: int, size: int) -> bytes:
+        """Read size bytes starting at address"""
+        pass
+    
+    def write(self, address: int, data: bytes) -> bool:
+        """Write bytes at address; False if they were not written"""
+        return False
+    
+    def alloc(self, size: int) -> int:
+        """Allocate executable memory in the process; 0 if unsupported"""
+        return 0
+    
+    def free(self, address: int) -> None:
+        """Free memory returned by alloc()"""
+        pass
+    
+    def run_thread(self, address: int, timeout: int = 1000) -> bool:
+        """Run code at address on a new thread of the process and wait (ms)"""
+        return False
+    
+    def mark_poll(self, game_clock: int) -> None:
+        """End one poll of the game state (recordings are split into polls)"""
+        pass
+    
+    @property
+    def finished(self) -> bool:
+        """Whether a replayed session has run out of polls"""
+        return False
+    
+    def close(self) -> None:
+        """Release the backend's handles"""
+        pass
+
+
+# ============================================================================
+# Windows
+# ============================================================================
+
+class Kernel32Backend(MemoryBackend):
+    """Accesses a Windows process through kernel32"""
+    
+    def __init__(self, kernel32, process_handle: int):
+        self.kernel32 = kernel32
+        self.process = process_handle
+    
+    def read(self, address: int, size: int) -> bytes:
+        buf = ctypes.create_string_buffer(size)
+        self.kernel32.ReadProcessMemory(self.process, address, buf, size, None)
+        return buf.raw
+    
+    def write(self, address: int, data: bytes) -> bool:
+        written = ctypes.c_size_t()
+        result = self.kernel32.WriteProcessMemory(
+            self.process, address, data, len(data), ctypes.byref(written)
+        )
+        return result != 0
+    
+    def alloc(self, size: int) -> int:
+        addr = self.kernel32.VirtualAllocEx(
+            self.process,
+            None,
+            size,
+            MEM_COMMIT | MEM_RESERVE,
+            PAGE_EXECUTE_READWRITE
+        )
+        return addr or 0
+    
+    def free(self, address: int) -> None:
+        self.kernel32.VirtualFreeEx(self.process, address, 0, MEM_RELEASE)
+    
+    def run_thread(self, address: int, timeout: int = 1000) -> bool:
+        from ctypes import wintypes
+        thread_id = wintypes.DWORD()
+        thread = self.kernel32.CreateRemoteThread(
+            self.process,
+            None, 0,
+            address, None, 0,
+            ctypes.byref(thread_id)
+        )
+        if not thread:
+            return False
+        
+        self.kernel32.WaitForSingleObject(thread, timeout)
+        self.kernel32.CloseHandle(thread)
+        return True
+
+
+# ============================================================================
+# Linux (the game under Wine)
+# ============================================================================
+
+class _IOVec(ctypes.Structure):
+    _fields_ = [('iov_base', ctypes.c_void_p), ('iov_len', ctypes.c_size_t)]
+
+
+def _load_process_vm_readv():
+    """libc's process_vm_readv, or None where it is missing"""
+    try:
+        libc = ctypes.CDLL(None, use_errno=True)
+        readv = libc.process_vm_readv
+    except (OSError, AttributeError):
+        return None
+    readv.argtypes = [ctypes.c_int, ctypes.POINTER(_IOVec), ctypes.c_ulong,
+                      ctypes.POINTER(_IOVec), ctypes.c_ulong, ctypes.c_ulong]
+    readv.restype = ctypes.c_ssize_t
+    return readv
+
+
+class ProcMemBackend(MemoryBackend):
+    """
+    Accesses a Linux process, such as the game running under Wine
+    
+    Reads use process_vm_readv (one syscall, no file position), falling
+    back to /proc/<pid>/mem; writes go through /proc/<pid>/mem, which can
+    also write read-only pages. Both need ptrace access to the process
+    (same user, and kernel.yama.ptrace_scope 0 or a ptrace capability).
+    Running code in the process is not supported.
+    """
+    
+    def __init__(self, pid: int):
+        """
+        Open the process
+        
+        Args:
+            pid: Linux process ID (the Wine process of the game)
+        """
+        self.pid = pid
+        self._readv = _load_process_vm_readv()
+        try:
+            self._fd = os.open(f'/proc/{pid}/mem', os.O_RDWR)
+        except PermissionError:
+            self._fd = os.open(f'/proc/{pid}/mem', os.O_RDONLY)  # Reads only
+    
+    def read(self, address: int, size: int) -> bytes:
+        if self._readv is not None:
+            buf = ctypes.create_string_buffer(size)
+            local = _IOVec(ctypes.addressof(buf), size)
+            remote = _IOVec(address, size)
+            if self._readv(self.pid, ctypes.byref(local), 1, ctypes.byref(remote), 1, 0) >= 0:
+                return buf.raw
+        try:
+            data = os.pread(self._fd, size, address)
+        except OSError:
+            data = b''
+        return data.ljust(size, b'\0')
+    
+    def write(self, address: int, data: bytes) -> bool:
+        try:
+            return os.pwrite(self._fd, data, address) == len(data)
+        except OSError:
+            return False
+    
+    def close(self) -> None:
+        if self._fd is not None:
+            os.close(self._fd)
+            self._fd = None
+
+
+# ============================================================================
+# Memory Image
+# ============================================================================
+
+class ImageBackend(MemoryBackend):
+    """
+    Sparse in-memory image of a process
+    
+    Holds regions of bytes at their addresses; everything else reads as
+    zeros. Images are captured from another backend and saved to a file,
+    which load() maps back without copying. Used to run the readers
+    without a game process.
+    """
+    
+    def __init__(self, regions: Optional[Dict[int, bytes]] = None):
+        """
+        Initialize the image
+        
+        Args:
+            regions: Start address -> bytes of each mapped region
+        """
+        self._starts = []
+        self._regions = []
+        self._file = None
+        for address, data in sorted((regions or {}).items()):
+            self.map(address, data)
+    
+    def map(self, address: int, data: bytes) -> None:
+        """Map a copy of a region (must not overlap a mapped one)"""
+        self._insert(address, bytearray(data))
+    
+    def _insert(self, address: int, region) -> None:
+        index = bisect_right(self._starts, address)
+        if index > 0:
+            start, previous = self._starts[index - 1], self._regions[index - 1]
+            if address < start + len(previous):
+                raise ValueError(f"Region at 0x{address:X} overlaps region at 0x{start:X}")
+        if index < len(self._starts) and address + len(region) > self._starts[index]:
+            raise ValueError(f"Region at 0x{address:X} overlaps region at 0x{self._starts[index]:X}")
+        self._starts.insert(index, address)
+        self._regions.insert(index, region)
+    
+    @property
+    def regions(self) -> Iterable[Tuple[int, int]]:
+        """(address, size) of each mapped region, in address order"""
+        return [(start, len(region)) for start, region in zip(self._starts, self._regions)]
+    
+    def read(self, address: int, size: int) -> bytes:
+        index = max(bisect_right(self._starts, address) - 1, 0)
+        if index < len(self._starts):
+            offset = address - self._starts[index]
+            region = self._regions[index]
+            if 0 <= offset and offset + size <= len(region):
+                return bytes(region[offset:offset + size])
+        
+        # Spans region edges: copy each overlapping part, zeros elsewhere
+        out = bytearray(size)
+        end = address + size
+        while index < len(self._starts) and self._starts[index] < end:
+            start, region = self._starts[index], self._regions[index]
+            low, high = max(address, start), min(end, start + len(region))
+            if low < high:
+                out[low - address:high - address] = region[low - start:high - start]
+            index += 1
+        return bytes(out)
+    
+    def write(self, address: int, data: bytes) -> bool:
+        """Overwrite mapped bytes; False unless one region holds all of them"""
+        index = bisect_right(self._starts, address) - 1
+        if index < 0 or address + len(data) > self._starts[index] + len(self._regions[index]):
+            return False
+        offset = address - self._starts[index]
+        self._regions[index][offset:offset + len(data)] = data
+        return True
+    
+    # ========================================================================
+    # Capture and Files
+    # ========================================================================
+    
+    @classmethod
+    def capture(cls, source: MemoryBackend, regions: Iterable[Tuple[int, int]]) -> 'ImageBackend':
+        """
+        Copy regions of another backend's memory
+        
+        Args:
+            source: Backend to read from (a live game)
+            regions: (address, size) to copy; overlapping ones are merged
+        """
+        merged = []
+        for address, size in sorted(regions):
+            if size <= 0:
+                continue
+            if merged and address <= merged[-1][0] + merged[-1][1]:
+                start = merged[-1][0]
+                merged[-1] = (start, max(merged[-1][1], address + size - start))
+            else:
+                merged.append((address, size))
+        
+        image = cls()
+        for address, size in merged:
+            image.map(address, source.read(address, size))
+        return image
+    
+    def save(self, path: str) -> None:
+        """Write the image to a file that load() maps back"""
+        offset = _IMAGE_HEADER.size + _IMAGE_ENTRY.size * len(self._starts)
+        entries = []
+        for start, region in zip(self._starts, self._regions):
+            entries.append(_IMAGE_ENTRY.pack(start, len(region), offset))
+            offset += len(region)
+        with open(path, 'wb') as f:
+            f.write(_IMAGE_HEADER.pack(_IMAGE_MAGIC, len(self._starts)))
+            f.write(b''.join(entries))
+            for region in self._regions:
+                f.write(region)
+    
+    @classmethod
+    def load(cls, path: str) -> 'ImageBackend':
+        """
+        Map an image file saved by save()
+        
+        Regions are views of a private mapping of the file: nothing is
+        copied until read, and writes change the image, not the file.
+        """
+        with open(path, 'rb') as f:
+            data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_COPY)
+        magic, count = _IMAGE_HEADER.unpack_from(data, 0)
+        if magic != _IMAGE_MAGIC:
+            data.close()
+            raise ValueError(f"{path} is not a memory image")
+        
+        image = cls()
+        image._file = data
+        view = memoryview(data)
+        for i in range(count):
+            address, size, offset = _IMAGE_ENTRY.unpack_from(
+                data, _IMAGE_HEADER.size + i * _IMAGE_ENTRY.size)
+            image._insert(address, view[offset:offset + size])
+        return image
+    
+    def close(self) -> None:
+        if self._file is not None:
+            self._starts, self._regions = [], []
+            self._file.close()
+            self._file = None
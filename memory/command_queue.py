@@ -0,0 +1,387 @@
+"""
+Command Queue Module
+A command loop injected once into the game, fed through a ring buffer
+"""
+
+import struct
+import time
+from typing import Callable, List, Optional, Sequence, Tuple
+
+from data.offsets import Offset
+from memory.backend import MemoryBackend
+
+
+# Where the game's executable is loaded (no ASLR on the 2009 build)
+GAME_MODULE_BASE = 0x00400000
+
+# Queue memory: header, then a ring of fixed-size commands, then the loop code.
+# The bot writes head (after the command), the loop writes done and tail.
+QUEUE_HEADER = struct.Struct('<IIII')  # head, tail, stop request, stopped
+COMMAND = struct.Struct('<III5i')  # op, done, seq, arguments
+COMMAND_ARGS = 5
+DEFAULT_CAPACITY = 16  # Commands in the ring (a power of two)
+
+# Idle checks the loop spins through after a command before it sleeps
+SPIN_COUNT = 4096
+
+# Command operations and their arguments
+OP_PLANT = 1  # board, row, col, plant type, imitator type
+OP_SHOVEL = 2  # plant
+OP_FIRE_COB = 3  # cob cannon plant, x, y
+OP_COLLECT = 4  # item
+
+
+def encode_command(op: int, seq: int, args: Sequence[int]) -> bytes:
+    """
+    Bytes of one ring entry
+    
+    Args:
+        op: OP_* operation
+        seq: Submission number (from 1); the loop copies it to done
+        args: Up to COMMAND_ARGS integer arguments
+    """
+    if len(args) > COMMAND_ARGS:
+        raise ValueError(f"A command takes at most {COMMAND_ARGS} arguments")
+    padded = list(args) + [0] * (COMMAND_ARGS - len(args))
+    return COMMAND.pack(op, 0, seq, *padded)
+
+
+def queue_size(capacity: int) -> int:
+    """Bytes before the loop code: header and ring"""
+    return QUEUE_HEADER.size + capacity * COMMAND.size
+
+
+# ============================================================================
+# Loop Code
+# ============================================================================
+
+def _assemble(parts: list) -> bytes:
+    """
+    Join code parts, resolving jumps
+    
+    Parts are bytes, ('label', name) or (opcode, name): a jump with a
+    32-bit displacement to a label, opcode 'jmp', 'je' or 'jne'.
+    """
+    opcodes = {'jmp': b'\xE9', 'je': b'\x0F\x84', 'jne': b'\x0F\x85'}
+    labels = {}
+    offset = 0
+    for part in parts:
+        if isinstance(part, bytes):
+            offset += len(part)
+        elif part[0] == 'label':
+            labels[part[1]] = offset
+        else:
+            offset += len(opcodes[part[0]]) + 4
+    
+    code = bytearray()
+    for part in parts:
+        if isinstance(part, bytes):
+            code += part
+        elif part[0] != 'label':
+            code += opcodes[part[0]]
+            code += struct.pack('<i', labels[part[1]] - (len(code) + 4))
+    return bytes(code)
+
+
+def command_loop_code(queue: int, capacity: int, sleep_slot: int) -> bytes:
+    """
+    Machine code of the command loop (x86, a thread procedure)
+    
+    Runs each command of the ring in order, marking it done with its
+    seq, then waits for more: it spins SPIN_COUNT checks after a command
+    (actions come in bursts) and then calls Sleep(1) between checks.
+    Returns when the stop request is set, after setting stopped.
+    
+    Args:
+        queue: Address of the queue header
+        capacity: Commands in the ring (a power of two)
+        sleep_slot: Address of the game's import slot of kernel32 Sleep
+    """
+    if capacity <= 0 or capacity & (capacity - 1):
+        raise ValueError("Queue capacity must be a power of two")
+    imm = lambda value: struct.pack('<I', value & 0xFFFFFFFF)
+    return _assemble([
+        b'\x53\x56\x57\x55',  # push ebx, esi, edi, ebp
+        b'\xBB' + imm(queue),  # mov ebx, queue
+        ('label', 'busy'),
+        b'\xBD' + imm(SPIN_COUNT),  # mov ebp, SPIN_COUNT
+        ('label', 'check'),
+        b'\x83\x7B\x08\x00',  # cmp dword [ebx+8], 0 (stop request)
+        ('jne', 'exit'),
+        b'\x8B\x43\x04',  # mov eax, [ebx+4] (tail)
+        b'\x3B\x03',  # cmp eax, [ebx] (head)
+        ('jne', 'run'),
+        b'\x4D',  # dec ebp
+        ('je', 'sleep'),
+        b'\xF3\x90',  # pause
+        ('jmp', 'check'),
+        ('label', 'sleep'),
+        b'\x6A\x01',  # push 1
+        b'\xFF\x15' + imm(sleep_slot),  # call [Sleep]
+        b'\xBD' + imm(1),  # mov ebp, 1 (sleep again on the next idle check)
+        ('jmp', 'check'),
+        
+        ('label', 'run'),
+        b'\x25' + imm(capacity - 1),  # and eax, capacity - 1
+        b'\xC1\xE0\x05',  # shl eax, 5 (COMMAND.size)
+        b'\x8D\x74\x03' + bytes([QUEUE_HEADER.size]),  # lea esi, [ebx+eax+header]
+        b'\x8B\x06',  # mov eax, [esi] (op)
+        b'\x83\xF8' + bytes([OP_PLANT]), ('je', 'plant'),  # cmp eax, OP_PLANT
+        b'\x83\xF8' + bytes([OP_SHOVEL]), ('je', 'shovel'),
+        b'\x83\xF8' + bytes([OP_FIRE_COB]), ('je', 'fire_cob'),
+        b'\x83\xF8' + bytes([OP_COLLECT]), ('je', 'collect'),
+        ('jmp', 'done'),
+        
+        # Same calls as the one-shot code of AsmInjector
+        ('label', 'plant'),
+        b'\xFF\x76\x1C',  # push [esi+0x1C] (imitator type)
+        b'\xFF\x76\x18',  # push [esi+0x18] (plant type)
+        b'\x8B\x46\x10',  # mov eax, [esi+0x10] (row)
+        b'\xFF\x76\x14',  # push [esi+0x14] (col)
+        b'\x8B\x7E\x0C',  # mov edi, [esi+0x0C] (board)
+        b'\x57',  # push edi
+        b'\xBA' + imm(Offset.FUNC_PLANT),  # mov edx, FUNC_PLANT
+        b'\xFF\xD2',  # call edx
+        ('jmp', 'done'),
+        ('label', 'shovel'),
+        b'\xFF\x76\x0C',  # push [esi+0x0C] (plant)
+        b'\xBA' + imm(Offset.FUNC_REMOVE_PLANT),  # mov edx, FUNC_REMOVE_PLANT
+        b'\xFF\xD2',  # call edx
+        ('jmp', 'done'),
+        ('label', 'fire_cob'),
+        b'\xFF\x76\x14',  # push [esi+0x14] (y)
+        b'\xFF\x76\x10',  # push [esi+0x10] (x)
+        b'\x8B\x46\x0C',  # mov eax, [esi+0x0C] (cob cannon)
+        b'\xB9' + imm(Offset.FUNC_COB_FIRE),  # mov ecx, FUNC_COB_FIRE
+        b'\xFF\xD1',  # call ecx
+        ('jmp', 'done'),
+        ('label', 'collect'),
+        b'\x8B\x46\x0C',  # mov eax, [esi+0x0C] (item)
+        b'\xC6\x40' + bytes([Offset.I_COLLECTED, 1]),  # mov byte [eax+I_COLLECTED], 1
+        
+        ('label', 'done'),
+        b'\x8B\x46\x08',  # mov eax, [esi+8] (seq)
+        b'\x89\x46\x04',  # mov [esi+4], eax (done)
+        b'\xFF\x43\x04',  # inc dword [ebx+4] (tail)
+        ('jmp', 'busy'),
+        
+        ('label', 'exit'),
+        b'\xC7\x43\x0C' + imm(1),  # mov dword [ebx+0xC], 1 (stopped)
+        b'\x5D\x5F\x5E\x5B',  # pop ebp, edi, esi, ebx
+        b'\x31\xC0',  # xor eax, eax
+        b'\xC2\x04\x00',  # ret 4
+    ])
+
+
+# ============================================================================
+# Import Lookup
+# ============================================================================
+
+def _read_u32(backend: MemoryBackend, address: int) -> int:
+    return struct.unpack('<I', backend.read(address, 4))[0]
+
+
+def _read_name(backend: MemoryBackend, address: int, limit: int = 64) -> bytes:
+    return backend.read(address, limit).split(b'\0', 1)[0]
+
+
+def find_import_slot(backend: MemoryBackend, dll: str, function: str,
+                     module: int = GAME_MODULE_BASE) -> int:
+    """
+    Address of a module's import address table slot for a function
+    
+    The slot holds the function's address as loaded in the process, so
+    injected code calls through it (call [slot]) without knowing where
+    the process's kernel32 is.
+    
+    Args:
+        backend: Memory of the process
+        dll: Imported DLL name (case-insensitive)
+        function: Function imported by name
+        module: Base address of the importing module
+    
+    Returns:
+        Slot address, or 0 if the module does not import the function
+    """
+    if backend.read(module, 2) != b'MZ':
+        return 0
+    headers = module + _read_u32(backend, module + 0x3C)
+    if backend.read(headers, 4) != b'PE\0\0':
+        return 0
+    directory = _read_u32(backend, headers + 0x80)  # Import directory RVA (PE32)
+    if not directory:
+        return 0
+    
+    wanted_dll, wanted = dll.lower().encode(), function.encode()
+    descriptor = module + directory
+    while True:
+        lookup, _, _, name, slots = struct.unpack('<5I', backend.read(descriptor, 20))
+        if not name:
+            return 0
+        if _read_name(backend, module + name).lower() == wanted_dll:
+            lookup = lookup or slots
+            for i in range(4096):
+                entry = _read_u32(backend, module + lookup + i * 4)
+                if not entry:
+                    break
+                if not entry & 0x80000000 and _read_name(backend, module + entry + 2) == wanted:
+                    return module + slots + i * 4
+        descriptor += 20
+
+
+# ============================================================================
+# Queue
+# ============================================================================
+
+class CommandQueue:
+    """
+    Ring of commands run by a loop on a thread of the game
+    
+    Submitting a command costs two writes (the entry, then head) instead
+    of allocating, writing, running and freeing code on a new remote
+    thread per action. A command is done when the loop has copied its
+    seq into the entry's done field.
+    """
+    
+    def __init__(self, backend: MemoryBackend, address: int, capacity: int = DEFAULT_CAPACITY,
+                 clock: Callable[[], float] = time.perf_counter,
+                 sleep: Callable[[float], None] = time.sleep):
+        """
+        Use a queue laid out at address
+        
+        Args:
+            backend: Memory of the game
+            address: Queue header (written by install())
+            capacity: Commands in the ring
+            clock: Time source for timeouts
+            sleep: Waits while polling for completion
+        """
+        self.backend = backend
+        self.address = address
+        self.capacity = capacity
+        self.clock = clock
+        self.sleep = sleep
+        self.head = 0  # Commands submitted
+        self.owned = False  # Memory allocated by install(), freed by close()
+    
+    @classmethod
+    def install(cls, backend: MemoryBackend, capacity: int = DEFAULT_CAPACITY,
+                module: int = GAME_MODULE_BASE) -> Optional['CommandQueue']:
+        """
+        Inject the queue and start its loop on a thread of the game
+        
+        Returns:
+            The running queue, or None if the backend cannot run code or
+            the game does not import Sleep
+        """
+        size = queue_size(capacity)
+        code_size = len(command_loop_code(0, capacity, 0))
+        address = backend.alloc(size + code_size)
+        if not address:
+            return None
+        
+        sleep_slot = find_import_slot(backend, 'kernel32.dll', 'Sleep', module)
+        code = command_loop_code(address, capacity, sleep_slot)
+        if (not sleep_slot or not backend.write(address, bytes(size) + code)
+                or not backend.run_thread(address + size, timeout=0)):
+            backend.free(address)
+            return None
+        
+        queue = cls(backend, address, capacity)
+        queue.owned = True
+        return queue
+    
+    def _header(self) -> tuple:
+        return QUEUE_HEADER.unpack(self.backend.read(self.address, QUEUE_HEADER.size))
+    
+    def _entry(self, seq: int) -> int:
+        return self.address + QUEUE_HEADER.size + ((seq - 1) % self.capacity) * COMMAND.size
+    
+    def _wait(self, ready: Callable[[], bool], timeout: int) -> bool:
+        """Poll until ready() or timeout (ms)"""
+        deadline = self.clock() + timeout / 1000.0
+        while not ready():
+            if self.clock() >= deadline:
+                return False
+            self.sleep(0.0002)
+        return True
+    
+    def submit(self, op: int, *args: int, timeout: int = 1000) -> int:
+        """
+        Queue a command without waiting for it
+        
+        Returns:
+            The command's seq, or 0 if the ring stayed full or it was
+            not written
+        """
+        return self.submit_batch([(op, args)], timeout)[0]
+    
+    def submit_batch(self, commands: Sequence[Tuple[int, Sequence[int]]],
+                     timeout: int = 1000) -> List[int]:
+        """
+        Queue commands without waiting for them
+        
+        Up to capacity commands at a time are written with one write of
+        their entries (two where the ring wraps) and one of head, so the
+        loop sees them together.
+        
+        Args:
+            commands: (op, args) of each command
+        
+        Returns:
+            Each command's seq, 0 for those not queued (ring stayed full
+            or a write failed)
+        """
+        seqs: List[int] = []
+        for start in range(0, len(commands), self.capacity):
+            part = commands[start:start + self.capacity]
+            if self.head + len(part) > self.capacity and not self._wait(
+                    lambda: self.head + len(part) - self._header()[1] <= self.capacity, timeout):
+                break
+            first = self.head + 1
+            entries = b''.join(encode_command(op, first + i, args)
+                               for i, (op, args) in enumerate(part))
+            split = (self.capacity - (first - 1) % self.capacity) * COMMAND.size
+            written = self.backend.write(self._entry(first), entries[:split])
+            if written and len(entries) > split:
+                written = self.backend.write(self._entry(1), entries[split:])
+            if not written or not self.backend.write(self.address,
+                                                     struct.pack('<I', self.head + len(part))):
+                break
+            self.head += len(part)
+            seqs.extend(range(first, first + len(part)))
+        return seqs + [0] * (len(commands) - len(seqs))
+    
+    def is_done(self, seq: int) -> bool:
+        """Whether the loop has run command seq"""
+        done = _read_u32(self.backend, self._entry(seq) + 4)
+        return done == seq or self._header()[1] >= seq + self.capacity
+    
+    def wait(self, seq: int, timeout: int = 1000) -> bool:
+        """Wait for command seq to be run (ms); False on timeout"""
+        return self._wait(lambda: self.is_done(seq), timeout)
+    
+    def call(self, op: int, *args: int, timeout: int = 1000) -> bool:
+        """Queue a command and wait for it"""
+        seq = self.submit(op, *args, timeout=timeout)
+        return seq != 0 and self.wait(seq, timeout)
+    
+    def stop(self, timeout: int = 1000) -> bool:
+        """Ask the loop to return and wait until it has"""
+        if not self.backend.write(self.address + 8, struct.pack('<I', 1)):
+            return False
+        return self._wait(lambda: self._header()[3] != 0, timeout)
+    
+    def close(self) -> None:
+        """
+        Stop the loop and free the queue
+        
+        A loop that does not confirm stopping may still run its code, so
+        its memory is left allocated.
+        """
+        if not self.owned:
+            return
+        self.owned = False
+        if self.stop():
+            self.sleep(0.01)  # Let the thread leave the code after setting stopped
+            self.backend.free(self.address)
@@ -4,19 +4,166 @@ Handles shellcode injection for calling game functions directly
 """
 
 import struct
-import ctypes
-from ctypes import wintypes
-from typing import Optional, List
+from typing import List, Optional, Sequence, Tuple
 
 from data.offsets import Offset
+from memory.backend import MemoryBackend, Kernel32Backend
+from memory.command_queue import (
+    CommandQueue, DEFAULT_CAPACITY, OP_COLLECT, OP_FIRE_COB, OP_PLANT, OP_SHOVEL,
+)
 from memory.reader import MemoryReader
 
 
-# Windows API constants
-MEM_COMMIT = 0x1000
-MEM_RESERVE = 0x2000
-MEM_RELEASE = 0x8000
-PAGE_EXECUTE_READWRITE = 0x40
+# ============================================================================
+# Shellcode
+# ============================================================================
+# Each builder returns the code of one call; code run on a thread ends in RET.
+
+RET = b'\xC3'
+
+# Result written back by batch code after each of its calls
+RESULT_DONE = 1
+
+
+def plant_code(board: int, row: int, col: int, plant_type: int, imitator_type: int = -1) -> bytes:
+    """
+    Code calling the game's plant function at 0x0040D120
+    
+    Calling convention (from pvz_cpp_bot/dllmain.cpp):
+        push imitatorType  (-1 = not imitator)
+        push plantType
+        mov eax, row
+        push col
+        mov edi, pBoard
+        push edi
+        call 0x0040D120
+    """
+    return bytes([
+        # push imitator_type
+        0x68, *struct.pack('<i', imitator_type),
+        
+        # push plant_type
+        0x68, *struct.pack('<i', plant_type),
+        
+        # mov eax, row
+        0xB8, *struct.pack('<I', row),
+        
+        # push col
+        0x68, *struct.pack('<i', col),
+        
+        # mov edi, board
+        0xBF, *struct.pack('<I', board),
+        
+        # push edi (board)
+        0x57,
+        
+        # mov edx, FUNC_PLANT
+        0xBA, *struct.pack('<I', Offset.FUNC_PLANT),
+        
+        # call edx
+        0xFF, 0xD2,
+    ])
+
+
+def remove_plant_code(plant_addr: int) -> bytes:
+    """Code calling RemovePlant on a plant"""
+    return bytes([
+        # push plant_addr
+        0x68, *struct.pack('<I', plant_addr),
+        
+        # mov edx, FUNC_REMOVE_PLANT
+        0xBA, *struct.pack('<I', Offset.FUNC_REMOVE_PLANT),
+        
+        # call edx
+        0xFF, 0xD2,
+    ])
+
+
+def refresh_seeds_code(seed_bank: int) -> bytes:
+    """Code refreshing every seed card's cooldown"""
+    return bytes([
+        # push seed_bank
+        0x68, *struct.pack('<I', seed_bank),
+        
+        # mov eax, FUNC_REFRESH_SEEDS
+        0xB8, *struct.pack('<I', Offset.FUNC_REFRESH_SEEDS),
+        
+        # call eax
+        0xFF, 0xD0,
+    ])
+
+
+def fire_cob_code(cob_addr: int, x: int, y: int) -> bytes:
+    """
+    Code firing a cob cannon at a point of the lawn
+    
+    Calling convention (AVZ's asm shoot): the cannon in eax, y and x on
+    the stack, which the function pops.
+        push y
+        push x
+        mov eax, pCob
+        call 0x00466D50
+    """
+    return bytes([
+        # push y
+        0x68, *struct.pack('<i', y),
+        
+        # push x
+        0x68, *struct.pack('<i', x),
+        
+        # mov eax, cob_addr
+        0xB8, *struct.pack('<I', cob_addr),
+        
+        # mov ecx, FUNC_COB_FIRE
+        0xB9, *struct.pack('<I', Offset.FUNC_COB_FIRE),
+        
+        # call ecx
+        0xFF, 0xD1,
+    ])
+
+
+def collect_code(item_addr: int) -> bytes:
+    """Code setting an item's collected flag"""
+    return bytes([
+        # mov byte [item_addr + I_COLLECTED], 1
+        0xC6, 0x05, *struct.pack('<I', item_addr + Offset.I_COLLECTED), 0x01,
+    ])
+
+
+# A command: OP_* operation and its arguments
+Command = Tuple[int, Sequence[int]]
+
+# Code of each command operation, taking the command's arguments
+_COMMAND_CODE = {
+    OP_PLANT: plant_code,
+    OP_SHOVEL: remove_plant_code,
+    OP_FIRE_COB: fire_cob_code,
+    OP_COLLECT: collect_code,
+}
+
+
+def command_code(op: int, args: Sequence[int]) -> bytes:
+    """Code of one command (an OP_* operation of memory.command_queue)"""
+    return _COMMAND_CODE[op](*args)
+
+
+def batch_code(commands: Sequence[Command], results: int) -> bytes:
+    """
+    Code running commands in order on one thread
+    
+    After command i returns, RESULT_DONE is written to the 32-bit slot
+    results + 4 * i, so a batch cut short shows which calls were made.
+    
+    Args:
+        commands: (op, args) of each command
+        results: Address of one zeroed slot per command
+    """
+    code = bytearray()
+    for i, (op, args) in enumerate(commands):
+        code += command_code(op, args)
+        # mov dword [results + 4 * i], RESULT_DONE
+        code += bytes([0xC7, 0x05, *struct.pack('<II', results + 4 * i, RESULT_DONE)])
+    return bytes(code + RET)
 
 
 class AsmInjector:
@@ -24,13 +171,23 @@ class AsmInjector:
     Injects and executes ASM shellcode in the game process
     
     This allows direct calling of game functions for reliable operations
-    like planting, shoveling, and firing cob cannons.
+    like planting, shoveling, and firing cob cannons. Needs a backend that
+    can run code in the process (Kernel32Backend); elsewhere every call
+    fails.
+    
+    Each call runs its shellcode on a new remote thread, unless
+    start_command_loop() has injected a CommandQueue: plant, shovel and
+    fire_cob then go through its ring to one long-lived thread.
     """
     
-    def __init__(self, kernel32, process_handle: int, reader: MemoryReader):
+    def __init__(self, kernel32=None, process_handle: int = 0,
+                 reader: Optional[MemoryReader] = None,
+                 backend: Optional[MemoryBackend] = None):
         self.kernel32 = kernel32
         self.process = process_handle
-        self.reader = reader
+        self.backend = backend or Kernel32Backend(kernel32, process_handle)
+        self.reader = reader or MemoryReader(backend=self.backend)
+        self.queue: Optional[CommandQueue] = None
     
     def alloc_memory(self, size: int) -> int:
         """
@@ -38,29 +195,19 @@ class AsmInjector:
         
         Args:
             size: Number of bytes to allocate
-            
+        
         Returns:
             Address of allocated memory, or 0 on failure
         """
-        addr = self.kernel32.VirtualAllocEx(
-            self.process,
-            None,
-            size,
-            MEM_COMMIT | MEM_RESERVE,
-            PAGE_EXECUTE_READWRITE
-        )
-        return addr or 0
+        return self.backend.alloc(size)
     
     def free_memory(self, address: int):
         """Free previously allocated memory"""
-        self.kernel32.VirtualFreeEx(self.process, address, 0, MEM_RELEASE)
+        self.backend.free(address)
     
     def write_bytes(self, address: int, data: bytes) -> bool:
         """Write bytes to process memory"""
-        written = ctypes.c_size_t()
-        return self.kernel32.WriteProcessMemory(
-            self.process, address, data, len(data), ctypes.byref(written)
-        )
+        return self.backend.write(address, data)
     
     def execute_shellcode(self, shellcode: bytes, timeout: int = 1000) -> bool:
         """
@@ -76,7 +223,7 @@ class AsmInjector:
         Args:
             shellcode: The machine code to execute
             timeout: Maximum time to wait for execution (ms)
-            
+        
         Returns:
             True if execution succeeded, False otherwise
         """
@@ -90,27 +237,139 @@ class AsmInjector:
             if not self.write_bytes(addr, shellcode):
                 return False
             
-            # Create remote thread to execute
-            thread_id = wintypes.DWORD()
-            thread = self.kernel32.CreateRemoteThread(
-                self.process,
-                None, 0,
-                addr, None, 0,
-                ctypes.byref(thread_id)
-            )
-            
-            if not thread:
-                return False
-            
-            # Wait for thread to complete
-            self.kernel32.WaitForSingleObject(thread, timeout)
-            self.kernel32.CloseHandle(thread)
-            return True
-            
+            # Run it on a remote thread and wait for completion
+            return self.backend.run_thread(addr, timeout)
+        
         finally:
             # Always free the allocated memory
             self.free_memory(addr)
     
+    # ========================================================================
+    # Command Loop
+    # ========================================================================
+    
+    def start_command_loop(self, capacity: int = DEFAULT_CAPACITY) -> bool:
+        """
+        Inject the command loop that later calls are queued to
+        
+        Returns:
+            True if the loop runs; False leaves one thread per call
+        """
+        if self.queue is None:
+            self.queue = CommandQueue.install(self.backend, capacity)
+        return self.queue is not None
+    
+    def stop_command_loop(self) -> None:
+        """Stop the command loop and free it"""
+        if self.queue is not None:
+            self.queue.close()
+            self.queue = None
+    
+    # ========================================================================
+    # Commands
+    # ========================================================================
+    
+    def run_command(self, command: Optional[Command], timeout: int = 1000) -> bool:
+        """
+        Run one command: through the command loop, else on its own thread
+        
+        Args:
+            command: (op, args) from a *_command method (None fails)
+            timeout: Maximum time to wait for execution (ms)
+        """
+        if command is None:
+            return False
+        op, args = command
+        if self.queue is not None:
+            return self.queue.call(op, *args, timeout=timeout)
+        return self.execute_shellcode(command_code(op, args) + RET, timeout)
+    
+    def execute_batch(self, commands: Sequence[Optional[Command]],
+                      timeout: int = 1000) -> List[bool]:
+        """
+        Run several commands in order with one injection
+        
+        Through the command loop the batch is one write of its ring
+        entries and one of the head; without it, one thread runs
+        batch_code(), which writes a result after each call.
+        
+        Args:
+            commands: (op, args) of each command; None entries are skipped
+            timeout: Maximum time to wait for the whole batch (ms)
+        
+        Returns:
+            Whether each command was run
+        """
+        runnable = [command for command in commands if command is not None]
+        if not runnable:
+            return [False] * len(commands)
+        
+        if self.queue is not None:
+            seqs = self.queue.submit_batch(runnable, timeout)
+            if seqs[-1] and self.queue.wait(seqs[-1], timeout):
+                done = [True] * len(runnable)  # The loop runs commands in order
+            else:
+                done = [seq != 0 and self.queue.is_done(seq) for seq in seqs]
+        else:
+            done = self._run_batch_code(runnable, timeout)
+        
+        done.reverse()
+        return [command is not None and done.pop() for command in commands]
+    
+    def _run_batch_code(self, commands: List[Command], timeout: int) -> List[bool]:
+        """Run batch_code() on a new thread and read its results back"""
+        results_size = 4 * len(commands)
+        addr = self.alloc_memory(results_size + len(batch_code(commands, 0)) + 16)
+        if not addr:
+            return [False] * len(commands)
+        
+        try:
+            # Results first (zeroed by the allocation), then the code
+            code = batch_code(commands, addr)
+            if not self.write_bytes(addr + results_size, code):
+                return [False] * len(commands)
+            if not self.backend.run_thread(addr + results_size, timeout):
+                return [False] * len(commands)
+            results = struct.unpack(f'<{len(commands)}I', self.backend.read(addr, results_size))
+            return [result == RESULT_DONE for result in results]
+        
+        finally:
+            self.free_memory(addr)
+    
+    def plant_command(self, row: int, col: int, plant_type: int,
+                      imitator_type: int = -1) -> Optional[Command]:
+        """Command planting at a position (None when not in a game)"""
+        board = self.reader.get_board()
+        if board == 0:
+            return None
+        return OP_PLANT, (board, row, col, plant_type, imitator_type)
+    
+    def shovel_command(self, row: int, col: int) -> Optional[Command]:
+        """Command removing the plant at a position (None if there is none)"""
+        plant_addr = self.find_plant(row, col)
+        if plant_addr is None:
+            return None
+        return OP_SHOVEL, (plant_addr,)
+    
+    def fire_cob_command(self, cob_index: int, target_x: float,
+                         target_y: float) -> Optional[Command]:
+        """Command firing the cob cannon at a plant index (None if it is gone)"""
+        board = self.reader.get_board()
+        if board == 0:
+            return None
+        
+        plant_array = self.reader.get_board_pointer(Offset.PLANT_ARRAY, board)
+        if plant_array == 0 or cob_index < 0:
+            return None
+        cob_addr = plant_array + cob_index * Offset.PLANT_SIZE
+        if self.reader.read_byte(cob_addr + Offset.P_DEAD):
+            return None
+        return OP_FIRE_COB, (cob_addr, int(target_x), int(target_y))
+    
+    def collect_command(self, item_addr: int) -> Command:
+        """Command collecting an item"""
+        return OP_COLLECT, (item_addr,)
+    
     # ========================================================================
     # High-Level Game Functions
     # ========================================================================
@@ -119,90 +378,45 @@ class AsmInjector:
         """
         Plant at a specific position
         
-        Calls the game's plant function at 0x0040D120 directly.
-        
-        Calling convention (from pvz_cpp_bot/dllmain.cpp):
-            push imitatorType  (-1 = not imitator)
-            push plantType
-            mov eax, row
-            push col
-            mov edi, pBoard
-            push edi
-            call 0x0040D120
+        Calls the game's plant function at 0x0040D120 directly
+        (see plant_code()).
         
         Args:
             row: Row to plant (0-5)
             col: Column to plant (0-8)
             plant_type: Plant type ID
             imitator_type: Type if using imitator (-1 if not)
-            
+        
         Returns:
             True if successful, False otherwise
         """
-        board = self.reader.get_board()
-        if board == 0:
-            return False
-        
-        shellcode = bytes([
-            # push imitator_type
-            0x68, *struct.pack('<i', imitator_type),
-            
-            # push plant_type
-            0x68, *struct.pack('<i', plant_type),
-            
-            # mov eax, row
-            0xB8, *struct.pack('<I', row),
-            
-            # push col
-            0x68, *struct.pack('<i', col),
-            
-            # mov edi, board
-            0xBF, *struct.pack('<I', board),
-            
-            # push edi (board)
-            0x57,
-            
-            # mov edx, FUNC_PLANT
-            0xBA, *struct.pack('<I', Offset.FUNC_PLANT),
-            
-            # call edx
-            0xFF, 0xD2,
-            
-            # ret
-            0xC3
-        ])
-        
-        return self.execute_shellcode(shellcode)
+        return self.run_command(self.plant_command(row, col, plant_type, imitator_type))
     
-    def shovel(self, row: int, col: int) -> bool:
+    def find_plant(self, row: int, col: int) -> Optional[int]:
         """
-        Remove/shovel a plant at a specific position
-        
-        First finds the plant at the position, then calls RemovePlant.
+        Address of the live plant at a position
         
         Args:
             row: Row of plant
             col: Column of plant
-            
+        
         Returns:
-            True if successful, False otherwise
+            Plant address, or None if there is none
         """
         board = self.reader.get_board()
         if board == 0:
-            return False
+            return None
         
-        # Find the plant at this position
-        plant_array = self.reader.read_int(board + Offset.PLANT_ARRAY)
+        plant_array = self.reader.get_board_pointer(Offset.PLANT_ARRAY, board)
         if plant_array == 0:
-            return False
-            
+            return None
+        
         plant_max = self.reader.read_int(board + Offset.PLANT_COUNT_MAX)
         # Validate plant_max is within reasonable bounds (cap at 200 for safety)
         if plant_max <= 0:
-            return False
+            return None
         plant_max = min(plant_max, 200)
         
-        plant_addr = None
         for i in range(plant_max):
             addr = plant_array + i * Offset.PLANT_SIZE
             if self.reader.read_byte(addr + Offset.P_DEAD):
@@ -210,28 +424,23 @@ class AsmInjector:
             p_row = self.reader.read_int(addr + Offset.P_ROW)
             p_col = self.reader.read_int(addr + Offset.P_COL)
             if p_row == row and p_col == col:
-                plant_addr = addr
-                break
+                return addr
+        return None
+    
+    def shovel(self, row: int, col: int) -> bool:
+        """
+        Remove/shovel a plant at a specific position
         
-        if plant_addr is None:
-            return False
+        First finds the plant at the position, then calls RemovePlant.
         
-        # Call RemovePlant
-        shellcode = bytes([
-            # push plant_addr
-            0x68, *struct.pack('<I', plant_addr),
-            
-            # mov edx, FUNC_REMOVE_PLANT
-            0xBA, *struct.pack('<I', Offset.FUNC_REMOVE_PLANT),
-            
-            # call edx
-            0xFF, 0xD2,
-            
-            # ret
-            0xC3
-        ])
+        Args:
+            row: Row of plant
+            col: Column of plant
         
-        return self.execute_shellcode(shellcode)
+        Returns:
+            True if successful, False otherwise
+        """
+        return self.run_command(self.shovel_command(row, col))
     
     def refresh_seed_cooldowns(self) -> bool:
         """
@@ -244,49 +453,29 @@ class AsmInjector:
         if board == 0:
             return False
         
-        seed_bank = self.reader.read_int(board + Offset.SEED_ARRAY)
+        seed_bank = self.reader.get_board_pointer(Offset.SEED_ARRAY, board)
         if seed_bank == 0:
             return False
         
-        shellcode = bytes([
-            # push seed_bank
-            0x68, *struct.pack('<I', seed_bank),
-            
-            # mov eax, FUNC_REFRESH_SEEDS
-            0xB8, *struct.pack('<I', Offset.FUNC_REFRESH_SEEDS),
-            
-            # call eax
-            0xFF, 0xD0,
-            
-            # ret
-            0xC3
-        ])
-        
-        return self.execute_shellcode(shellcode)
+        return self.execute_shellcode(refresh_seeds_code(seed_bank) + RET)
     
     def fire_cob(self, cob_index: int, target_x: float, target_y: float) -> bool:
         """
         Fire a cob cannon at a specific position
         
-        Note: Not yet implemented. The cob cannon firing requires more complex
-        shellcode that varies by game version. See AVZ cob_manager for reference.
-        
-        TODO: Implement proper cob firing shellcode based on AVZ cob_manager.cpp
+        Calls the game's cob fire function at 0x00466D50 on the cannon
+        (see fire_cob_code()). The cannon must be charged; the game
+        ignores the call otherwise.
         
         Args:
             cob_index: Index of the cob cannon plant
             target_x: Target x coordinate
             target_y: Target y coordinate
-            
+        
         Returns:
-            True if successful, False otherwise (currently always False)
+            True if successful, False otherwise
         """
-        # This is a placeholder - actual implementation requires:
-        # 1. Finding the cob cannon plant
-        # 2. Setting up mouse cursor position
-        # 3. Calling the game's cob fire function
-        # Reference: AVZ src/avz_cob_manager.cpp
-        return False
+        return self.run_command(self.fire_cob_command(cob_index, target_x, target_y))
     
     def collect_sun(self, item_addr: int) -> bool:
         """
@@ -297,16 +486,9 @@ class AsmInjector:
         
         Args:
             item_addr: Memory address of the item
-            
+        
         Returns:
             True if successful
         """
-        # Write directly to the collected flag
-        buf = ctypes.c_byte(1)
-        return self.kernel32.WriteProcessMemory(
-            self.process, 
-            item_addr + Offset.I_COLLECTED, 
-            ctypes.byref(buf), 
-            1, 
-            None
-        )
+        # Write directly to the collected flag (one write, cheaper than a command)
+        return self.backend.write(item_addr + Offset.I_COLLECTED, b'\x01')
@@ -5,8 +5,16 @@ Handles finding and attaching to the PVZ process
 
 import ctypes
 import ctypes.wintypes as wt
+import os
+import sys
 from typing import Optional
 
+from memory.backend import MemoryBackend, Kernel32Backend, ProcMemBackend
+
+
+# Executable names of the game, lower case
+PVZ_EXECUTABLES = ('plantsvszombies.exe', 'popcapgame1.exe')
+
 
 class ProcessAttacher:
     """Handles attaching to the PVZ process"""
@@ -19,7 +27,7 @@ class ProcessAttacher:
         self.user32 = ctypes.windll.user32
         self.process_handle: Optional[int] = None
         self.pid: Optional[int] = None
-        
+    
     def find_pvz_window(self) -> Optional[int]:
         """
         Find the PVZ game window
@@ -88,6 +96,73 @@ class ProcessAttacher:
         """Get the process handle"""
         return self.process_handle
     
+    def create_backend(self) -> MemoryBackend:
+        """Backend accessing the attached process"""
+        return Kernel32Backend(self.kernel32, self.process_handle)
+    
     def __del__(self):
         """Clean up on destruction"""
         self.detach()
+
+
+class WineProcessAttacher:
+    """Finds the PVZ process running under Wine on Linux"""
+    
+    def __init__(self):
+        self.kernel32 = None
+        self.process_handle: Optional[int] = None
+        self.pid: Optional[int] = None
+    
+    def find_pvz_pid(self) -> Optional[int]:
+        """
+        Find the game's Wine process by its executable name
+        
+        Returns:
+            Linux process ID or None if not found
+        """
+        for entry in os.listdir('/proc'):
+            if not entry.isdigit():
+                continue
+            try:
+                with open(f'/proc/{entry}/cmdline', 'rb') as f:
+                    program = f.read().split(b'\0', 1)[0].decode(errors='replace')
+            except OSError:
+                continue
+            name = program.replace('\\', '/').rsplit('/', 1)[-1].lower()
+            if name in PVZ_EXECUTABLES:
+                return int(entry)
+        return None
+    
+    def attach(self) -> bool:
+        """
+        Attach to the PVZ process
+        
+        Returns:
+            True if the process was found, False otherwise
+        """
+        self.pid = self.find_pvz_pid()
+        return self.pid is not None
+    
+    def detach(self):
+        """Detach from the process"""
+        self.pid = None
+    
+    def is_attached(self) -> bool:
+        """Check if attached to process"""
+        return self.pid is not None
+    
+    @property
+    def handle(self) -> Optional[int]:
+        """Processes have no handle here"""
+        return None
+    
+    def create_backend(self) -> MemoryBackend:
+        """Backend accessing the attached process"""
+        return ProcMemBackend(self.pid)
+
+
+def create_attacher():
+    """Process attacher for this platform"""
+    if sys.platform == 'win32':
+        return ProcessAttacher()
+    return WineProcessAttacher()
@@ -3,49 +3,80 @@ Memory Reader Module
 Handles reading values from PVZ process memory
 """
 
-import ctypes
+import struct
 from typing import Optional, List
 from data.offsets import Offset
+from memory.backend import MemoryBackend, Kernel32Backend
+
+
+_INT = struct.Struct('<i')
+_UINT = struct.Struct('<I')
+_FLOAT = struct.Struct('<f')
+_BYTE = struct.Struct('<b')
+_SHORT = struct.Struct('<h')
+_DOUBLE = struct.Struct('<d')
+
+
+# GAME_UI value while a board is being played
+GAME_UI_IN_GAME = 3
 
 
 class MemoryReader:
-    """Reads values from process memory"""
+    """
+    Reads values from process memory
     
-    def __init__(self, kernel32, process_handle: int):
+    After refresh() the PvzBase and Board pointers, the UI state and the
+    board's array base pointers are cached until the next refresh(), so a
+    state refresh walks the pointer chain once. The cache is dropped when
+    the board pointer changes or the game leaves the in-game UI. Without
+    refresh() every getter reads through, as before.
+    """
+    
+    def __init__(self, kernel32=None, process_handle: int = 0,
+                 backend: Optional[MemoryBackend] = None, cache_pointers: bool = True):
+        """
+        Initialize MemoryReader
+        
+        Args:
+            kernel32: kernel32 DLL handle (unused when backend is given)
+            process_handle: Handle of the PVZ process
+            backend: Byte source to read from (default: ReadProcessMemory
+                on process_handle)
+            cache_pointers: Let refresh() cache the pointer chain
+        """
         self.kernel32 = kernel32
         self.process = process_handle
-        
+        self.backend = backend or Kernel32Backend(kernel32, process_handle)
+        self.cache_pointers = cache_pointers
+        self.reads = 0  # Backend reads so far (instrumentation)
+        self.refresh_reads = 0  # Reads between the last two refresh() calls
+        self._refresh_start = 0
+        self.generation = 0  # Bumped whenever the pointer cache is dropped
+        self._refreshed = False
+        self._base = 0
+        self._board = 0
+        self._game_ui = 0
+        self._board_pointers = {}
+    
+    def _read(self, address: int, size: int) -> bytes:
+        self.reads += 1
+        return self.backend.read(address, size)
+    
     def read_int(self, address: int) -> int:
         """Read a 4-byte integer from memory"""
-        buf = ctypes.c_int()
-        self.kernel32.ReadProcessMemory(
-            self.process, address, ctypes.byref(buf), 4, None
-        )
-        return buf.value
+        return _INT.unpack(self._read(address, 4))[0]
     
     def read_uint(self, address: int) -> int:
         """Read a 4-byte unsigned integer from memory"""
-        buf = ctypes.c_uint()
-        self.kernel32.ReadProcessMemory(
-            self.process, address, ctypes.byref(buf), 4, None
-        )
-        return buf.value
+        return _UINT.unpack(self._read(address, 4))[0]
     
     def read_float(self, address: int) -> float:
         """Read a 4-byte float from memory"""
-        buf = ctypes.c_float()
-        self.kernel32.ReadProcessMemory(
-            self.process, address, ctypes.byref(buf), 4, None
-        )
-        return buf.value
+        return _FLOAT.unpack(self._read(address, 4))[0]
     
     def read_byte(self, address: int) -> int:
         """Read a single byte from memory"""
-        buf = ctypes.c_byte()
-        self.kernel32.ReadProcessMemory(
-            self.process, address, ctypes.byref(buf), 1, None
-        )
-        return buf.value
+        return _BYTE.unpack(self._read(address, 1))[0]
     
     def read_bool(self, address: int) -> bool:
         """Read a boolean (single byte) from memory"""
@@ -53,38 +84,65 @@ class MemoryReader:
     
     def read_bytes(self, address: int, size: int) -> bytes:
         """Read multiple bytes from memory"""
-        buf = (ctypes.c_byte * size)()
-        self.kernel32.ReadProcessMemory(
-            self.process, address, ctypes.byref(buf), size, None
-        )
-        return bytes(buf)
+        return self._read(address, size)
     
     def read_short(self, address: int) -> int:
         """Read a 2-byte short from memory"""
-        buf = ctypes.c_short()
-        self.kernel32.ReadProcessMemory(
-            self.process, address, ctypes.byref(buf), 2, None
-        )
-        return buf.value
+        return _SHORT.unpack(self._read(address, 2))[0]
     
     def read_double(self, address: int) -> float:
         """Read an 8-byte double from memory"""
-        buf = ctypes.c_double()
-        self.kernel32.ReadProcessMemory(
-            self.process, address, ctypes.byref(buf), 8, None
-        )
-        return buf.value
+        return _DOUBLE.unpack(self._read(address, 8))[0]
     
     # ========================================================================
     # PVZ Specific Reading Methods
     # ========================================================================
     
+    def refresh(self) -> bool:
+        """
+        Start a state refresh: re-check the pointer chain
+        
+        Reads PvzBase, then the Board pointer and UI state in one read. The
+        cached array pointers stay valid while PvzBase and Board are
+        unchanged and the game is in a board.
+        
+        Returns:
+            True if in game
+        """
+        self.refresh_reads = self.reads - self._refresh_start
+        self._refresh_start = self.reads
+        
+        base = self.read_int(Offset.BASE)
+        board = game_ui = 0
+        if base != 0:
+            block = self._read(base + Offset.MAIN_OBJECT, Offset.GAME_UI - Offset.MAIN_OBJECT + 4)
+            board = _INT.unpack_from(block, 0)[0]
+            game_ui = _INT.unpack_from(block, Offset.GAME_UI - Offset.MAIN_OBJECT)[0]
+        
+        if (base, board) != (self._base, self._board) or game_ui != GAME_UI_IN_GAME:
+            if self._board_pointers:
+                self.generation += 1
+            self._board_pointers = {}
+        self._base, self._board, self._game_ui = base, board, game_ui
+        self._refreshed = self.cache_pointers
+        return game_ui == GAME_UI_IN_GAME
+    
+    def invalidate(self) -> None:
+        """Drop the pointer cache; getters read through until refresh()"""
+        self._refreshed = False
+        self._board_pointers = {}
+        self.generation += 1
+    
     def get_pvz_base(self) -> int:
         """Get the PVZ base pointer"""
+        if self._refreshed:
+            return self._base
         return self.read_int(Offset.BASE)
     
     def get_board(self) -> int:
         """Get the Board/MainObject pointer"""
+        if self._refreshed:
+            return self._board
         base = self.get_pvz_base()
         if base == 0:
             return 0
@@ -92,6 +150,8 @@ class MemoryReader:
     
     def get_game_ui(self) -> int:
         """Get the current game UI state"""
+        if self._refreshed:
+            return self._game_ui
         base = self.get_pvz_base()
         if base == 0:
             return 0
@@ -99,7 +159,29 @@ class MemoryReader:
     
     def is_in_game(self) -> bool:
         """Check if player is currently in a game"""
-        return self.get_game_ui() == 3
+        return self.get_game_ui() == GAME_UI_IN_GAME
+    
+    def get_board_pointer(self, offset: int, board: int = 0) -> int:
+        """
+        Read a pointer field of the board (an array base)
+        
+        Cached between refreshes while in game: array bases are allocated
+        with the board and stay put until it is replaced.
+        
+        Args:
+            offset: Board offset of the pointer
+            board: Board pointer if the caller has it (saves its reads)
+        """
+        pointer = self._board_pointers.get(offset)
+        if pointer is not None:
+            return pointer
+        board = board or self.get_board()
+        if board == 0:
+            return 0
+        pointer = self.read_int(board + offset)
+        if self._refreshed and self._game_ui == GAME_UI_IN_GAME:
+            self._board_pointers[offset] = pointer
+        return pointer
     
     def get_sun(self) -> int:
         """Get current sun amount"""
@@ -138,10 +220,7 @@ class MemoryReader:
     
     def get_zombie_array(self) -> int:
         """Get zombie array base address"""
-        board = self.get_board()
-        if board == 0:
-            return 0
-        return self.read_int(board + Offset.ZOMBIE_ARRAY)
+        return self.get_board_pointer(Offset.ZOMBIE_ARRAY)
     
     def get_zombie_count_max(self) -> int:
         """Get maximum zombie count (array size)"""
@@ -152,10 +231,7 @@ class MemoryReader:
     
     def get_plant_array(self) -> int:
         """Get plant array base address"""
-        board = self.get_board()
-        if board == 0:
-            return 0
-        return self.read_int(board + Offset.PLANT_ARRAY)
+        return self.get_board_pointer(Offset.PLANT_ARRAY)
     
     def get_plant_count_max(self) -> int:
         """Get maximum plant count (array size)"""
@@ -166,17 +242,11 @@ class MemoryReader:
     
     def get_seed_array(self) -> int:
         """Get seed/card array base address"""
-        board = self.get_board()
-        if board == 0:
-            return 0
-        return self.read_int(board + Offset.SEED_ARRAY)
+        return self.get_board_pointer(Offset.SEED_ARRAY)
     
     def get_item_array(self) -> int:
         """Get item/collectible array base address"""
-        board = self.get_board()
-        if board == 0:
-            return 0
-        return self.read_int(board + Offset.ITEM_ARRAY)
+        return self.get_board_pointer(Offset.ITEM_ARRAY)
     
     def get_item_count_max(self) -> int:
         """Get maximum item count (array size)"""
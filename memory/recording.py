@@ -0,0 +1,303 @@
+"""
+Session Recording Module
+Records the memory reads of a game session to a log and replays them as a backend
+"""
+
+import bisect
+import mmap
+import struct
+import threading
+import time
+import zlib
+from typing import Callable, Dict, List, Tuple
+
+from memory.backend import MemoryBackend
+
+
+# Session log: header, then chunks of zlib-compressed polls. A chunk stands
+# alone (no state carries over from the previous one), so a log cut short
+# by a crash still replays up to its last whole chunk.
+_LOG_MAGIC = b'PVZREC1\0'
+_LOG_HEADER = struct.Struct('<8sI')  # magic, chunk size the log was written with
+_CHUNK = struct.Struct('<III')  # compressed size, raw size, polls
+_POLL = struct.Struct('<dqI')  # wall time, game clock, reads
+_READ = struct.Struct('<QIB')  # address, size, XORed with the previous read of the range
+
+DEFAULT_CHUNK_SIZE = 1 << 22  # Raw bytes per chunk; its first read of each range is stored whole
+
+
+def _xor(data: bytes, previous: bytes) -> bytes:
+    """Bytewise XOR of two equally long byte strings"""
+    value = int.from_bytes(data, 'little') ^ int.from_bytes(previous, 'little')
+    return value.to_bytes(len(data), 'little')
+
+
+# ============================================================================
+# Recording
+# ============================================================================
+
+class RecordingBackend(MemoryBackend):
+    """
+    Passes memory access through to another backend and logs every read
+    
+    Reads are grouped into polls, closed by mark_poll() with the game clock
+    and the wall time. Consecutive polls read the same ranges, which mostly
+    hold the same bytes, so a read of a range already read in the chunk is
+    stored XORed with the previous one: unchanged bytes become zeros that
+    compress to almost nothing.
+    
+    The log is locked, so a decision thread may read while a poller thread
+    reads and marks polls; its reads land in whichever poll is open.
+    
+    The log is written as a plain file: it is appended one compressed
+    chunk at a time, of a size only known once compressed, so a mapping
+    would have to be grown ahead of the data and cut back on close, and a
+    crash would leave the unwritten tail of the mapping in the log.
+    """
+    
+    def __init__(self, inner: MemoryBackend, path: str, chunk_size: int = DEFAULT_CHUNK_SIZE,
+                 clock: Callable[[], float] = time.time):
+        """
+        Start a session log
+        
+        Args:
+            inner: Backend of the game being recorded
+            path: Log file to create
+            chunk_size: Raw bytes collected before a chunk is compressed
+            clock: Wall time source
+        """
+        self.inner = inner
+        self.path = path
+        self.chunk_size = chunk_size
+        self.clock = clock
+        self.polls = 0
+        self.raw_bytes = 0  # Bytes read from the game
+        self.stored_bytes = 0  # Bytes written to the log
+        self._file = open(path, 'wb')
+        self._file.write(_LOG_HEADER.pack(_LOG_MAGIC, chunk_size))
+        self._chunk = bytearray()
+        self._chunk_polls = 0
+        self._reads = []  # Entries of the current poll
+        self._previous: Dict[Tuple[int, int], bytes] = {}
+        self._lock = threading.Lock()
+    
+    def read(self, address: int, size: int) -> bytes:
+        data = self.inner.read(address, size)
+        key = (address, size)
+        with self._lock:
+            previous = self._previous.get(key)
+            if previous is None:
+                self._reads.append(_READ.pack(address, size, 0) + data)
+            else:
+                self._reads.append(_READ.pack(address, size, 1) + _xor(data, previous))
+            self._previous[key] = data
+            self.raw_bytes += size
+        return data
+    
+    def write(self, address: int, data: bytes) -> bool:
+        return self.inner.write(address, data)
+    
+    def alloc(self, size: int) -> int:
+        return self.inner.alloc(size)
+    
+    def free(self, address: int) -> None:
+        self.inner.free(address)
+    
+    def run_thread(self, address: int, timeout: int = 1000) -> bool:
+        return self.inner.run_thread(address, timeout)
+    
+    def mark_poll(self, game_clock: int) -> None:
+        with self._lock:
+            self._chunk += _POLL.pack(self.clock(), game_clock, len(self._reads))
+            self._chunk += b''.join(self._reads)
+            self._reads = []
+            self._chunk_polls += 1
+            self.polls += 1
+            if len(self._chunk) >= self.chunk_size:
+                self._flush()
+    
+    def flush(self) -> None:
+        """Compress the polls collected so far into a chunk and write it"""
+        with self._lock:
+            self._flush()
+    
+    def _flush(self) -> None:
+        if not self._chunk_polls:
+            return
+        data = zlib.compress(bytes(self._chunk), 6)
+        self._file.write(_CHUNK.pack(len(data), len(self._chunk), self._chunk_polls))
+        self._file.write(data)
+        self._file.flush()
+        self.stored_bytes += _CHUNK.size + len(data)
+        self._chunk = bytearray()
+        self._chunk_polls = 0
+        self._previous = {}
+    
+    def close(self) -> None:
+        """Write the last chunk (reads after the last poll are dropped) and close"""
+        if self._file is not None:
+            self.flush()
+            self._file.close()
+            self._file = None
+        self.inner.close()
+
+
+# ============================================================================
+# Replay
+# ============================================================================
+
+class ReplayBackend(MemoryBackend):
+    """
+    Serves a recorded session's reads back, one poll at a time
+    
+    Each poll's reads are answered with the bytes recorded for that poll;
+    a range the poll did not read keeps its bytes from the last poll that
+    did, as long as the chunk before the poll's read it (ranges left
+    unread for a whole chunk are dropped: mostly arrays the game moved),
+    and a range never read reads as zeros. mark_poll() moves to the
+    next poll, waiting until its recorded time at the given speed. Writes
+    and code injection fail, as on a memory image.
+    """
+    
+    def __init__(self, path: str, speed: float = 1.0,
+                 clock: Callable[[], float] = time.monotonic,
+                 sleep: Callable[[float], None] = time.sleep):
+        """
+        Open a session log
+        
+        Args:
+            path: Log written by RecordingBackend
+            speed: Replay speed against the recording (2.0 twice as fast);
+                0 replays as fast as the polls are made
+            clock: Monotonic time source for pacing
+            sleep: Waits for pacing
+        """
+        self.speed = speed
+        self.clock = clock
+        self.sleep = sleep
+        with open(path, 'rb') as f:
+            self._file = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, _ = _LOG_HEADER.unpack_from(self._file, 0)
+        if magic != _LOG_MAGIC:
+            self._file.close()
+            raise ValueError(f"{path} is not a session log")
+        
+        # Index the chunks; a chunk cut short ends the log
+        self._chunks: List[Tuple[int, int, int]] = []  # data offset, size, polls
+        offset = _LOG_HEADER.size
+        while offset + _CHUNK.size <= len(self._file):
+            size, _, polls = _CHUNK.unpack_from(self._file, offset)
+            if offset + _CHUNK.size + size > len(self._file):
+                break
+            self._chunks.append((offset + _CHUNK.size, size, polls))
+            offset += _CHUNK.size + size
+        self.poll_count = sum(polls for _, _, polls in self._chunks)
+        
+        self.position = -1  # Index of the poll being served
+        self.game_clock = 0
+        self.wall_time = 0.0
+        self._memory: Dict[Tuple[int, int], bytes] = {}
+        self._ranges: List[Tuple[int, int]] = []  # Keys of _memory, sorted
+        self._longest = 0  # Longest range in _memory
+        self._chunk_ranges = None  # Ranges read by the current chunk
+        self._chunk = -1
+        self._polls = []  # Decoded polls of the current chunk
+        self._first_wall = None
+        self._start = clock()
+        self._advance()
+    
+    @property
+    def finished(self) -> bool:
+        return self.position >= self.poll_count
+    
+    def _decode_chunk(self, index: int) -> tuple:
+        """
+        Decode a chunk
+        
+        Returns:
+            ([(wall time, game clock, [(range, bytes)])] of its polls,
+             the ranges it reads)
+        """
+        offset, size, count = self._chunks[index]
+        raw = memoryview(zlib.decompress(self._file[offset:offset + size]))
+        previous = {}
+        polls = []
+        pos = 0
+        for _ in range(count):
+            wall, game_clock, reads = _POLL.unpack_from(raw, pos)
+            pos += _POLL.size
+            entries = []
+            for _ in range(reads):
+                address, length, xored = _READ.unpack_from(raw, pos)
+                pos += _READ.size
+                data = bytes(raw[pos:pos + length])
+                pos += length
+                key = (address, length)
+                if xored:
+                    data = _xor(data, previous[key])
+                previous[key] = data
+                entries.append((key, data))
+            polls.append((wall, game_clock, entries))
+        return polls, previous.keys()
+    
+    def _advance(self) -> None:
+        """Move to the next poll and take over its reads"""
+        self.position += 1
+        if self.finished:
+            return
+        if not self._polls:
+            self._chunk += 1
+            self._polls, ranges = self._decode_chunk(self._chunk)
+            self._polls.reverse()
+            if self._chunk_ranges is not None:
+                self._prune(self._chunk_ranges)
+            self._chunk_ranges = ranges
+        self.wall_time, self.game_clock, entries = self._polls.pop()
+        memory = self._memory
+        for key, data in entries:
+            if key not in memory:
+                bisect.insort(self._ranges, key)
+                self._longest = max(self._longest, key[1])
+            memory[key] = data
+        if self._first_wall is None:
+            self._first_wall = self.wall_time
+    
+    def _prune(self, ranges) -> None:
+        """Drop the ranges a chunk did not read"""
+        if len(ranges) < len(self._memory):
+            self._memory = {key: self._memory[key] for key in ranges}
+            self._ranges = sorted(self._memory)
+            self._longest = max(length for _, length in self._ranges)
+    
+    def read(self, address: int, size: int) -> bytes:
+        data = self._memory.get((address, size))
+        if data is not None:
+            return data
+        
+        # Not read this way when recording: look in a larger recorded read,
+        # among the ranges starting at most the longest one's length below
+        ranges = self._ranges
+        end = address + size
+        i = bisect.bisect_left(ranges, (address + 1,))
+        while i > 0:
+            i -= 1
+            start, length = ranges[i]
+            if start + self._longest < end:
+                break
+            if end <= start + length:
+                return self._memory[start, length][address - start:end - start]
+        return bytes(size)
+    
+    def mark_poll(self, game_clock: int) -> None:
+        self._advance()
+        if self.speed > 0 and not self.finished:
+            wait = ((self.wall_time - self._first_wall) / self.speed
+                    - (self.clock() - self._start))
+            if wait > 0:
+                self.sleep(wait)
+    
+    def close(self) -> None:
+        if self._file is not None:
+            self._polls, self._memory, self._ranges = [], {}, []
+            self._file.close()
+            self._file = None
@@ -3,52 +3,45 @@ Memory Writer Module
 Handles writing values to PVZ process memory
 """
 
-import ctypes
+import struct
 from typing import Optional
 
+from memory.backend import MemoryBackend, Kernel32Backend
+
 
 class MemoryWriter:
     """Writes values to process memory"""
     
-    def __init__(self, kernel32, process_handle: int):
+    def __init__(self, kernel32=None, process_handle: int = 0,
+                 backend: Optional[MemoryBackend] = None):
+        """
+        Initialize MemoryWriter
+        
+        Args:
+            kernel32: kernel32 DLL handle (unused when backend is given)
+            process_handle: Handle of the PVZ process
+            backend: Memory to write to (default: WriteProcessMemory on
+                process_handle)
+        """
         self.kernel32 = kernel32
         self.process = process_handle
+        self.backend = backend or Kernel32Backend(kernel32, process_handle)
     
     def write_int(self, address: int, value: int) -> bool:
         """Write a 4-byte integer to memory"""
-        buf = ctypes.c_int(value)
-        written = ctypes.c_size_t()
-        result = self.kernel32.WriteProcessMemory(
-            self.process, address, ctypes.byref(buf), 4, ctypes.byref(written)
-        )
-        return result != 0
+        return self.backend.write(address, struct.pack('<i', value))
     
     def write_uint(self, address: int, value: int) -> bool:
         """Write a 4-byte unsigned integer to memory"""
-        buf = ctypes.c_uint(value)
-        written = ctypes.c_size_t()
-        result = self.kernel32.WriteProcessMemory(
-            self.process, address, ctypes.byref(buf), 4, ctypes.byref(written)
-        )
-        return result != 0
+        return self.backend.write(address, struct.pack('<I', value))
     
     def write_float(self, address: int, value: float) -> bool:
         """Write a 4-byte float to memory"""
-        buf = ctypes.c_float(value)
-        written = ctypes.c_size_t()
-        result = self.kernel32.WriteProcessMemory(
-            self.process, address, ctypes.byref(buf), 4, ctypes.byref(written)
-        )
-        return result != 0
+        return self.backend.write(address, struct.pack('<f', value))
     
     def write_byte(self, address: int, value: int) -> bool:
         """Write a single byte to memory"""
-        buf = ctypes.c_byte(value)
-        written = ctypes.c_size_t()
-        result = self.kernel32.WriteProcessMemory(
-            self.process, address, ctypes.byref(buf), 1, ctypes.byref(written)
-        )
-        return result != 0
+        return self.backend.write(address, struct.pack('<b', value))
     
     def write_bool(self, address: int, value: bool) -> bool:
         """Write a boolean (single byte) to memory"""
@@ -56,26 +49,12 @@ class MemoryWriter:
     
     def write_bytes(self, address: int, data: bytes) -> bool:
         """Write multiple bytes to memory"""
-        written = ctypes.c_size_t()
-        result = self.kernel32.WriteProcessMemory(
-            self.process, address, data, len(data), ctypes.byref(written)
-        )
-        return result != 0
+        return self.backend.write(address, data)
     
     def write_short(self, address: int, value: int) -> bool:
         """Write a 2-byte short to memory"""
-        buf = ctypes.c_short(value)
-        written = ctypes.c_size_t()
-        result = self.kernel32.WriteProcessMemory(
-            self.process, address, ctypes.byref(buf), 2, ctypes.byref(written)
-        )
-        return result != 0
+        return self.backend.write(address, struct.pack('<h', value))
     
     def write_double(self, address: int, value: float) -> bool:
         """Write an 8-byte double to memory"""
-        buf = ctypes.c_double(value)
-        written = ctypes.c_size_t()
-        result = self.kernel32.WriteProcessMemory(
-            self.process, address, ctypes.byref(buf), 8, ctypes.byref(written)
-        )
-        return result != 0
+        return self.backend.write(address, struct.pack('<d', value))
@@ -79,6 +79,13 @@ from utils.damage import (
     get_garg_damage_reduction,
     calculate_garg_instant_damage,
     cobs_to_kill_garg,
+    # Lookup tables and batch (whole wave) evaluation
+    INSTANT_DAMAGE_TABLE,
+    ZOMBIE_TOTAL_HP_TABLE,
+    get_instant_damage_batch,
+    can_instant_kill_batch,
+    cobs_needed_to_kill_batch,
+    evaluate_cob_efficiency_batch,
 )
 
 # Status effect utilities
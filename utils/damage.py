@@ -7,6 +7,7 @@ Provides damage calculations for:
 - Kill requirements (damage needed to kill zombies)
 - DPS (damage per second) calculations
 - Damage efficiency evaluation
+- Lookup tables (weapon x zombie type) and batch evaluation of whole waves
 
 All damage values are in HP units.
 All time values are in centiseconds (cs) = 1/100 second.
@@ -17,7 +18,9 @@ Reference:
 """
 
 import math
-from typing import Optional, List, Tuple
+from typing import Optional, List, Sequence, Tuple
+
+import numpy as np
 
 from data.constants import (
     # Basic damage
@@ -98,6 +101,54 @@ def get_weapon_damage(weapon_type: str) -> int:
     return DAMAGE_VALUES.get(weapon_type, 20)
 
 
+# ============================================================================
+# Lookup Tables (indexed by weapon and zombie type)
+# ============================================================================
+
+# Zombie type columns; the last column stands for any type outside ZombieType
+_ZOMBIE_TYPES = max(ZombieType) + 1
+
+# Instant weapon rows, in INSTANT_DAMAGE order; the last row stands for any
+# other weapon (1800 damage, as get_instant_damage_to_zombie assumes)
+INSTANT_WEAPONS = tuple(INSTANT_DAMAGE)
+_WEAPON_ROWS = {weapon: row for row, weapon in enumerate(INSTANT_WEAPONS)}
+
+# Damage to Gargantuars where it is not half the weapon's damage
+_GARG_DAMAGE = {'doom': DOOM_DAMAGE_GARG}
+
+
+def _instant_damage(weapon_type: str, base_damage: int, zombie_type: int) -> int:
+    """Instant kill damage of a weapon to a zombie type (Gargantuars take half)"""
+    if is_gargantuar(zombie_type):
+        return _GARG_DAMAGE.get(weapon_type, base_damage // 2)  # 900 for normal instant kills
+    return base_damage
+
+
+INSTANT_DAMAGE_TABLE = np.array(
+    [[_instant_damage(weapon, INSTANT_DAMAGE[weapon], t) for t in range(_ZOMBIE_TYPES + 1)]
+     for weapon in INSTANT_WEAPONS]
+    + [[_instant_damage('', 1800, t) for t in range(_ZOMBIE_TYPES + 1)]], dtype=np.int64)
+ZOMBIE_TOTAL_HP_TABLE = np.array(
+    [get_zombie_total_hp(t) for t in range(_ZOMBIE_TYPES + 1)], dtype=np.int64)
+
+# The same tables as tuples for single lookups (cheaper than array indexing)
+_INSTANT_ROWS = {weapon: tuple(INSTANT_DAMAGE_TABLE[row].tolist())
+                 for weapon, row in _WEAPON_ROWS.items()}
+_OTHER_WEAPON_ROW = tuple(INSTANT_DAMAGE_TABLE[-1].tolist())
+_COB_ROW = _INSTANT_ROWS['cob']
+_TOTAL_HP = tuple(ZOMBIE_TOTAL_HP_TABLE.tolist())
+
+
+def _type_column(zombie_type: int) -> int:
+    """Table column of a zombie type"""
+    return zombie_type if 0 <= zombie_type < _ZOMBIE_TYPES else _ZOMBIE_TYPES
+
+
+def _total_hp(zombie_type: int) -> int:
+    """Full HP (body + accessory) of a zombie type, from the table"""
+    return _TOTAL_HP[_type_column(zombie_type)]
+
+
 def get_instant_damage_to_zombie(weapon_type: str, zombie_type: int) -> int:
     """
     Get instant kill damage to a specific zombie type
@@ -111,12 +162,8 @@ def get_instant_damage_to_zombie(weapon_type: str, zombie_type: int) -> int:
     Returns:
         Actual damage dealt
     """
-    base_damage = INSTANT_DAMAGE.get(weapon_type, 1800)
-    
-    if is_gargantuar(zombie_type):
-        return base_damage // 2  # 900 for normal instant kills
-    
-    return base_damage
+    damage = _INSTANT_ROWS.get(weapon_type, _OTHER_WEAPON_ROW)
+    return damage[zombie_type] if 0 <= zombie_type < _ZOMBIE_TYPES else damage[_ZOMBIE_TYPES]
 
 
 def calculate_cob_damage(zombie_type: int) -> int:
@@ -194,7 +241,7 @@ def get_damage_to_kill(zombie_type: int, current_hp: Optional[int] = None,
             total_hp += accessory_hp
         return total_hp
     
-    return get_zombie_total_hp(zombie_type)
+    return _total_hp(zombie_type)
 
 
 def cobs_needed_to_kill(zombie_type: int, current_hp: Optional[int] = None) -> int:
@@ -208,8 +255,8 @@ def cobs_needed_to_kill(zombie_type: int, current_hp: Optional[int] = None) -> i
     Returns:
         Number of cob hits needed
     """
-    hp = current_hp if current_hp is not None else get_zombie_total_hp(zombie_type)
-    damage_per_cob = calculate_cob_damage(zombie_type)
+    hp = current_hp if current_hp is not None else _total_hp(zombie_type)
+    damage_per_cob = _COB_ROW[_type_column(zombie_type)]
     
     if damage_per_cob <= 0:
         return 999
@@ -231,7 +278,7 @@ def can_instant_kill(weapon_type: str, zombie_type: int,
         True if weapon can kill the zombie
     """
     damage = get_instant_damage_to_zombie(weapon_type, zombie_type)
-    hp = current_hp if current_hp is not None else get_zombie_total_hp(zombie_type)
+    hp = current_hp if current_hp is not None else _total_hp(zombie_type)
     return damage >= hp
 
 
@@ -429,7 +476,7 @@ def evaluate_cob_efficiency(zombies_hit: List[Tuple[int, int]]) -> dict:
     kills = 0
     
     for hp, zombie_type in zombies_hit:
-        damage = calculate_cob_damage(zombie_type)
+        damage = _COB_ROW[_type_column(zombie_type)]
         total_damage += damage
         useful_damage += min(damage, hp)
         if damage >= hp:
@@ -458,7 +505,7 @@ def compare_weapon_efficiency(weapon1: str, weapon2: str,
     Returns:
         Dictionary with comparison results
     """
-    hp = get_zombie_total_hp(target_type)
+    hp = _total_hp(target_type)
     
     damage1 = get_instant_damage_to_zombie(weapon1, target_type) \
               if weapon1 in INSTANT_DAMAGE else get_weapon_damage(weapon1)
@@ -523,3 +570,96 @@ def cobs_to_kill_garg(is_giga: bool = False, current_hp: Optional[int] = None) -
     """
     zombie_type = ZombieType.GIGA_GARGANTUAR if is_giga else ZombieType.GARGANTUAR
     return cobs_needed_to_kill(zombie_type, current_hp)
+
+
+# ============================================================================
+# Batch Evaluation (whole waves, one call)
+# ============================================================================
+
+def _type_columns(zombie_types: Sequence[int]) -> np.ndarray:
+    """Table columns of an array of zombie types"""
+    types = np.asarray(zombie_types, dtype=np.int64)
+    return np.where((types >= 0) & (types < _ZOMBIE_TYPES), types, _ZOMBIE_TYPES)
+
+
+def _hp_array(zombie_types: np.ndarray, current_hps: Optional[Sequence[int]]) -> np.ndarray:
+    """Current HPs as an array (full HP of each type if None)"""
+    if current_hps is None:
+        return ZOMBIE_TOTAL_HP_TABLE[zombie_types]
+    return np.asarray(current_hps, dtype=np.int64)
+
+
+def get_instant_damage_batch(weapon_type: str, zombie_types: Sequence[int]) -> np.ndarray:
+    """
+    Instant kill damage to each of a list of zombies
+    
+    Args:
+        weapon_type: Type of instant weapon
+        zombie_types: Zombie type IDs
+        
+    Returns:
+        Damage dealt to each zombie (get_instant_damage_to_zombie of each)
+    """
+    row = _WEAPON_ROWS.get(weapon_type, len(INSTANT_WEAPONS))
+    return INSTANT_DAMAGE_TABLE[row, _type_columns(zombie_types)]
+
+
+def can_instant_kill_batch(weapon_type: str, zombie_types: Sequence[int],
+                           current_hps: Optional[Sequence[int]] = None) -> np.ndarray:
+    """
+    Check which of a list of zombies an instant kill weapon kills
+    
+    Args:
+        weapon_type: Type of instant weapon
+        zombie_types: Zombie type IDs
+        current_hps: Current HP of each zombie (if None, uses max HP)
+        
+    Returns:
+        Boolean array, True where the weapon kills the zombie
+    """
+    columns = _type_columns(zombie_types)
+    row = _WEAPON_ROWS.get(weapon_type, len(INSTANT_WEAPONS))
+    return INSTANT_DAMAGE_TABLE[row, columns] >= _hp_array(columns, current_hps)
+
+
+def cobs_needed_to_kill_batch(zombie_types: Sequence[int],
+                              current_hps: Optional[Sequence[int]] = None) -> np.ndarray:
+    """
+    Cob hits needed to kill each of a list of zombies
+    
+    Args:
+        zombie_types: Zombie type IDs
+        current_hps: Current HP of each zombie (if None, uses max HP)
+        
+    Returns:
+        Cob hits of each zombie (cobs_needed_to_kill of each)
+    """
+    columns = _type_columns(zombie_types)
+    damage = INSTANT_DAMAGE_TABLE[_WEAPON_ROWS['cob'], columns]
+    return -(-_hp_array(columns, current_hps) // damage)
+
+
+def evaluate_cob_efficiency_batch(zombie_types: Sequence[int],
+                                  current_hps: Sequence[int]) -> dict:
+    """
+    Evaluate a cob cannon hit on a whole group of zombies at once
+    
+    Args:
+        zombie_types: Type ID of each zombie hit
+        current_hps: HP of each zombie hit
+        
+    Returns:
+        The dictionary of evaluate_cob_efficiency for the same zombies
+    """
+    hps = np.asarray(current_hps, dtype=np.int64)
+    damage = get_instant_damage_batch('cob', zombie_types)
+    total_damage = int(damage.sum())
+    useful_damage = int(np.minimum(damage, hps).sum())
+    return {
+        'total_hp': int(hps.sum()),
+        'total_damage': total_damage,
+        'useful_damage': useful_damage,
+        'wasted_damage': total_damage - useful_damage,
+        'efficiency': useful_damage / total_damage if total_damage > 0 else 0.0,
+        'kills': int(np.count_nonzero(damage >= hps)),
+    }